@@ -0,0 +1,371 @@
+#include "benchmarks.h"
+
+
+/* private */
+
+#define benchmark_warmup 0.1
+#define benchmark_sample_time 0.01
+#define benchmark_samples 50
+#define benchmark_threshold 0.1
+
+double benchmarks_now_private(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+double benchmarks_time_private(
+	benchfunc callback, void *params, size_t iterations) {
+
+	double start = benchmarks_now_private();
+	callback(iterations, params);
+
+	return benchmarks_now_private() - start;
+}
+
+int benchmarks_compare_private(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Finds how many iterations make
+ * a sample last at least 'sample_time'.
+ */
+size_t benchmarks_calibrate_private(
+	benchfunc callback, void *params, double sample_time) {
+
+	double target = sample_time * 1e9;
+	size_t iterations = 1;
+
+	while (true) {
+		double elapsed = benchmarks_time_private(callback, params, iterations);
+		if (elapsed >= target) {
+			return iterations;
+		}
+
+		double factor = elapsed <= 0 ? 100 : (target / elapsed) * 1.2;
+		if (factor < 2) { factor = 2; }
+		if (factor > 100) { factor = 100; }
+
+		iterations = (size_t)(iterations * factor);
+	}
+}
+
+/*
+ * Prints quantity with a metric
+ * prefix (like 1.2M).
+ */
+void benchmarks_print_quantity_private(double value, const char *unit) {
+	static const char *prefixes[] = {"", "K", "M", "G", "T"};
+
+	size_t i = 0;
+	while (value >= 1000 && i < sizeof(prefixes) / sizeof(*prefixes) - 1) {
+		value /= 1000;
+		++i;
+	}
+
+	printf("%7.2f%s%s", value, prefixes[i], unit);
+}
+
+/*
+ * Prints duration in nanoseconds
+ * with the fitting unit.
+ */
+void benchmarks_print_duration_private(double value) {
+	if (value < 1e3) {
+		printf("%8.2fns", value);
+	} else if (value < 1e6) {
+		printf("%8.2fus", value / 1e3);
+	} else if (value < 1e9) {
+		printf("%8.2fms", value / 1e6);
+	} else {
+		printf("%8.2fs ", value / 1e9);
+	}
+}
+
+void benchmark_results_print_private(const benchmark_result *self) {
+	printf("%-32s median:", self->name);
+	benchmarks_print_duration_private(self->median);
+	printf("  p99:");
+	benchmarks_print_duration_private(self->p99);
+	printf("  stddev:");
+	benchmarks_print_duration_private(self->stddev);
+	printf("  ops/s:");
+	benchmarks_print_quantity_private(self->operations, "");
+
+	if (self->bytes > 0) {
+		printf("  bytes/s:");
+		benchmarks_print_quantity_private(self->bytes, "B");
+	}
+
+	printf("\n");
+}
+
+/*
+ * Gets the number named 'field' in a
+ * shallowly parsed json object.
+ */
+double benchmarks_field_private(const string_map *object, const char *field) {
+	string *value = string_maps_get(object, strings_encapsulate(field));
+
+	return value ? strtod(value->data, null) : NAN;
+}
+
+
+/* benchmarks */
+
+error benchmarks_init(benchmark *self, benchmark_option option) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	*self = (benchmark){.option=option};
+
+	if (self->option.warmup <= 0) {
+		self->option.warmup = benchmark_warmup;
+	}
+
+	if (self->option.sample_time <= 0) {
+		self->option.sample_time = benchmark_sample_time;
+	}
+
+	if (self->option.samples == 0) {
+		self->option.samples = benchmark_samples;
+	}
+
+	if (self->option.threshold <= 0) {
+		self->option.threshold = benchmark_threshold;
+	}
+
+	return vectors_init(
+		&self->results, sizeof(benchmark_result), vector_min, null);
+}
+
+error benchmarks_run(
+	benchmark *self,
+	const char *name,
+	benchfunc callback,
+	void *params,
+	size_t bytes) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("name", !name);
+		errors_abort("callback", !callback);
+	#endif
+
+	const char *filter = self->option.filter;
+	if (filter && !strstr(name, filter)) {
+		return ok;
+	}
+
+
+	/* warming up and calibrating */
+
+	size_t iterations = benchmarks_calibrate_private(
+		callback, params, self->option.sample_time);
+
+	double warmup = self->option.warmup * 1e9;
+	double warmed = 0;
+	while (warmed < warmup) {
+		warmed += benchmarks_time_private(callback, params, iterations);
+	}
+
+	iterations = benchmarks_calibrate_private(
+		callback, params, self->option.sample_time);
+
+
+	/* sampling */
+
+	size_t samples_size = self->option.samples;
+	double *samples = mems_alloc(null, sizeof(double) * samples_size);
+	if (!samples) {
+		return fail;
+	}
+
+	double sum = 0;
+	for (size_t i = 0; i < samples_size; i++) {
+		double elapsed = benchmarks_time_private(callback, params, iterations);
+		samples[i] = elapsed / iterations;
+		sum += samples[i];
+	}
+
+	qsort(samples, samples_size, sizeof(double), benchmarks_compare_private);
+
+
+	/* summarizing */
+
+	double mean = sum / samples_size;
+	double deviation = 0;
+	for (size_t i = 0; i < samples_size; i++) {
+		deviation += (samples[i] - mean) * (samples[i] - mean);
+	}
+
+	size_t middle = samples_size / 2;
+	double median = samples_size % 2 ?
+		samples[middle] :
+		(samples[middle - 1] + samples[middle]) / 2;
+
+	size_t p99_index = (size_t)ceil(samples_size * 0.99) - 1;
+
+	benchmark_result result = {
+		.name=name,
+		.iterations=iterations,
+		.samples=samples_size,
+		.median=median,
+		.p99=samples[p99_index],
+		.mean=mean,
+		.stddev=samples_size > 1 ? sqrt(deviation / (samples_size - 1)) : 0,
+		.operations=median > 0 ? 1e9 / median : 0,
+	};
+
+	result.bytes = result.operations * bytes;
+
+	mems_dealloc(null, samples, sizeof(double) * samples_size);
+
+	benchmark_results_print_private(&result);
+	return vectors_push(&self->results, &result, null);
+}
+
+error benchmarks_save(const benchmark *self, const char *path) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("path", !path);
+	#endif
+
+	file *output = fopen(path, "w");
+	if (!output) {
+		return benchmark_file_error;
+	}
+
+	fprintf(output, "{\n");
+	for (size_t i = 0; i < self->results.size; i++) {
+		const benchmark_result *result = &self->results.data[i];
+
+		fprintf(
+			output,
+			"\t\"%s\": {"
+			"\"iterations\": %zu, "
+			"\"samples\": %zu, "
+			"\"median\": %.3f, "
+			"\"p99\": %.3f, "
+			"\"mean\": %.3f, "
+			"\"stddev\": %.3f, "
+			"\"operations\": %.3f, "
+			"\"bytes\": %.3f}%s\n",
+			result->name,
+			result->iterations,
+			result->samples,
+			result->median,
+			result->p99,
+			result->mean,
+			result->stddev,
+			result->operations,
+			result->bytes,
+			i == self->results.size - 1 ? "" : ",");
+	}
+
+	fprintf(output, "}\n");
+
+	int close_status = fclose(output);
+	return close_status == 0 ? benchmark_successfull : benchmark_file_error;
+}
+
+error benchmarks_compare(
+	const benchmark *self, const char *path, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("path", !path);
+	#endif
+
+	error err = benchmark_successfull;
+
+	file *input = fopen(path, "r");
+	if (!input) {
+		return benchmark_file_error;
+	}
+
+	ebyte_vec content = files_read(input, mem);
+	fclose(input);
+
+	if (content.error != file_successfull) {
+		return benchmark_file_error;
+	}
+
+	string *text = (string *)&content.value;
+	text->data[text->size - 1] = '\0';
+	strings_trim(text);
+
+	estring_map baseline = jsons_unmake(text, mem);
+	if (baseline.error != json_successfull) {
+		err = benchmark_parse_error;
+		goto cleanup0;
+	}
+
+	printf("\ncomparing with '%s':\n", path);
+
+	size_t regressions = 0;
+	for (size_t i = 0; i < self->results.size; i++) {
+		const benchmark_result *result = &self->results.data[i];
+
+		string name = strings_encapsulate(result->name);
+		string *object = string_maps_get(&baseline.value, name);
+		if (!object) {
+			printf("%-32s (new)\n", result->name);
+			continue;
+		}
+
+		estring_map fields = jsons_unmake(object, mem);
+		if (fields.error != json_successfull) {
+			err = benchmark_parse_error;
+			goto cleanup1;
+		}
+
+		double previous = benchmarks_field_private(&fields.value, "median");
+		maps_free(&fields.value, (freefunc)strings_free, (freefunc)strings_free, mem);
+
+		if (isnan(previous) || previous <= 0) {
+			printf("%-32s (no median)\n", result->name);
+			continue;
+		}
+
+		double change = result->median / previous - 1;
+		bool is_regression = change > self->option.threshold;
+		regressions += is_regression;
+
+		printf(
+			"%s%-32s %+7.2f%%%s\n",
+			is_regression ? "\033[31m" : "",
+			result->name,
+			change * 100,
+			is_regression ? " (regression)\033[0m" : "");
+	}
+
+	if (regressions > 0) {
+		printf(colors_error("%zu regression(s) above %.0f%%."),
+			regressions,
+			self->option.threshold * 100);
+
+		err = benchmark_regression_error;
+	}
+
+	cleanup1:
+	maps_free(&baseline.value, (freefunc)strings_free, (freefunc)strings_free, mem);
+
+	cleanup0:
+	byte_vecs_free(&content.value, mem);
+	return err;
+}
+
+void benchmarks_free(benchmark *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	vectors_free(&self->results, null, null);
+}
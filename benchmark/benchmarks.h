@@ -0,0 +1,139 @@
+#ifndef cels_benchmarks_h
+#define cels_benchmarks_h
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#include "../source/errors.h"
+#include "../source/mems.h"
+#include "../source/vectors.h"
+#include "../source/strings.h"
+#include "../source/files.h"
+#include "../source/jsons.h"
+
+
+/*
+ * The module 'benchmarks' measures functions
+ * with a monotonic clock, after a warmup and
+ * with iterations calibrated per sample.
+ *
+ * Each benchmark reports median, p99, mean and
+ * stddev per operation, besides operations and
+ * bytes per second, and may be saved as json
+ * and compared against a saved baseline.
+ */
+
+
+/* benchmarks */
+
+/*
+ * Function being measured, it must do
+ * its operation 'iterations' times.
+ */
+typedef void (*benchfunc)(size_t iterations, void *params);
+
+typedef enum benchmark_error {
+	benchmark_successfull,
+	benchmark_file_error,
+	benchmark_parse_error,
+	benchmark_regression_error,
+} benchmark_error;
+
+typedef struct benchmark_option {
+	/* only benchmarks whose name contain it run, may be null */
+	const char *filter;
+	/* seconds spent warming up, 0 is 0.1s */
+	double warmup;
+	/* seconds each sample takes at least, 0 is 0.01s */
+	double sample_time;
+	/* ammount of samples, 0 is 50 */
+	size_t samples;
+	/* relative slowdown of median considered a regression, 0 is 0.1 */
+	double threshold;
+} benchmark_option;
+
+typedef struct benchmark_result {
+	const char *name;
+	size_t iterations;
+	size_t samples;
+	/* nanoseconds per operation */
+	double median;
+	double p99;
+	double mean;
+	double stddev;
+	/* per second */
+	double operations;
+	double bytes;
+} benchmark_result;
+
+typedef vectors(benchmark_result) benchmark_result_vec;
+
+typedef struct benchmark {
+	benchmark_option option;
+	benchmark_result_vec results;
+} benchmark;
+
+/*
+ * Keeps the compiler from optimizing
+ * 'value' (and what computes it) away.
+ */
+#define benchmarks_keep(value) __asm__ volatile("" : : "r,m"(value) : "memory")
+
+/*
+ * Initializes benchmark, zeroed fields
+ * in 'option' fallback to defaults.
+ *
+ * #to-review
+ */
+cels_warn_unused
+error benchmarks_init(benchmark *self, benchmark_option option);
+
+/*
+ * Measures 'callback' printing and storing
+ * its result, unless it is filtered out.
+ *
+ * 'bytes' is the ammount of bytes one
+ * operation processes, 0 if meaningless.
+ *
+ * #to-review
+ */
+error benchmarks_run(
+	benchmark *self,
+	const char *name,
+	benchfunc callback,
+	void *params,
+	size_t bytes);
+
+/*
+ * Saves results to 'path' as a json
+ * object keyed by benchmark name.
+ *
+ * #to-review
+ */
+cels_warn_unused
+error benchmarks_save(const benchmark *self, const char *path);
+
+/*
+ * Compares results with the ones saved
+ * in 'path', printing the change of
+ * each median.
+ *
+ * Returns benchmark_regression_error if
+ * any median got slower than threshold.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error benchmarks_compare(
+	const benchmark *self, const char *path, const allocator *mem);
+
+/*
+ * Frees benchmark.
+ *
+ * #to-review
+ */
+void benchmarks_free(benchmark *self);
+
+#endif
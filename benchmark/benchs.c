@@ -1,14 +1,91 @@
+/* https_tokenize_private is only declared in its source */
+#include "../source/https.c"
+
+#include "https-bench.c"
+#include "strings-bench.c"
+#include "vectors-bench.c"
 #include "nodes-bench.c"
+#include "jsons-bench.c"
+#include "csvs-bench.c"
+#include "templets-bench.c"
+#include "mems-bench.c"
+#include "benchmarks.c"
 
 #include "../source/nodes.c"
 #include "../source/utils.c"
 #include "../source/errors.c"
 #include "../source/mems.c"
+#include "../source/traces.c"
 #include "../source/vectors.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
+#include "../source/bytes.c"
+#include "../source/maths.c"
+#include "../source/files.c"
+#include "../source/jsons.c"
+#include "../source/csvs.c"
+#include "../source/templets.c"
+
+/*
+ * usage: benchs.o [--filter name] [--samples n] 
+ * [--json path] [--baseline path] [--threshold ratio]
+ */
+int main(int argc, char **argv) {
+	benchmark_option option = {0};
+	const char *json = null;
+	const char *baseline = null;
+
+	for (int i = 1; i < argc - 1; i += 2) {
+		if (strcmp(argv[i], "--filter") == 0) {
+			option.filter = argv[i + 1];
+		} else if (strcmp(argv[i], "--samples") == 0) {
+			option.samples = strtoul(argv[i + 1], null, 10);
+		} else if (strcmp(argv[i], "--json") == 0) {
+			json = argv[i + 1];
+		} else if (strcmp(argv[i], "--baseline") == 0) {
+			baseline = argv[i + 1];
+		} else if (strcmp(argv[i], "--threshold") == 0) {
+			option.threshold = strtod(argv[i + 1], null);
+		} else {
+			printf(colors_error("unknown option '%s'."), argv[i]);
+			return 1;
+		}
+	}
+
+	benchmark self = {0};
+	error init_error = benchmarks_init(&self, option);
+	if (init_error) {
+		return 1;
+	}
+
+	strings_bench(&self);
+	vectors_bench(&self);
+	nodes_bench(&self);
+	jsons_bench(&self);
+	csvs_bench(&self);
+	templets_bench(&self);
+	mems_bench(&self);
+	https_bench(&self);
+
+	error err = ok;
+	if (json) {
+		err = benchmarks_save(&self, json);
+		if (err) {
+			printf(colors_error("couldn't save results to '%s'."), json);
+		}
+	}
+
+	if (!err && baseline) {
+		allocator mem = arenas_init(4096);
+
+		err = benchmarks_compare(&self, baseline, &mem);
+		if (err == benchmark_file_error || err == benchmark_parse_error) {
+			printf(colors_error("couldn't read baseline '%s'."), baseline);
+		}
 
-int main() {
-	nodes_bench();
+		mems_free(&mem, null);
+	}
 
-	return 0;
+	benchmarks_free(&self);
+	return err != ok;
 }
@@ -0,0 +1,19 @@
+#!/usr/bin/bash
+
+# containers are generic through casts, so aliasing must be relaxed at -O2
+
+if [[ $1 = "" || $1 = "normal" ]]; then
+	echo compilando em modo normal
+	gcc -Wall -Wextra -Wpedantic -O2 -fno-strict-aliasing \
+		benchs.c -o benchs.o -lm -lssl -lcrypto -lpthread -Dcels_debug=false
+elif [[ $1 = "debug" ]]; then
+	echo compilando em modo debug
+	gcc -Wall -Wextra -Wpedantic -O2 -fno-strict-aliasing \
+		-g benchs.c -o benchs.o -lm -lssl -lcrypto -lpthread -Dcels_debug=true
+elif [[ $1 = "assembly" ]]; then
+	echo compilando em modo assembly
+	gcc -Wall -Wextra -Wpedantic -O2 -fno-strict-aliasing \
+		-S benchs.c -o benchs.s -Dcels_debug=false
+else
+	echo opção não encontrada
+fi
@@ -0,0 +1,60 @@
+#include "benchmarks.h"
+
+#include "../source/csvs.h"
+
+
+#define csvs_bench_rows 256
+
+void csvs_unmake_bench(size_t iterations, void *params) {
+	const string *text = params;
+	const string sep = strings_premake(",");
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(text->size * 4);
+
+		string_mat table = csvs_unmake(text, sep, &mem);
+		benchmarks_keep(table.size);
+
+		mems_free(&mem, null);
+	}
+}
+
+void csvs_next_bench(size_t iterations, void *params) {
+	const string *text = params;
+	const string sep = strings_premake(",");
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(1024);
+
+		string_view_vec columns = {0};
+		error init_error = vectors_init(
+			&columns, sizeof(string_view), vector_min, &mem);
+
+		string_view row = {0};
+		size_t rows = 0;
+		while (!init_error && !csvs_next(text, &columns, &row, sep, &mem)) {
+			rows++;
+		}
+
+		benchmarks_keep(rows);
+		mems_free(&mem, null);
+	}
+}
+
+void csvs_bench(benchmark *self) {
+	allocator mem = arenas_init(csvs_bench_rows * 64);
+
+	string text = strings_make("id,name,email,score\n", &mem);
+	for (size_t i = 0; i < csvs_bench_rows; i++) {
+		string row = strings_format(
+			"%zu,user-%zu,user-%zu@example.com,%zu\n", &mem, i, i, i, i * 7);
+
+		strings_push(&text, row, &mem);
+	}
+
+	size_t size = text.size - 1;
+	benchmarks_run(self, "csvs/unmake-256", csvs_unmake_bench, &text, size);
+	benchmarks_run(self, "csvs/next-256", csvs_next_bench, &text, size);
+
+	mems_free(&mem, null);
+}
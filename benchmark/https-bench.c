@@ -0,0 +1,76 @@
+#include "../source/https.h"
+
+#include "benchmarks.h"
+
+
+static const byte_vec https_bench_request = byte_vecs_premake(
+	"GET /users/21/posts?page=2 HTTP/1.1\r\n"
+	"Host: localhost:8080\r\n"
+	"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:120.0) Gecko/20100101\r\n"
+	"Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+	"Accept-Language: pt-BR,pt;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+	"Accept-Encoding: gzip, deflate, br\r\n"
+	"Connection: keep-alive\r\n"
+	"Cookie: session=0123456789abcdef; theme=dark\r\n"
+	"Cache-Control: max-age=0\r\n"
+	"\r\n");
+
+void https_tokenize_bench(size_t iterations, notused void *params) {
+	byte_vec request = https_bench_request;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		ebyte_map props = https_tokenize_private(&request, &mem);
+		benchmarks_keep(props.value.size);
+
+		mems_free(&mem, null);
+	}
+}
+
+/*
+ * Tokenizes as a connection does, 
+ * with an arena from the pool.
+ */
+void https_tokenize_pooled_bench(size_t iterations, notused void *params) {
+	byte_vec request = https_bench_request;
+
+	ring arenas = {0};
+	error arenas_error = rings_init(
+		&arenas, sizeof(allocator), https_arena_pool_size, null);
+
+	if (arenas_error) { return; }
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = https_arenas_acquire_private(&arenas);
+		arena_mark mark = arenas_mark(&mem);
+
+		ebyte_map props = https_tokenize_private(&request, &mem);
+		benchmarks_keep(props.value.size);
+
+		https_arenas_release_private(&arenas, &mem, mark);
+	}
+
+	allocator mem = {0};
+	while (!rings_try_pop(&arenas, &mem)) {
+		mems_free(&mem, null);
+	}
+
+	rings_free(&arenas, null);
+}
+
+void https_bench(benchmark *self) {
+	benchmarks_run(
+		self,
+		"https/tokenize",
+		https_tokenize_bench,
+		null,
+		https_bench_request.size - 1);
+
+	benchmarks_run(
+		self,
+		"https/tokenize-pooled",
+		https_tokenize_pooled_bench,
+		null,
+		https_bench_request.size - 1);
+}
@@ -0,0 +1,53 @@
+#include "benchmarks.h"
+
+#include "../source/jsons.h"
+
+
+static const string jsons_bench_text = strings_premake("{"
+	"\"id\":4096,"
+	"\"name\":\"angelus\","
+	"\"email\":\"angelus@example.com\","
+	"\"active\":true,"
+	"\"score\":98.25,"
+	"\"tags\":[\"c\",\"http\",\"templets\",\"jsons\"],"
+	"\"address\":{\"street\":\"rua das flores\",\"number\":21,\"city\":\"recife\"},"
+	"\"bio\":\"lorem ipsum dolor sit amet, consectetur adipiscing elit\""
+"}");
+
+void jsons_unmake_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		estring_map json = jsons_unmake(&jsons_bench_text, &mem);
+		benchmarks_keep(json.value.size);
+
+		mems_free(&mem, null);
+	}
+}
+
+void jsons_make_bench(size_t iterations, void *params) {
+	const string_map *json = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		estring text = jsons_make(json, &mem);
+		benchmarks_keep(text.value.data);
+
+		mems_free(&mem, null);
+	}
+}
+
+void jsons_bench(benchmark *self) {
+	allocator mem = arenas_init(4096);
+	size_t size = jsons_bench_text.size - 1;
+
+	benchmarks_run(self, "jsons/unmake", jsons_unmake_bench, null, size);
+
+	estring_map json = jsons_unmake(&jsons_bench_text, &mem);
+	if (json.error == json_successfull) {
+		benchmarks_run(self, "jsons/make", jsons_make_bench, &json.value, size);
+	}
+
+	mems_free(&mem, null);
+}
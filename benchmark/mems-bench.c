@@ -0,0 +1,257 @@
+#include <stdlib.h>
+
+#include "benchmarks.h"
+
+#include "../source/mems.h"
+
+
+#define mems_bench_size 1024
+#define mems_bench_block 64
+
+void mallocs_bench(size_t iterations, notused void *params) {
+	void *blocks[mems_bench_size] = {0};
+
+	for (size_t i = 0; i < iterations; i++) {
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			blocks[j] = mems_alloc(null, mems_bench_block);
+		}
+
+		benchmarks_keep(blocks[0]);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			mems_dealloc(null, blocks[j], mems_bench_block);
+		}
+	}
+}
+
+void trackers_bench(size_t iterations, notused void *params) {
+	void *blocks[mems_bench_size] = {0};
+
+	tracker track = {0};
+	allocator mem = trackers_init(&track, "bench", (tracker_option){0}, null);
+
+	for (size_t i = 0; i < iterations; i++) {
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			blocks[j] = mems_alloc(&mem, mems_bench_block);
+		}
+
+		benchmarks_keep(blocks[0]);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			mems_dealloc(&mem, blocks[j], mems_bench_block);
+		}
+	}
+
+	trackers_free(&track);
+}
+
+void tlsfs_bench(size_t iterations, notused void *params) {
+	void *blocks[mems_bench_size] = {0};
+	allocator mem = tlsfs_init(mems_bench_size * mems_bench_block * 2);
+
+	for (size_t i = 0; i < iterations; i++) {
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			blocks[j] = mems_alloc(&mem, mems_bench_block);
+		}
+
+		benchmarks_keep(blocks[0]);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			mems_dealloc(&mem, blocks[j], mems_bench_block);
+		}
+	}
+
+	mems_free(&mem, null);
+}
+
+/*
+ * Frees every other block while allocating 
+ * ones of varying sizes, like long and 
+ * short-lived objects mixed.
+ */
+void mems_mixed_bench_private(const allocator *mem) {
+	void *blocks[mems_bench_size] = {0};
+
+	for (size_t j = 0; j < mems_bench_size; j++) {
+		blocks[j] = mems_alloc(mem, mems_bench_block + (j & 7) * 24);
+
+		if (j & 1) {
+			mems_dealloc(mem, blocks[j - 1], mems_bench_block + ((j - 1) & 7) * 24);
+			blocks[j - 1] = null;
+		}
+	}
+
+	benchmarks_keep(blocks[1]);
+
+	for (size_t j = 1; j < mems_bench_size; j += 2) {
+		mems_dealloc(mem, blocks[j], mems_bench_block + (j & 7) * 24);
+	}
+}
+
+void mallocs_mixed_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		mems_mixed_bench_private(null);
+	}
+}
+
+void tlsfs_mixed_bench(size_t iterations, notused void *params) {
+	allocator mem = tlsfs_init(mems_bench_size * mems_bench_block * 2);
+
+	for (size_t i = 0; i < iterations; i++) {
+		mems_mixed_bench_private(&mem);
+	}
+
+	mems_free(&mem, null);
+}
+
+void arenas_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(mems_bench_size * mems_bench_block);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			void *block = mems_alloc(&mem, mems_bench_block);
+			benchmarks_keep(block);
+		}
+
+		mems_free(&mem, null);
+	}
+}
+
+void arenas_rewind_bench(size_t iterations, notused void *params) {
+	allocator mem = arenas_init(mems_bench_size * mems_bench_block);
+
+	for (size_t i = 0; i < iterations; i++) {
+		arena_mark mark = arenas_mark(&mem);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			void *block = mems_alloc(&mem, mems_bench_block);
+			benchmarks_keep(block);
+		}
+
+		arenas_rewind(&mem, mark, false);
+	}
+
+	mems_free(&mem, null);
+}
+
+void virtual_arenas_rewind_bench(size_t iterations, notused void *params) {
+	size_t capacity = mems_bench_size * mems_bench_block * 2;
+	allocator mem = virtual_arenas_init(capacity, (virtual_arena_option){0});
+
+	for (size_t i = 0; i < iterations; i++) {
+		arena_mark mark = arenas_mark(&mem);
+
+		for (size_t j = 0; j < mems_bench_size; j++) {
+			void *block = mems_alloc(&mem, mems_bench_block);
+			benchmarks_keep(block);
+		}
+
+		arenas_rewind(&mem, mark, false);
+	}
+
+	mems_free(&mem, null);
+}
+
+/*
+ * Grows a buffer by doubling up 
+ * to 'mems_bench_grow' bytes.
+ */
+#define mems_bench_grow (1024 * 1024)
+
+void mems_grow_bench_private(const allocator *mem) {
+	size_t size = mems_bench_block;
+	char *data = mems_alloc(mem, size);
+
+	while (size < mems_bench_grow) {
+		data = mems_realloc(mem, data, size, size * 2);
+		data[size] = 1;
+		size *= 2;
+	}
+
+	benchmarks_keep(data);
+}
+
+void arenas_grow_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(mems_bench_grow);
+		mems_grow_bench_private(&mem);
+		mems_free(&mem, null);
+	}
+}
+
+void virtual_arenas_grow_bench(size_t iterations, notused void *params) {
+	allocator mem = virtual_arenas_init(mems_bench_grow * 2, (virtual_arena_option){0});
+
+	for (size_t i = 0; i < iterations; i++) {
+		arena_mark mark = arenas_mark(&mem);
+		mems_grow_bench_private(&mem);
+		arenas_rewind(&mem, mark, false);
+	}
+
+	mems_free(&mem, null);
+}
+
+/*
+ * Kept apart so its alloca'd 
+ * buffer is released every call.
+ */
+void stack_arenas_bench_once(size_t amount) {
+	stack_arenas_scope(mem, mems_bench_block * 64);
+
+	for (size_t j = 0; j < amount; j++) {
+		void *block = mems_alloc(&mem, mems_bench_block);
+		benchmarks_keep(block);
+	}
+}
+
+void stack_arenas_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		stack_arenas_bench_once(32);
+	}
+}
+
+void stack_arenas_spill_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		stack_arenas_bench_once(mems_bench_size);
+	}
+}
+
+void mems_bench(benchmark *self) {
+	size_t bytes = mems_bench_size * mems_bench_block;
+
+	benchmarks_run(self, "mems/malloc-1024", mallocs_bench, null, bytes);
+	benchmarks_run(self, "mems/tracked-malloc-1024", trackers_bench, null, bytes);
+	benchmarks_run(self, "mems/tlsf-1024", tlsfs_bench, null, bytes);
+	benchmarks_run(self, "mems/malloc-mixed-1024", mallocs_mixed_bench, null, bytes);
+	benchmarks_run(self, "mems/tlsf-mixed-1024", tlsfs_mixed_bench, null, bytes);
+	benchmarks_run(self, "mems/arena-1024", arenas_bench, null, bytes);
+	benchmarks_run(self, "mems/arena-rewind-1024", arenas_rewind_bench, null, bytes);
+	benchmarks_run(
+		self, 
+		"mems/virtual-arena-rewind-1024", 
+		virtual_arenas_rewind_bench, 
+		null, 
+		bytes);
+
+	benchmarks_run(self, "mems/arena-grow-1m", arenas_grow_bench, null, mems_bench_grow);
+	benchmarks_run(
+		self, 
+		"mems/virtual-arena-grow-1m", 
+		virtual_arenas_grow_bench, 
+		null, 
+		mems_bench_grow);
+
+	benchmarks_run(
+		self,
+		"mems/stack-arena-32",
+		stack_arenas_bench,
+		null,
+		32 * mems_bench_block);
+
+	benchmarks_run(
+		self,
+		"mems/stack-arena-spill-1024",
+		stack_arenas_spill_bench,
+		null,
+		bytes);
+}
@@ -1,29 +1,327 @@
 #include <stddef.h>
-#include <time.h>
 #include <stdlib.h>
 
+#include "benchmarks.h"
+
 #include "../source/nodes.h"
-#include "../source/utils.h"
+#include "../source/strings.h"
+
+
+#define nodes_bench_size 1024
+
+sets(int_set, int)
+
+typedef struct size_munode size_munode;
+typedef munodes(size_munode, size_t) size_munode;
+typedef mutrees(size_munode) size_mutree;
+typedef mutree_iterators(size_munode) size_mutree_iterator;
+
+typedef struct size_mucell size_mucell;
+typedef mucells(size_mucell, size_t) size_mucell;
+typedef mutree_compacts(size_mucell) size_mutree_compact;
+typedef mutree_compact_iterators(size_mucell) size_mutree_compact_iterator;
+
+typedef struct nodes_bench_params {
+	string_map map;
+	string_vec keys;
+	bptree tree;
+	shard_map shards;
+	size_mutree mutree;
+	size_mutree_compact compact;
+	ring queue;
+	spsc_ring spsc_queue;
+} nodes_bench_params;
+
+int nodes_bench_order(const void *a, const void *b) {
+	size_t x = *(const size_t *)a;
+	size_t y = *(const size_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+void sets_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(nodes_bench_size * sizeof(int_set_node));
+
+		int_set ages = {0};
+		sets_init(ages);
+
+		for (size_t j = 0; j < nodes_bench_size; j++) {
+			int random = rand();
+			sets_push(&ages, &random, random, &mem);
+		}
 
-sets(int_set, int);
+		benchmarks_keep(ages.size);
+		mems_free(&mem, null);
+	}
+}
+
+void maps_push_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(nodes_bench_size * sizeof(string_map_node));
 
-clock_t sets_bench(size_t size) {
-	clock_t start = clock();
+		string_map map = {0};
+		maps_init(map);
 
-	int_set ages = {0};
-	sets_init(ages);
+		for (size_t j = 0; j < p->keys.size; j++) {
+			string *key = &p->keys.data[j];
+			string_map_pair pair = {.key=*key, .value=*key};
+			maps_push(&map, &pair, strings_hash(key), &mem);
+		}
 
-	for (size_t i = 0; i < size; i++) {
-		int random = rand();
-		sets_push(&ages, &random, random, null);
+		benchmarks_keep(map.size);
+		mems_free(&mem, null);
 	}
+}
 
-	sets_free(&ages, null, null);
-	clock_t end = clock();
+void maps_get_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
 
-	return end - start;
+	for (size_t i = 0; i < iterations; i++) {
+		string *key = &p->keys.data[i % p->keys.size];
+		string *value = string_maps_get(&p->map, *key);
+		benchmarks_keep(value);
+	}
 }
 
-void nodes_bench() {
-	utils_measure(sets_bench);
+void maps_churn_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		string *key = &p->keys.data[i % p->keys.size];
+		size_t hash = strings_hash(key);
+
+		maps_remove(&p->map, hash, null, null, null);
+
+		string_map_pair pair = {.key=*key, .value=*key};
+		error push_error = maps_push(&p->map, &pair, hash, null);
+		benchmarks_keep(push_error);
+	}
+}
+
+void bptrees_push_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(nodes_bench_size * 64);
+
+		bptree tree = bptrees_init(sizeof(size_t), sizeof(size_t), nodes_bench_order);
+		for (size_t j = 0; j < nodes_bench_size; j++) {
+			size_t random = rand();
+			error push_error = bptrees_push(&tree, &random, &j, &mem);
+			benchmarks_keep(push_error);
+		}
+
+		benchmarks_keep(tree.size);
+		mems_free(&mem, null);
+	}
+}
+
+void bptrees_get_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t key = (i * 7) % (nodes_bench_size * 2);
+		size_t *value = bptrees_get(&p->tree, &key);
+		benchmarks_keep(value);
+	}
+}
+
+void bptrees_range_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t low = (i * 7) % nodes_bench_size;
+		size_t high = low + 128;
+
+		bptree_iterator it = {0};
+		bptrees_range(&p->tree, &low, &high, &it);
+
+		while (bptrees_next(&p->tree, &it)) {
+			benchmarks_keep(it.value);
+		}
+	}
+}
+
+void shard_maps_get_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t value = 0;
+		bool is_found = shard_maps_get(&p->shards, (i * 7) % nodes_bench_size, &value);
+		benchmarks_keep(is_found + value);
+	}
+}
+
+void shard_maps_upsert_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t key = (i * 7) % nodes_bench_size;
+		error upsert_error = shard_maps_upsert(&p->shards, key, &i, null, null);
+		benchmarks_keep(upsert_error);
+	}
+}
+
+void mutrees_next_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t sum = 0;
+
+		size_mutree_iterator it = {0};
+		while (mutrees_next(&p->mutree, &it)) {
+			sum += it.data->data;
+		}
+
+		benchmarks_keep(sum);
+	}
+}
+
+void mutree_compacts_next_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t sum = 0;
+
+		size_mutree_compact_iterator it = {0};
+		while (mutree_compacts_next(&p->compact, &it)) {
+			sum += it.data->data;
+		}
+
+		benchmarks_keep(sum);
+	}
+}
+
+void mutree_compacts_next_breadth_wise_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t sum = 0;
+
+		size_mutree_compact_iterator it = {0};
+		while (mutree_compacts_next_breadth_wise(&p->compact, &it)) {
+			sum += it.data->data;
+		}
+
+		benchmarks_keep(sum);
+	}
+}
+
+void rings_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		size_t item = i;
+		error push_error = rings_try_push(&p->queue, &item);
+		error pop_error = rings_try_pop(&p->queue, &item);
+		benchmarks_keep(push_error + pop_error + item);
+	}
+}
+
+void spsc_rings_bench(size_t iterations, void *params) {
+	nodes_bench_params *p = params;
+
+	size_t items[16] = {0};
+	for (size_t i = 0; i < iterations; i++) {
+		size_t pushed = spsc_rings_push_batch(&p->spsc_queue, items, 16);
+		size_t popped = spsc_rings_pop_batch(&p->spsc_queue, items, 16);
+		benchmarks_keep(pushed + popped);
+	}
+}
+
+void nodes_bench(benchmark *self) {
+	allocator mem = arenas_init(nodes_bench_size * 64);
+
+	nodes_bench_params params = {0};
+	maps_init(params.map);
+
+	error init_error = vectors_init(
+		&params.keys, sizeof(string), nodes_bench_size, &mem);
+
+	if (init_error) {
+		goto cleanup0;
+	}
+
+	for (size_t i = 0; i < nodes_bench_size; i++) {
+		string key = strings_format("key-%zu", &mem, i);
+		vectors_push(&params.keys, &key, &mem);
+
+		string_map_pair pair = {.key=key, .value=key};
+		maps_push(&params.map, &pair, strings_hash(&key), &mem);
+	}
+
+	benchmarks_run(self, "sets/push-1024", sets_bench, null, 0);
+	benchmarks_run(self, "maps/push-1024", maps_push_bench, &params, 0);
+	benchmarks_run(self, "maps/get", maps_get_bench, &params, 0);
+	benchmarks_run(self, "maps/remove-and-push", maps_churn_bench, &params, 0);
+
+	params.tree = bptrees_init(sizeof(size_t), sizeof(size_t), nodes_bench_order);
+	for (size_t i = 0; i < nodes_bench_size; i++) {
+		size_t key = i * 2;
+		if (bptrees_push(&params.tree, &key, &i, &mem)) { goto cleanup0; }
+	}
+
+	benchmarks_run(self, "bptrees/push-1024", bptrees_push_bench, null, 0);
+	benchmarks_run(self, "bptrees/get", bptrees_get_bench, &params, 0);
+	benchmarks_run(self, "bptrees/range-64", bptrees_range_bench, &params, 0);
+
+	mutrees_init(params.mutree);
+	mutree_compacts_init(params.compact);
+
+	/* every node gets at most 4 children, in shuffled memory */
+	size_munode *tree_nodes = mems_alloc(&mem, nodes_bench_size * sizeof(size_munode));
+	if (!tree_nodes) { goto cleanup0; }
+
+	for (size_t i = 0; i < nodes_bench_size; i++) {
+		size_munode *node = &tree_nodes[(i * 389) % nodes_bench_size];
+		*node = (size_munode){.data=i};
+
+		if (i == 0) {
+			error push_error = mutrees_push(&params.mutree, null, node);
+			if (push_error) { goto cleanup0; }
+			continue;
+		}
+
+		size_munode *parent = &tree_nodes[(((i - 1) / 4) * 389) % nodes_bench_size];
+		error push_error = parent->down ? 
+			mutrees_push(&params.mutree, parent->down, node) :
+			mutrees_attach(&params.mutree, parent, node);
+
+		if (push_error) { goto cleanup0; }
+	}
+
+	if (mutrees_compact(&params.mutree, &params.compact, &mem)) { goto cleanup0; }
+
+	benchmarks_run(self, "mutrees/next-1024", mutrees_next_bench, &params, 0);
+	benchmarks_run(
+		self, "mutree-compacts/next-1024", mutree_compacts_next_bench, &params, 0);
+	benchmarks_run(
+		self, 
+		"mutree-compacts/next-breadth-wise-1024", 
+		mutree_compacts_next_breadth_wise_bench, 
+		&params, 
+		0);
+
+	if (shard_maps_init(&params.shards, sizeof(size_t), 0, null)) { goto cleanup0; }
+	for (size_t i = 0; i < nodes_bench_size; i++) {
+		if (shard_maps_insert(&params.shards, i, &i, null)) { goto cleanup1; }
+	}
+
+	benchmarks_run(self, "shard-maps/get", shard_maps_get_bench, &params, 0);
+	benchmarks_run(self, "shard-maps/upsert", shard_maps_upsert_bench, &params, 0);
+
+	if (rings_init(&params.queue, sizeof(size_t), 64, null)) { goto cleanup1; }
+	benchmarks_run(self, "rings/push-and-pop", rings_bench, &params, 0);
+	rings_free(&params.queue, null);
+
+	if (spsc_rings_init(&params.spsc_queue, sizeof(size_t), 64, null)) { goto cleanup1; }
+	benchmarks_run(self, "spsc-rings/push-and-pop-16", spsc_rings_bench, &params, 0);
+	spsc_rings_free(&params.spsc_queue, null);
+
+	cleanup1:
+	shard_maps_free(&params.shards, null);
+
+	cleanup0:
+	mems_free(&mem, null);
 }
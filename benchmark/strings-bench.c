@@ -0,0 +1,213 @@
+#include "benchmarks.h"
+
+#include "../source/strings.h"
+#include "../source/mems.h"
+
+
+static const string strings_bench_text = strings_premake(
+	"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+	"eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+	"ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+	"aliquip ex ea commodo consequat. Duis aute irure dolor in "
+	"reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla "
+	"pariatur. Excepteur sint occaecat cupidatat non proident, sunt in "
+	"culpa qui officia deserunt mollit anim id est laborum. Needle.");
+
+void strings_find_bench(size_t iterations, notused void *params) {
+	const string needle = strings_premake("needle");
+
+	for (size_t i = 0; i < iterations; i++) {
+		ssize_t position = strings_find(&strings_bench_text, needle, 0);
+		benchmarks_keep(position);
+	}
+}
+
+void strings_hash_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		size_t hash = strings_hash(&strings_bench_text);
+		benchmarks_keep(hash);
+	}
+}
+
+void strings_split_bench(size_t iterations, notused void *params) {
+	const string sep = strings_premake(" ");
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		string_vec words = strings_split(&strings_bench_text, sep, 0, &mem);
+		benchmarks_keep(words.size);
+
+		mems_free(&mem, null);
+	}
+}
+
+void strings_split_views_bench(size_t iterations, notused void *params) {
+	const string sep = strings_premake(" ");
+
+	for (size_t i = 0; i < iterations; i++) {
+		string_splitter splitter = string_splitters_init(
+			&strings_bench_text, sep, (string_split_option){.skip_empty=true});
+
+		string_view word = {0};
+		while (string_splitters_next(&splitter, &word)) {
+			benchmarks_keep(word.data);
+		}
+	}
+}
+
+void strings_replace_bench(size_t iterations, notused void *params) {
+	const string sub = strings_premake("dolor");
+	const string rep = strings_premake("pain");
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(1024);
+
+		string replaced = strings_replace(&strings_bench_text, sub, rep, 0, &mem);
+		benchmarks_keep(replaced.data);
+
+		mems_free(&mem, null);
+	}
+}
+
+static const string strings_bench_patterns[] = {
+	strings_premake("dolor"), 
+	strings_premake("ut"), 
+	strings_premake("in"), 
+	strings_premake("est"),
+};
+
+static const string strings_bench_replaces[] = {
+	strings_premake("pain"), 
+	strings_premake("UT"), 
+	strings_premake("IN"), 
+	strings_premake("EST"),
+};
+
+void strings_replace_passes_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		string replaced = strings_clone(&strings_bench_text, &mem);
+		for (size_t j = 0; j < 4; j++) {
+			replaced = strings_replace(
+				&replaced, 
+				strings_bench_patterns[j], 
+				strings_bench_replaces[j], 
+				0, 
+				&mem);
+		}
+
+		benchmarks_keep(replaced.data);
+		mems_free(&mem, null);
+	}
+}
+
+void strings_replace_matcher_bench(size_t iterations, void *params) {
+	const string_matcher *matcher = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		string_builder replaced = {0};
+		error replace_error = string_matchers_replace(
+			matcher, &strings_bench_text, &replaced, &mem);
+
+		benchmarks_keep(replace_error);
+		mems_free(&mem, null);
+	}
+}
+
+void strings_intern_bench(size_t iterations, void *params) {
+	string_intern *interns = params;
+	const string sep = strings_premake(" ");
+
+	for (size_t i = 0; i < iterations; i++) {
+		string_view word = {0};
+		while (!strings_next(&strings_bench_text, sep, &word)) {
+			string_id id = string_interns_push(interns, &word, null);
+			benchmarks_keep(id);
+		}
+	}
+}
+
+void strings_lower_bench(size_t iterations, notused void *params) {
+	char buffer[1024];
+	size_t size = maths_min(strings_bench_text.size - 1, sizeof(buffer));
+
+	for (size_t i = 0; i < iterations; i++) {
+		texts_lower_to(buffer, strings_bench_text.data, size);
+		benchmarks_keep(buffer[0]);
+	}
+}
+
+void strings_seems_bench(size_t iterations, void *params) {
+	const string *upper = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		bool seems = strings_seems(&strings_bench_text, upper);
+		benchmarks_keep(seems);
+	}
+}
+
+void strings_is_utf8_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		bool is_utf8 = texts_is_utf8(
+			strings_bench_text.data, strings_bench_text.size - 1);
+
+		benchmarks_keep(is_utf8);
+	}
+}
+
+void strings_bench(benchmark *self) {
+	size_t size = strings_bench_text.size - 1;
+
+	benchmarks_run(self, "strings/find", strings_find_bench, null, size);
+	benchmarks_run(self, "strings/hash", strings_hash_bench, null, size);
+	benchmarks_run(self, "strings/split", strings_split_bench, null, size);
+	benchmarks_run(self, "strings/split-views", strings_split_views_bench, null, size);
+	benchmarks_run(self, "strings/replace", strings_replace_bench, null, size);
+
+	string_matcher matcher = {0};
+	error init_error = string_matchers_init(
+		&matcher, strings_bench_patterns, strings_bench_replaces, 4, null);
+
+	if (!init_error) {
+		benchmarks_run(
+			self, "strings/replace-4-passes", strings_replace_passes_bench, null, size);
+		benchmarks_run(
+			self, "strings/replace-4-matcher", strings_replace_matcher_bench, &matcher, size);
+
+		string_matchers_free(&matcher, null);
+	}
+
+	string_intern interns = {0};
+	init_error = string_interns_init(&interns, (string_intern_option){0}, null);
+	if (!init_error) {
+		benchmarks_run(self, "strings/intern", strings_intern_bench, &interns, size);
+		string_interns_free(&interns, null);
+	}
+
+	string upper = strings_clone(&strings_bench_text, null);
+	if (!upper.data) { return; }
+	strings_upper(&upper);
+
+	static const char *lower_names[] = 
+		{"strings/lower-scalar", "strings/lower-sse2", "strings/lower-avx2"};
+	static const char *seems_names[] = 
+		{"strings/seems-scalar", "strings/seems-sse2", "strings/seems-avx2"};
+	static const char *utf8_names[] = 
+		{"strings/is-utf8-scalar", "strings/is-utf8-sse2", "strings/is-utf8-avx2"};
+
+	text_level best = texts_level();
+	for (text_level level = text_scalar_level; level <= best; level++) {
+		texts_use(level);
+
+		benchmarks_run(self, lower_names[level], strings_lower_bench, null, size);
+		benchmarks_run(self, seems_names[level], strings_seems_bench, &upper, size);
+		benchmarks_run(self, utf8_names[level], strings_is_utf8_bench, null, size);
+	}
+
+	texts_use(best);
+	strings_free(&upper, null);
+}
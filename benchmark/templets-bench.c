@@ -0,0 +1,72 @@
+#include "benchmarks.h"
+
+#include "../source/templets.h"
+
+
+static const string templets_bench_text = strings_premake(
+	"<| define index |>\n"
+	"<html>\n"
+	"<body>\n"
+	"<h1><| title |></h1>\n"
+	"<| for item in items |>\n"
+		"<h2><| item.title |></h2>\n"
+		"<p><| item.body |></p>\n"
+	"<| end |>"
+	"</body>\n"
+	"</html>");
+
+static const string templets_bench_option = strings_premake("{"
+	"\"title\":\"benchmark\","
+	"\"items\":["
+		"{\"title\":\"first\",\"body\":\"lorem ipsum\"},"
+		"{\"title\":\"second\",\"body\":\"dolor sit\"},"
+		"{\"title\":\"third\",\"body\":\"amet consectetur\"},"
+		"{\"title\":\"fourth\",\"body\":\"adipiscing elit\"}"
+	"]"
+"}");
+
+void templets_parse_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		templet_map templets = {0};
+		maps_init(templets);
+
+		error parse_error = templets_parse(&templets, &templets_bench_text, &mem);
+		benchmarks_keep(parse_error);
+
+		mems_free(&mem, null);
+	}
+}
+
+void templets_unmake_bench(size_t iterations, void *params) {
+	templet_map *templets = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(4096);
+
+		estring document = templets_unmake_with(
+			templets, "index", &templets_bench_option, &mem);
+
+		benchmarks_keep(document.value.data);
+		mems_free(&mem, null);
+	}
+}
+
+void templets_bench(benchmark *self) {
+	allocator mem = arenas_init(4096);
+	size_t size = templets_bench_text.size - 1;
+
+	templet_map templets = {0};
+	maps_init(templets);
+
+	benchmarks_run(self, "templets/parse", templets_parse_bench, null, size);
+
+	error parse_error = templets_parse(&templets, &templets_bench_text, &mem);
+	if (parse_error == templet_successfull) {
+		benchmarks_run(
+			self, "templets/unmake", templets_unmake_bench, &templets, 0);
+	}
+
+	mems_free(&mem, null);
+}
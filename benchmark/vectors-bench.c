@@ -0,0 +1,145 @@
+#include "benchmarks.h"
+
+#include "../source/vectors.h"
+#include "../source/mems.h"
+
+
+#define vectors_bench_size 1024
+
+typedef vectors(int) vectors_bench_vec;
+
+bool vectors_bench_compare(void *a, void *b) {
+	return *(int *)a > *(int *)b;
+}
+
+bool vectors_bench_equals(void *a, void *b) {
+	return *(int *)a == *(int *)b;
+}
+
+void vectors_push_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(vectors_bench_size * sizeof(int) * 2);
+
+		vectors_bench_vec numbers = {0};
+		error init_error = vectors_init(
+			&numbers, sizeof(int), vector_min, &mem);
+
+		for (int j = 0; !init_error && j < vectors_bench_size; j++) {
+			vectors_push(&numbers, &j, &mem);
+		}
+
+		benchmarks_keep(numbers.data);
+		mems_free(&mem, null);
+	}
+}
+
+void vectors_extend_bench(size_t iterations, void *params) {
+	vectors_bench_vec *source = params;
+
+	for (size_t i = 0; i < iterations; i++) {
+		allocator mem = arenas_init(vectors_bench_size * sizeof(int) * 2);
+
+		vectors_bench_vec numbers = {0};
+		error init_error = vectors_init(
+			&numbers, sizeof(int), vector_min, &mem);
+
+		for (size_t j = 0; !init_error && j < vectors_bench_size; j += 64) {
+			vectors_extend(&numbers, source->data + j, 64, &mem);
+		}
+
+		benchmarks_keep(numbers.data);
+		mems_free(&mem, null);
+	}
+}
+
+void vectors_push_small_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		small_vectors(int, 8) numbers = {0};
+		small_vectors_init(numbers);
+
+		for (int j = 0; j < 5; j++) {
+			vectors_push(&numbers, &j, null);
+		}
+
+		benchmarks_keep(numbers.data[4]);
+		vectors_free(&numbers, null, null);
+	}
+}
+
+void vectors_push_heap_bench(size_t iterations, notused void *params) {
+	for (size_t i = 0; i < iterations; i++) {
+		vectors_bench_vec numbers = {0};
+		error init_error = vectors_init(&numbers, sizeof(int), 8, null);
+
+		for (int j = 0; !init_error && j < 5; j++) {
+			vectors_push(&numbers, &j, null);
+		}
+
+		benchmarks_keep(numbers.data[4]);
+		vectors_free(&numbers, null, null);
+	}
+}
+
+void vectors_find_bench(size_t iterations, void *params) {
+	vectors_bench_vec *numbers = params;
+	int last = numbers->data[numbers->size - 1];
+
+	for (size_t i = 0; i < iterations; i++) {
+		ssize_t position = vectors_find(
+			numbers, &last, vectors_bench_equals);
+
+		benchmarks_keep(position);
+	}
+}
+
+void vectors_sort_bench(size_t iterations, void *params) {
+	const vectors_bench_vec *source = params;
+	int numbers_data[vectors_bench_size] = {0};
+	int temp = 0;
+
+	vectors_bench_vec numbers = {
+		.size=source->size,
+		.capacity=vectors_bench_size,
+		.data=numbers_data,
+		.type_size=sizeof(int)};
+
+	for (size_t i = 0; i < iterations; i++) {
+		memcpy(numbers.data, source->data, source->size * sizeof(int));
+		vectors_sort(&numbers, &temp, vectors_bench_compare);
+		benchmarks_keep(numbers.data);
+	}
+}
+
+void vectors_bench(benchmark *self) {
+	allocator mem = arenas_init(vectors_bench_size * sizeof(int) * 2);
+
+	vectors_bench_vec numbers = {0};
+	error init_error = vectors_init(&numbers, sizeof(int), vector_min, &mem);
+	if (init_error) {
+		goto cleanup0;
+	}
+
+	srand(0);
+	for (int i = 0; i < vectors_bench_size; i++) {
+		int random = rand();
+		vectors_push(&numbers, &random, &mem);
+	}
+
+	size_t bytes = vectors_bench_size * sizeof(int);
+	benchmarks_run(self, "vectors/push-1024", vectors_push_bench, null, bytes);
+	benchmarks_run(self, "vectors/extend-1024", vectors_extend_bench, &numbers, bytes);
+	benchmarks_run(self, "vectors/find-1024", vectors_find_bench, &numbers, bytes);
+	benchmarks_run(self, "vectors/push-5-heap", vectors_push_heap_bench, null, 0);
+	benchmarks_run(self, "vectors/push-5-small", vectors_push_small_bench, null, 0);
+
+	numbers.size = 128;
+	benchmarks_run(
+		self,
+		"vectors/sort-128",
+		vectors_sort_bench,
+		&numbers,
+		128 * sizeof(int));
+
+	cleanup0:
+	mems_free(&mem, null);
+}
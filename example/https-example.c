@@ -9,16 +9,21 @@
 #include "../source/errors.c"
 #include "../source/vectors.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 #include "../source/bytes.c"
 #include "../source/utils.c"
 #include "../source/mems.c"
+#include "../source/traces.c"
 #include "../source/nodes.c"
 #include "../source/maths.c"
 
 static const byte_vec default_response = byte_vecs_premake("not_found :(");
 
 void handle_index(
-	notused byte_map *request, int response, notused void *params) {
+	notused byte_map *request, 
+	int response, 
+	notused void *params, 
+	notused const allocator *mem) {
 
 	byte_vec message = byte_vecs_premake("Hello World");
 	https_send(
@@ -28,7 +33,10 @@ void handle_index(
 }
 
 void handle_hello(
-	notused byte_map *request, int response, notused void *params) {
+	notused byte_map *request, 
+	int response, 
+	notused void *params, 
+	notused const allocator *mem) {
 
 	byte_vec message = byte_vecs_premake("Hello World2");
 	https_send(
@@ -38,43 +46,47 @@ void handle_hello(
 }
 
 void handle_wild(
-	notused byte_map *request, int response, notused void *params) {
-
-	const allocator mem = arenas_init(2048);
+	notused byte_map *request, 
+	int response, 
+	notused void *params, 
+	const allocator *mem) {
 
 	file *index_html = fopen(
 		"." file_sep "static" file_sep "index.html", "r");
 
 	if (!index_html) { 
 		printf(colors_error("handle_wild.index_html não abriu"));
-		goto cleanup0;
+		return;
 	}
 
-	ebyte_vec file_read = files_read(index_html, &mem);
+	ebyte_vec file_read = files_read(index_html, mem);
 	fclose(index_html);
 
 	if (file_read.error != ok) {
 		printf("error: %d", file_read.error);
 		https_send(response, https_default_head, default_response);
-		goto cleanup0;
+		return;
 	}
 
 	https_send(response, https_default_head, file_read.value);
-
-	cleanup0:
-	mems_free(&mem, null);
 }
 
 typedef struct wild2_param { byte_vec file; } wild2_param;
 void handle_wild2(
-	notused byte_map *request, int response, void *params) {
+	notused byte_map *request, 
+	int response, 
+	void *params, 
+	notused const allocator *mem) {
 
 	wild2_param *arg = params;
 	https_send(response, https_default_head, arg->file);
 }
 
 void handle_hallo(
-	byte_map *request, int response, notused void *params) {
+	byte_map *request, 
+	int response, 
+	notused void *params, 
+	notused const allocator *mem) {
 
 	size_t key_hash = strings_prehash("vars_country");
 	byte_vec *country = maps_get(request, key_hash);
@@ -87,7 +99,10 @@ void handle_hallo(
 }
 
 void handle_file(
-	byte_map *request, int response, notused void *params) {
+	byte_map *request, 
+	int response, 
+	notused void *params, 
+	notused const allocator *mem) {
 
 	size_t key_hash = strings_prehash("vars_file");
 	byte_vec *filename = maps_get(request, key_hash);
@@ -119,6 +134,16 @@ int main(void) {
 	vectors_init(&calls, sizeof(router), vector_min, &mem);
 
 
+	/* served from many threads, so it allocates from the heap, not the arena */
+	https_cache cache = {0};
+	https_cache_option cache_option = {.ttl=30};
+	error cache_error = https_caches_init(&cache, cache_option, null);
+
+	if (cache_error) {
+		printf("cache_error: %d\n", cache_error);
+		goto cleanup0;
+	}
+
 	wild2_param p = {file_read.value};
 	char hallo_path[] = "/api/country:[a-z]+/city:[a-z]+";
 	char file_path[] = "/static/file:[a-z]+\\.(txt|jpg)";
@@ -127,7 +152,7 @@ int main(void) {
 		{.location=s("/not_found"), .func=https_send_not_found},
 		{.location=s("/"), .func=handle_index},
 		{.location=s("/hello"), .func=handle_hello},
-		{.location=s("/wild"), .func=handle_wild},
+		{.location=s("/wild"), .func=handle_wild, .cache=&cache},
 		{.location=s("/wild2"), .func=handle_wild2, .param=&p},
 		{.location=s(hallo_path), .func=handle_hallo},
 		{.location=s(file_path), .func=handle_file},
@@ -137,12 +162,30 @@ int main(void) {
 		vectors_push(&calls, &routes[i], &mem);
 	}
 
+	https_static statics = {0};
+	https_static_option statics_option = {.max_age=3600};
+	error statics_error = https_statics_init(
+		&statics, "." file_sep "static", "/public", statics_option, null);
+
+	if (statics_error) {
+		printf("statics_error: %d\n", statics_error);
+		goto cleanup0;
+	}
+
+	router_vecs_push_static(&calls, &statics, &mem);
+
+	https_metrics metrics = {0};
+	router_vecs_push_metrics(&calls, "/metrics", &metrics, &mem);
+
 
 	http_error serve_error = https_serve(8080, &calls, &mem);
 	if (serve_error) {
 		printf("serve_error: %d\n", serve_error);
 	}
 
+	https_statics_free(&statics);
+	https_caches_free(&cache);
+
 
 	cleanup0:
 	mems_free(&mem, null);
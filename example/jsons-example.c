@@ -1,8 +1,10 @@
 #include "../source/utils.c"
 #include "../source/errors.c"
 #include "../source/mems.c"
+#include "../source/traces.c"
 #include "../source/vectors.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 #include "../source/nodes.c"
 #include "../source/files.c"
 
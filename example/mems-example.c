@@ -4,6 +4,7 @@
 #include "../source/vectors.c"
 #include "../source/strings.h"
 #include "../source/strings.c"
+#include "../source/texts.c"
 
 #include "../source/errors.c"
 #include "../source/utils.c"
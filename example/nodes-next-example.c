@@ -7,6 +7,7 @@
 #include "../source/vectors.c"
 #include "../source/nodes.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 
 int main(void) {
 	const allocator mem = arenas_init(1024);
@@ -1,5 +1,6 @@
 #include "../source/strings.h"
 #include "../source/strings.c"
+#include "../source/texts.c"
 
 #include "../source/vectors.c"
 #include "../source/errors.c"
@@ -8,10 +8,12 @@
 #include "../source/requests.c"
 #include "../source/tasks.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 #include "../source/vectors.c"
 #include "../source/nodes.c"
 #include "../source/errors.c"
 #include "../source/mems.c"
+#include "../source/traces.c"
 #include "../source/maths.c"
 
 #include <time.h>
@@ -2,9 +2,11 @@
 
 #include "../source/templets.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 #include "../source/vectors.c"
 #include "../source/nodes.c"
 #include "../source/mems.c"
+#include "../source/traces.c"
 #include "../source/errors.c"
 #include "../source/maths.c"
 #include "../source/files.c"
@@ -13,7 +13,7 @@ bool byte_vecs_check(const byte_vec *self) {
 			errors_return("self.data[-1] mismatch", has_mismatch);
 		}
 	#else
-		if (!vectors_check(self)) return true;
+		if (vectors_check((const vector *)self)) return true;
 		if (self->size > self->capacity) return true;
 
 		if (self->size > 0) {
@@ -48,19 +48,7 @@ bool byte_vecs_is_string(byte_vec *self) {
 		return false;
 	}
 
-	for (size_t i = 0; i < self->size - 1; i++) {
-		bool is_charset_valid = 
-			self->data[i] == 9 ||
-			self->data[i] == 10 ||
-			self->data[i] == 12 ||
-			(self->data[i] >= 32 && self->data[i] <= 126);
-		
-		if (!is_charset_valid) {
-			return false;
-		}
-	}
-
-	return true;
+	return texts_is_printable((const char *)self->data, self->size - 1);
 }
 
 ebyte_vec byte_vecs_receive(
@@ -76,6 +76,39 @@ error router_vecs_push_with(
 	return vectors_push(self, &route, mem);
 }
 
+error router_vecs_push_static(
+	router_vec *self, https_static *statics, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", vectors_check((const vector *)self));
+		errors_abort("statics", !statics);
+	#endif
+
+	router route = {
+		.location=statics->location, 
+		.func=https_send_static, 
+		.param=statics
+	};
+
+	return vectors_push(self, &route, mem);
+}
+
+error router_vecs_push_metrics(
+	router_vec *self, 
+	char *location, 
+	https_metrics *metrics, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", vectors_check((const vector *)self));
+		errors_abort("location", strs_check(location));
+		errors_abort("metrics", !metrics);
+	#endif
+
+	return router_vecs_push_with(
+		self, location, https_send_metrics, metrics, mem);
+}
+
 cels_warn_unused
 router_node *router_nodes_find_hash_private(router_node *self, size_t hash) {
 	/*#if cels_debug
@@ -137,19 +170,64 @@ void https_initialize_private(void) {
 	http_body_hash = strings_prehash("Body");
 }
 
+/*
+ * Checks if 'self' only has 
+ * printable characters.
+ */
+bool https_is_text_private(const string_view *self) {
+	if (self->size < 2) {
+		return false;
+	}
+
+	return texts_is_printable(self->data, self->size - 1);
+}
+
+/*
+ * Copies 'view' into a null-terminated 
+ * byte_vec, data is null on failure.
+ */
+byte_vec https_copy_private(const string_view *view, const allocator *mem) {
+	byte_vec copy = {0};
+	error init_error = vectors_init(&copy, sizeof(byte), view->size, mem);
+	if (init_error) {
+		return (byte_vec){0};
+	}
+
+	memcpy(copy.data, view->data, view->size - 1);
+	copy.data[view->size - 1] = '\0';
+	copy.size = view->size;
+
+	return copy;
+}
+
 cels_warn_unused
-ebyte_map https_make_head_private(byte_vec *head, const allocator *mem) {
+ebyte_map https_make_head_private(const string_view *head, const allocator *mem) {
 	#if cels_debug
-		errors_abort("head", byte_vecs_check(head));
+		errors_abort("head", string_views_check(head));
 	#endif
 
 
 	/* creating head (method, location protocol) */
 
 	error err = ok;
-	byte_mat head_props = byte_vecs_split(head, token_sep, 0, mem);
 
-	if (head_props.size != http_header_size) {
+	string_view head_props[http_header_size] = {0};
+	size_t head_size = 0;
+
+	string_splitter tokens = string_splitters_init(
+		head, *(const string *)&token_sep, (string_split_option){.skip_empty=true});
+
+	string_view token = {0};
+	while (string_splitters_next(&tokens, &token)) {
+		if (head_size == http_header_size) {
+			++head_size;
+			break;
+		}
+
+		head_props[head_size++] = token;
+	}
+
+	if (head_size != http_header_size) {
 		err = http_head_size_error;
 		goto cleanup0;
 	}
@@ -158,8 +236,8 @@ ebyte_map https_make_head_private(byte_vec *head, const allocator *mem) {
 	/* check if head is correct */
 
 	bool is_method_valid = false;
-	if (byte_vecs_is_string(&head_props.data[0])) {
-		size_t m_hash = strings_hash((string *)&head_props.data[0]);
+	if (https_is_text_private(&head_props[0])) {
+		size_t m_hash = strings_hash(&head_props[0]);
 
 		for (size_t i = 0; i < http_method_hash_size; i++) {
 			if (http_method_hashs[i] == m_hash) {
@@ -176,8 +254,8 @@ ebyte_map https_make_head_private(byte_vec *head, const allocator *mem) {
 
 
 	bool is_location_valid = 
-		byte_vecs_is_string(&head_props.data[1]) && 
-		head_props.data[1].data[0] == '/';
+		https_is_text_private(&head_props[1]) && 
+		head_props[1].data[0] == '/';
 
 	if (!is_location_valid) {
 		err = http_location_invalid_error;
@@ -186,8 +264,8 @@ ebyte_map https_make_head_private(byte_vec *head, const allocator *mem) {
 
 
 	bool is_protocol_valid = false;
-	if (byte_vecs_is_string(&head_props.data[2])) {
-		size_t p_hash = strings_hash((string *)&head_props.data[2]);
+	if (https_is_text_private(&head_props[2])) {
+		size_t p_hash = strings_hash(&head_props[2]);
 
 		for (size_t i = 0; i < http_protocol_hash_size; i++) {
 			if (http_protocol_hashs[i] == p_hash) {
@@ -208,60 +286,29 @@ ebyte_map https_make_head_private(byte_vec *head, const allocator *mem) {
 	byte_map header = {0};
 	maps_init(header);
 
+	for (size_t i = 0; i < http_header_size; i++) {
+		byte_map_pair pair = {
+			.key=strings_clone(&http_headers[i], mem), 
+			.value=https_copy_private(&head_props[i], mem)};
 
-	byte_map_pair pair0 = {
-		.key=strings_make("Method", mem), 
-		.value=head_props.data[0]};
-
-	error push_error = maps_push(
-		&header, &pair0, http_header_hashs[0], mem);
-
-	if (push_error) {
-		strings_free(&pair0.key, mem);
-		goto cleanup1;
-	}
-
-
-	byte_map_pair pair1 = {
-		.key=strings_make("Location", mem), 
-		.value=head_props.data[1]};
-
-	push_error = maps_push(
-		&header, &pair1, http_header_hashs[1], mem);
-
-	if (push_error) {
-		strings_free(&pair1.key, mem);
-		goto cleanup1;
-	}
-
-
-	byte_map_pair pair2 = {
-		.key=strings_make("Protocol", mem), 
-		.value=head_props.data[2]};
-
-	push_error = maps_push(
-		&header, &pair2, http_header_hashs[2], mem);
+		error push_error = !pair.value.data || maps_push(
+			&header, &pair, http_header_hashs[i], mem);
 
-	if (push_error) {
-		strings_free(&pair2.key, mem);
-		goto cleanup1;
+		if (push_error) {
+			strings_free(&pair.key, mem);
+			if (pair.value.data) {
+				byte_vecs_free(&pair.value, mem);
+			}
+			goto cleanup1;
+		}
 	}
 
-
-	/* cleanup */
-
-	mems_dealloc(
-		mem, 
-		head_props.data, 
-		head_props.type_size * head_props.capacity);
-
 	return (ebyte_map) {.value=header};
 
 	cleanup1:
-	maps_free(&header, (freefunc)strings_free, null, mem);
+	maps_free(&header, (freefunc)strings_free, (freefunc)byte_vecs_free, mem);
 
 	cleanup0:
-	vectors_free(&head_props, (freefunc)byte_vecs_free, mem);
 	return (ebyte_map) {.error=err};
 }
 
@@ -271,8 +318,6 @@ ebyte_map https_tokenize_private(byte_vec *request, const allocator *mem) {
 		errors_abort("request", byte_vecs_check(request));
 	#endif
 
-	/* TODO: reduce copies */
-
 	error err = ok;
 
 	if (byte_vecs_check(request)) {
@@ -280,81 +325,106 @@ ebyte_map https_tokenize_private(byte_vec *request, const allocator *mem) {
 		goto cleanup0;
 	}
 
-	byte_mat sections = byte_vecs_split(request, section_sep, 1, mem);
-	byte_mat header_props = byte_vecs_split(&sections.data[0], line_sep, 0, mem);
-	ebyte_map request_props = https_make_head_private(&header_props.data[0], mem);
+
+	/* views into request, only what is kept is copied */
+
+	string_splitter sections = string_splitters_init(
+		(const string *)request, 
+		*(const string *)&section_sep, 
+		(string_split_option){.limit=1, .skip_empty=true});
+
+	string_view head = {0};
+	string_view body = {0};
+
+	if (!string_splitters_next(&sections, &head)) {
+		err = http_head_size_error;
+		goto cleanup0;
+	}
+
+	bool has_body = string_splitters_next(&sections, &body);
+
+	string_splitter lines = string_splitters_init(
+		&head, *(const string *)&line_sep, (string_split_option){.skip_empty=true});
+
+	string_view line = {0};
+	if (!string_splitters_next(&lines, &line)) {
+		err = http_head_size_error;
+		goto cleanup0;
+	}
+
+	ebyte_map request_props = https_make_head_private(&line, mem);
 	if (request_props.error != http_successfull) {
 		err = request_props.error;
-		goto cleanup1;
+		goto cleanup0;
 	}
 
-	for (size_t i = 1; i < header_props.size; i++) {
-		byte_mat terms = byte_vecs_split(
-			&header_props.data[i], prop_sep, 1, mem);
+	while (string_splitters_next(&lines, &line)) {
+		string_splitter terms = string_splitters_init(
+			&line, 
+			*(const string *)&prop_sep, 
+			(string_split_option){.limit=1, .skip_empty=true});
 
-		if (terms.size != 2) {
-			err = http_property_size_invalid_error;
+		string_view name = {0};
+		string_view value = {0};
 
-			vectors_free(&terms, (freefunc)byte_vecs_free, mem);
-			goto cleanup2;
+		bool has_terms = 
+			string_splitters_next(&terms, &name) && 
+			string_splitters_next(&terms, &value);
+
+		if (!has_terms) {
+			err = http_property_size_invalid_error;
+			goto cleanup1;
 		}
 
-		if (!byte_vecs_is_string(&terms.data[0])) {
+		if (!https_is_text_private(&name)) {
 			err = http_property_mal_formed_error;
-
-			vectors_free(&terms, (freefunc)byte_vecs_free, mem);
-			goto cleanup2;
+			goto cleanup1;
 		}
 
 		byte_map_pair pair = {
-			.key=*(string *)&terms.data[0], 
-			.value=terms.data[1]};
+			.key=string_views_to_string(&name, mem), 
+			.value=https_copy_private(&value, mem)};
 
-		bool push_error = maps_push(
+		error push_error = !pair.value.data || maps_push(
 			&request_props.value, &pair, strings_hash(&pair.key), mem);
 
 		if (push_error) {
 			err = http_property_mal_formed_error;
 
-			vectors_free(&terms, (freefunc)byte_vecs_free, mem);
-			goto cleanup2;
+			strings_free(&pair.key, mem);
+			if (pair.value.data) {
+				byte_vecs_free(&pair.value, mem);
+			}
+			goto cleanup1;
 		}
-
-		mems_dealloc(mem, terms.data, terms.capacity * terms.type_size);
 	}
 
-	if (sections.size == 2) {
+	if (has_body) {
 		byte_map_pair pair = {
 			.key=strings_make("Body", mem), 
-			.value=sections.data[1]};
+			.value=https_copy_private(&body, mem)};
 
-		bool push_error = maps_push(
+		error push_error = !pair.value.data || maps_push(
 			&request_props.value, &pair, http_body_hash, mem);
 
 		if (push_error) {
 			strings_free(&pair.key, mem);
-			goto cleanup2;
+			if (pair.value.data) {
+				byte_vecs_free(&pair.value, mem);
+			}
+			goto cleanup1;
 		}
 	}
 
-
-	byte_vecs_free(&sections.data[0], mem);
-	mems_dealloc(mem, sections.data, sections.capacity * sections.type_size);
-
-	vectors_free(&header_props, (freefunc)byte_vecs_free, mem);
 	return request_props;
 
-	cleanup2:
+	cleanup1:
 	maps_free(
-		&request_props, 
+		&request_props.value, 
 		(freefunc)strings_free, 
 		(freefunc)byte_vecs_free, 
 		mem);
 
-	cleanup1:
-	vectors_free(&sections, (freefunc)byte_vecs_free, mem);
-	vectors_free(&header_props, (freefunc)strings_free, mem);
-
 	cleanup0:
 	return (ebyte_map){.error=err};
 }
@@ -377,9 +447,23 @@ erouter_private https_find_route_private(
 	string *l = (string *)location_value;
 	string *rs = (string *)&route_sep;
 
-	string_vec routes = strings_split(l, *rs, 0, mem);
+	/* query doesn't take part in routing */
+	string path = *l;
+	char *query = strchr(l->data, '?');
+	if (query) {
+		path = strings_clone(l, mem);
+		path.size = query - l->data + 1;
+		path.data[path.size - 1] = '\0';
+	}
+
+	string_vec routes = strings_split(&path, *rs, 0, mem);
+	bool is_root = path.data[0] == '/' && path.size == 2;
+
+	if (query) {
+		strings_free(&path, mem);
+	}
 
-	if (location_value->data[0] == '/' && location_value->size == 2) {
+	if (is_root) {
 		vectors_free(&routes, (freefunc)strings_free, mem);
 
 		#if cels_debug
@@ -387,18 +471,29 @@ erouter_private https_find_route_private(
 
 			errors_abort(
 				"router.data[0]", 
-				strings_equals(loc, &strings_do("/")));
+				!strings_equals(loc, &strings_do("/")));
 		#endif
 
-		return (erouter_private){.value=router->data->data};
+		router_private root = router->data->data;
+		if (!root.func && root.is_prefix) {
+			root.func = root.prefix_func;
+			root.param = root.prefix_param;
+			root.metrics = root.prefix_metrics;
+		}
+
+		return (erouter_private){.value=root};
 	}
 
 	size_t i = 0;
 	router_node *route = router->data->down;
 	size_t route_hash = strings_hash(&routes.data[i]);
 
+	router_node *prefix = router->data->data.is_prefix ? router->data : null;
+
 	bool has_matched = false;
 	while (route) {
+		has_matched = false;
+
 		if (route->data.has_regex) {
 			int regex_status = regexec(
 				&route->data.regex,
@@ -432,6 +527,10 @@ erouter_private https_find_route_private(
 		}
 
 		if (has_matched) {
+			if (route->data.is_prefix) {
+				prefix = route;
+			}
+
 			if (i < routes.size - 1) {
 				++i;
 				route_hash = strings_hash(&routes.data[i]);
@@ -444,11 +543,28 @@ erouter_private https_find_route_private(
 		}
 
 		if (!route) { 
+			if (prefix) {
+				break;
+			}
+
 			err = http_not_found_error;
 			goto cleanup0; 
 		}
 	}
 
+	if ((!route || !route->data.func) && prefix) {
+		router_private match = prefix->data;
+		match.func = match.prefix_func;
+		match.param = match.prefix_param;
+		match.metrics = match.prefix_metrics;
+
+		vectors_free(&routes, (freefunc)strings_free, mem);
+		return (erouter_private){.value=match};
+	} else if (!route) {
+		err = http_not_found_error;
+		goto cleanup0; 
+	}
+
 	vectors_free(&routes, (freefunc)strings_free, mem);
 	return (erouter_private){.value=route->data};
 
@@ -458,177 +574,1063 @@ erouter_private https_find_route_private(
 	return (erouter_private){.error=err};
 }
 
-typedef struct client_param {
-	int client;
-	router_tree *routes;
-	const allocator *mem;
-} client_param;
+/* https_metrics */
 
-void *https_handle_client_private(void *args) {
-    client_param *arg = args;
-	int client_descriptor = arg->client;
-	router_tree *routes = arg->routes;
-	const allocator *mem = arg->mem;
+typedef struct https_exchange {
+	bool is_measuring;
+	int status;
+	/* nanoseconds spent sending */
+	size_t send_time;
+} https_exchange;
 
+/* what the handler of this thread sent, filled only when measuring */
+static __thread https_exchange https_exchanged = {0};
 
-	/* Receiving request */
-	
-	//ebyte_vec request = byte_vecs_receive(client_descriptor, MSG_WAITALL, 1024, mem);
-	byte_vec request = {0};
-	vectors_init(&request, sizeof(byte), string_small_size, mem);
-	long bytes = recv(
-		client_descriptor, 
-		request.data + request.size, 
-		string_small_size, 0);
+size_t https_now_private(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
 
-	if (bytes < 0) {
-		#if cels_debug
-			fprintf(
-				stderr, 
-				"recv-error: %s (%d), client_descriptor: %d\n", 
-				strerror(errno), 
-				errno, 
-				client_descriptor);
-		#endif
+	return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
 
-		goto cleanup0; 
-	} 
+/*
+ * Records the status of the first 
+ * response head sent by the handler.
+ */
+void https_exchanges_status_private(const char *head, size_t size) {
+	if (!https_exchanged.is_measuring || https_exchanged.status != 0) {
+		return;
+	}
 
-	request.size += bytes;
-	error push_error = vectors_push(&request, &(byte){'\0'}, mem);
-	if (push_error) { goto cleanup0; }
+	bool is_head = size >= 12 && strncmp(head, "HTTP/", 5) == 0;
+	if (!is_head) {
+		return;
+	}
 
-	#if cels_debug
-		printf("request:\n");
-		byte_vecs_print(&request);
-		printf("\n");
-	#endif
+	const char *code = memchr(head, ' ', size - 3);
+	if (!code) {
+		return;
+	}
 
+	int status = 0;
+	for (size_t i = 1; i < 4; i++) {
+		if (code[i] < '0' || code[i] > '9') {
+			return;
+		}
 
-	/* tokenizing */
+		status = status * 10 + (code[i] - '0');
+	}
 
-	ebyte_map request_props = https_tokenize_private(
-		&request, mem);
+	https_exchanged.status = status;
+}
 
-	if (request_props.error != http_successfull) { 
-		#if cels_debug
-			fprintf(
-				stderr, 
-				colors_error("client '%d' had error '%d'\n"), 
-				client_descriptor,
-				request_props.error);
-		#endif
+void https_exchanges_sent_private(size_t start) {
+	if (https_exchanged.is_measuring) {
+		https_exchanged.send_time += https_now_private() - start;
+	}
+}
 
-		goto cleanup1; 
-	} 
+void https_histograms_record_private(https_histogram *self, size_t time) {
+	#define https_histogram_shift 10
 
-	#if cels_debug
-		printf("request: \n");
-		maps_print(
-			&request_props.value, 
-			(printfunc)strings_print, 
-			(printfunc)byte_vecs_print);
-		printf("\n");
-	#endif
+	size_t bucket = 0;
+	if (time >> https_histogram_shift) {
+		size_t magnitude = https_histogram_shift;
+		while (time >> (magnitude + 1)) {
+			++magnitude;
+		}
 
+		size_t half = (time >> (magnitude - 1)) & 1;
+		bucket = 2 * (magnitude - https_histogram_shift) + half;
+	}
 
-	/* routing */
+	if (bucket >= https_histogram_buckets) {
+		bucket = https_histogram_buckets - 1;
+	}
 
-	erouter_private callback = https_find_route_private(
-		routes, &request_props.value, mem);
+	__atomic_fetch_add(&self->buckets[bucket], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&self->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&self->sum, time, __ATOMIC_RELAXED);
+}
 
-	if (callback.error != http_successfull) {
-		#if cels_debug
-			fprintf(
-				stderr, 
-				colors_error("'%d' had error '%d'\n"), 
-				client_descriptor,
-				callback.error);
-		#endif
+/*
+ * Gets upper bound of bucket in seconds.
+ */
+double https_histograms_bound_private(size_t bucket) {
+	size_t magnitude = https_histogram_shift + bucket / 2;
+	size_t bound = bucket % 2 ? 
+		(size_t)1 << (magnitude + 1) : 
+		(size_t)3 << (magnitude - 1);
+
+	#undef https_histogram_shift
+	return bound / 1e9;
+}
 
-		if (callback.error == http_not_found_error) {
-			if (routes->data && routes->data->down) {
-				callback.value = routes->data->down->data;
-			} else {
-				https_send_not_found(
-					null, client_descriptor, null);
+void https_route_metrics_record_private(
+	https_route_metrics *self, const size_t *phases, const bool *has_phases) {
 
-				goto cleanup2;
-			}
-		} else {
-			https_send_not_found(
-				null, client_descriptor, null);
+	__atomic_fetch_add(&self->requests, 1, __ATOMIC_RELAXED);
 
-			goto cleanup2;
-		}
-	} 
+	int status = https_exchanged.status;
+	size_t status_class = status >= 100 && status < 600 ? status / 100 : 0;
+	__atomic_fetch_add(&self->statuses[status_class], 1, __ATOMIC_RELAXED);
 
-	errors_abort("callback.func", !callback.value.func);
-	callback.value.func(
-		&request_props.value, 
-		client_descriptor, 
-		callback.value.param);
+	for (size_t i = 0; i < https_private_phase; i++) {
+		if (has_phases[i]) {
+			https_histograms_record_private(&self->phases[i], phases[i]);
+		}
+	}
+}
 
 
-	cleanup2:
-	maps_free(
-		&request_props.value, 
-		(freefunc)strings_free, 
-		(freefunc)byte_vecs_free, 
-		mem);
+/*
+ * Appends formatted text to 'text', 
+ * growing it as needed.
+ */
+error https_metrics_append_private(byte_vec *text, const char *form, ...) {
+	va_list args;
+	va_start(args, form);
 
-	cleanup1:
-	vectors_free(&request, null, mem);
+	error err = ok;
+	while (true) {
+		size_t left = text->capacity - text->size;
+
+		va_list copy;
+		va_copy(copy, args);
+		int written = vsnprintf(
+			(char *)text->data + text->size, left, form, copy);
+		va_end(copy);
+
+		if (written < 0) {
+			err = fail;
+			break;
+		} else if ((size_t)written < left) {
+			text->size += written;
+			break;
+		}
 
-	cleanup0:
-	printf("m\n");
-    close(client_descriptor);
+		size_t new_capacity = text->capacity << 1;
+		byte *new_data = mems_realloc(
+			null, text->data, text->capacity, new_capacity);
 
-    return null;
-}
+		if (!new_data) {
+			err = fail;
+			break;
+		}
 
-router_private https_find_root_private(router_vec *callbacks) {
-	#if cels_debug
-		errors_abort("callbacks", vectors_check((const vector *)callbacks));
-	#endif
+		text->data = new_data;
+		text->capacity = new_capacity;
+	}
 
-	for (size_t i = 0; i < callbacks->size; i++) {
-		string *l = &callbacks->data[i].location;
-		if (l->size == 2 && l->data[0] == '/') {
-			router r = callbacks->data[i];
+	va_end(args);
+	return err;
+}
 
-			return (router_private) {
-				.location=r.location,
-				.param=r.param,
-				.func=r.func
-			};
+/*
+ * Writes location escaped as 
+ * a prometheus' label value.
+ */
+void https_metrics_label_private(
+	const string *location, char *label, size_t capacity) {
+
+	size_t size = 0;
+	for (size_t i = 0; i + 1 < location->size && size + 3 < capacity; i++) {
+		char letter = location->data[i];
+		if (letter == '\\' || letter == '"') {
+			label[size++] = '\\';
+			label[size++] = letter;
+		} else if (letter == '\n') {
+			label[size++] = '\\';
+			label[size++] = 'n';
+		} else {
+			label[size++] = letter;
 		}
 	}
 
-	return (router_private) {0};
+	label[size] = '\0';
 }
 
-error https_insert_route_private(
-	router_tree router, 
-	router_node **route, 
-	const string node_name, 
-	const struct router callback,
-	bool is_last,
-	const allocator *mem) {
+/*
+ * Gets route of index 'i', the last 
+ * one being the unrouted requests.
+ */
+const https_route_metrics *https_metrics_route_private(
+	const https_metrics *self, size_t i) {
 
-	size_t hash = strings_hash(&node_name);
-	router_node *hash_route = router_nodes_find_hash_private(*route, hash);
+	return i < self->routes_size ? &self->routes[i] : &self->unrouted;
+}
 
-	if (hash_route) {
-		router_private *r = &hash_route->data;
-		if (!r->func && is_last) {
-			r->param = callback.param;
-			r->func = callback.func;
-		} else if (r->func && is_last) {
-			return http_route_collision_error;
-		}
+error https_metrics_make_private(const https_metrics *self, byte_vec *text) {
+	static const char *phase_names[] = {
+		[https_parse_phase] = "parse",
+		[https_handler_phase] = "handler",
+		[https_send_phase] = "send",
+	};
 
-		*route = hash_route;
+	#define load(value) __atomic_load_n(&(value), __ATOMIC_RELAXED)
+	#define append(...) \
+		if (https_metrics_append_private(text, __VA_ARGS__)) { return fail; }
+
+	append(
+		"# HELP https_connections_accepted_total Connections accepted.\n"
+		"# TYPE https_connections_accepted_total counter\n"
+		"https_connections_accepted_total %zu\n"
+		"# HELP https_connections_in_flight Connections being handled.\n"
+		"# TYPE https_connections_in_flight gauge\n"
+		"https_connections_in_flight %zu\n",
+		load(self->accepted),
+		load(self->in_flight));
+
+	char label[256];
+	size_t routes_size = self->routes_size + 1;
+
+	append(
+		"# HELP https_requests_total Requests handled by route.\n"
+		"# TYPE https_requests_total counter\n");
+
+	for (size_t i = 0; i < routes_size; i++) {
+		const https_route_metrics *route = https_metrics_route_private(self, i);
+		https_metrics_label_private(&route->location, label, sizeof(label));
+
+		append(
+			"https_requests_total{route=\"%s\"} %zu\n", 
+			label, 
+			load(route->requests));
+	}
+
+	append(
+		"# HELP https_responses_total Responses by route and status class.\n"
+		"# TYPE https_responses_total counter\n");
+
+	for (size_t i = 0; i < routes_size; i++) {
+		const https_route_metrics *route = https_metrics_route_private(self, i);
+		https_metrics_label_private(&route->location, label, sizeof(label));
+
+		for (size_t j = 0; j < 6; j++) {
+			size_t count = load(route->statuses[j]);
+			if (count == 0) { continue; }
+
+			if (j == 0) {
+				append(
+					"https_responses_total{route=\"%s\",status=\"unknown\"} %zu\n", 
+					label, 
+					count);
+			} else {
+				append(
+					"https_responses_total{route=\"%s\",status=\"%zuxx\"} %zu\n", 
+					label, 
+					j, 
+					count);
+			}
+		}
+	}
+
+	append(
+		"# HELP https_phase_duration_seconds "
+		"Time parsing, handling and sending requests.\n"
+		"# TYPE https_phase_duration_seconds histogram\n");
+
+	for (size_t i = 0; i < routes_size; i++) {
+		const https_route_metrics *route = https_metrics_route_private(self, i);
+		https_metrics_label_private(&route->location, label, sizeof(label));
+
+		for (size_t j = 0; j < https_private_phase; j++) {
+			const https_histogram *histogram = &route->phases[j];
+			if (load(histogram->count) == 0) { continue; }
+
+			size_t cumulative = 0;
+			for (size_t k = 0; k < https_histogram_buckets - 1; k++) {
+				cumulative += load(histogram->buckets[k]);
+
+				append(
+					"https_phase_duration_seconds_bucket"
+					"{route=\"%s\",phase=\"%s\",le=\"%g\"} %zu\n",
+					label,
+					phase_names[j],
+					https_histograms_bound_private(k),
+					cumulative);
+			}
+
+			cumulative += load(histogram->buckets[https_histogram_buckets - 1]);
+
+			append(
+				"https_phase_duration_seconds_bucket"
+				"{route=\"%s\",phase=\"%s\",le=\"+Inf\"} %zu\n"
+				"https_phase_duration_seconds_sum"
+				"{route=\"%s\",phase=\"%s\"} %.9f\n"
+				"https_phase_duration_seconds_count"
+				"{route=\"%s\",phase=\"%s\"} %zu\n",
+				label, phase_names[j], cumulative,
+				label, phase_names[j], load(histogram->sum) / 1e9,
+				label, phase_names[j], cumulative);
+		}
+	}
+
+	#undef append
+	#undef load
+
+	return ok;
+}
+
+void https_send_metrics(
+	notused byte_map *request, 
+	int client_connection, 
+	void *param, 
+	notused const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("param", !param);
+	#endif
+
+	static const byte_vec head = byte_vecs_premake(
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Type: text/plain; version=0.0.4\r\n"
+		"Cache-Control: no-store\r\n\r\n");
+
+	byte_vec text = {0};
+	error init_error = vectors_init(&text, sizeof(byte), 4096, null);
+	if (init_error) {
+		return;
+	}
+
+	error make_error = https_metrics_make_private(param, &text);
+	if (!make_error) {
+		/* vsnprintf leaves the '\0' https_send expects in size */
+		text.size++;
+		https_send(client_connection, head, text);
+	}
+
+	mems_dealloc(null, text.data, text.capacity);
+}
+
+/* https_caches */
+
+struct https_cache_entry {
+	size_t hash;
+	string key;
+	byte_vec response;
+	time_t expiration;
+	size_t users;
+	bool is_retired;
+	https_cache_entry *next;
+	https_cache_entry *newer;
+	https_cache_entry *older;
+};
+
+typedef struct https_capture {
+	byte_vec response;
+	const allocator *mem;
+	bool has_failed;
+} https_capture;
+
+#define https_cache_ttl 60
+#define https_cache_capacity (16 << 20)
+#define https_cache_buckets 256
+#define https_cache_key_size 2048
+
+/* set while a cacheable handler runs, so https_send copies its response */
+static __thread https_capture *https_captured = null;
+
+/*
+ * Hashes data case-sensitively 
+ * (unlike strings_hash).
+ */
+size_t https_hash_private(const char *data, size_t size) {
+	size_t hash = 14695981039346656037UL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (byte)data[i];
+		hash *= 1099511628211UL;
+	}
+
+	return hash;
+}
+
+/*
+ * Sends whole buffer, retrying 
+ * on partial sends.
+ */
+error https_send_all_private(
+	int client_connection, const char *data, size_t size, int flags) {
+
+	size_t start = https_exchanged.is_measuring ? https_now_private() : 0;
+	https_exchanges_status_private(data, size);
+
+	error err = ok;
+	while (size > 0) {
+		long bytes = send(client_connection, data, size, flags | MSG_NOSIGNAL);
+		if (bytes < 0 && errno == EINTR) {
+			continue;
+		} else if (bytes <= 0) {
+			err = fail;
+			break;
+		}
+
+		data += bytes;
+		size -= bytes;
+	}
+
+	https_exchanges_sent_private(start);
+	return err;
+}
+
+/*
+ * Writes cache key of request in 'key', 
+ * returning its size or 0 if request 
+ * can't be cached.
+ */
+size_t https_caches_key_private(
+	https_cache *self, byte_map *request, char *key, size_t key_capacity) {
+
+	byte_vec *method = maps_get(request, http_header_hashs[0]);
+	byte_vec *location = maps_get(request, http_header_hashs[1]);
+	if (!method || !location || strcmp((char *)method->data, "GET") != 0) {
+		return 0;
+	}
+
+	int key_size = snprintf(
+		key, key_capacity, "%s %s", method->data, location->data);
+
+	if (key_size < 0 || (size_t)key_size >= key_capacity) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < self->headers_size; i++) {
+		byte_vec *value = maps_get(request, self->headers[i]);
+
+		int written = snprintf(
+			key + key_size, 
+			key_capacity - key_size, 
+			"\n%s", 
+			value ? (char *)value->data : "");
+
+		if (written < 0 || (size_t)(key_size + written) >= key_capacity) {
+			return 0;
+		}
+
+		key_size += written;
+	}
+
+	return key_size;
+}
+
+void https_cache_entries_free_private(
+	https_cache_entry *self, const allocator *mem) {
+
+	strings_free(&self->key, mem);
+	mems_dealloc(mem, self->response.data, self->response.capacity);
+	mems_dealloc(mem, self, sizeof(https_cache_entry));
+}
+
+/*
+ * Removes entry from buckets and lru, 
+ * freeing it once no one sends it.
+ *
+ * Lock must be held.
+ */
+void https_caches_unlink_private(
+	https_cache *self, https_cache_entry *entry) {
+
+	https_cache_entry **link = 
+		&self->buckets[entry->hash & (self->buckets_size - 1)];
+
+	while (*link != entry) {
+		link = &(*link)->next;
+	}
+
+	*link = entry->next;
+
+	if (entry->newer) {
+		entry->newer->older = entry->older;
+	} else {
+		self->newest = entry->older;
+	}
+
+	if (entry->older) {
+		entry->older->newer = entry->newer;
+	} else {
+		self->oldest = entry->newer;
+	}
+
+	self->size -= entry->response.size + entry->key.size;
+
+	if (entry->users == 0) {
+		https_cache_entries_free_private(entry, self->mem);
+	} else {
+		entry->is_retired = true;
+	}
+}
+
+/*
+ * Gets fresh cached response, marking 
+ * it as most recently used.
+ *
+ * Returned entry must be released.
+ */
+https_cache_entry *https_caches_acquire_private(
+	https_cache *self, const char *key, size_t key_size, size_t hash) {
+
+	time_t now = time(null);
+	pthread_mutex_lock(&self->lock);
+
+	https_cache_entry *entry = 
+		self->buckets[hash & (self->buckets_size - 1)];
+
+	while (entry) {
+		bool is_equal = 
+			entry->hash == hash && 
+			entry->key.size - 1 == key_size && 
+			memcmp(entry->key.data, key, key_size) == 0;
+
+		if (is_equal) { 
+			break; 
+		}
+
+		entry = entry->next;
+	}
+
+	if (entry && entry->expiration <= now) {
+		https_caches_unlink_private(self, entry);
+		entry = null;
+	}
+
+	if (entry && entry != self->newest) {
+		entry->newer->older = entry->older;
+		if (entry->older) {
+			entry->older->newer = entry->newer;
+		} else {
+			self->oldest = entry->newer;
+		}
+
+		entry->older = self->newest;
+		entry->newer = null;
+		self->newest->newer = entry;
+		self->newest = entry;
+	}
+
+	if (entry) {
+		++entry->users;
+	}
+
+	pthread_mutex_unlock(&self->lock);
+	return entry;
+}
+
+void https_caches_release_private(
+	https_cache *self, https_cache_entry *entry) {
+
+	pthread_mutex_lock(&self->lock);
+
+	--entry->users;
+	if (entry->is_retired && entry->users == 0) {
+		https_cache_entries_free_private(entry, self->mem);
+	}
+
+	pthread_mutex_unlock(&self->lock);
+}
+
+/*
+ * Stores response as most recently used, 
+ * evicting least recently used ones 
+ * past capacity.
+ */
+void https_caches_store_private(
+	https_cache *self, 
+	const char *key, 
+	size_t key_size, 
+	size_t hash, 
+	const byte_vec *response) {
+
+	size_t entry_size = response->size + key_size + 1;
+	if (entry_size > self->capacity) {
+		return;
+	}
+
+	pthread_mutex_lock(&self->lock);
+
+	https_cache_entry *entry = mems_alloc(self->mem, sizeof(https_cache_entry));
+	if (!entry) {
+		goto cleanup0;
+	}
+
+	*entry = (https_cache_entry){
+		.hash=hash,
+		.key=strings_init(key_size + 1, self->mem),
+		.expiration=time(null) + self->ttl,
+	};
+
+	entry->response.data = mems_alloc(self->mem, response->size);
+	if (!entry->key.data || !entry->response.data) {
+		goto cleanup1;
+	}
+
+	memcpy(entry->key.data, key, key_size);
+	entry->key.data[key_size] = '\0';
+	entry->key.size = key_size + 1;
+
+	memcpy(entry->response.data, response->data, response->size);
+	entry->response.size = response->size;
+	entry->response.capacity = response->size;
+	entry->response.type_size = sizeof(byte);
+
+
+	/* replacing previous response */
+
+	https_cache_entry **bucket = &self->buckets[hash & (self->buckets_size - 1)];
+	for (https_cache_entry *other = *bucket; other; other = other->next) {
+		bool is_equal = 
+			other->hash == hash && 
+			strings_equals(&other->key, &entry->key);
+
+		if (is_equal) {
+			https_caches_unlink_private(self, other);
+			break;
+		}
+	}
+
+	while (self->oldest && self->size + entry_size > self->capacity) {
+		https_caches_unlink_private(self, self->oldest);
+	}
+
+	entry->next = *bucket;
+	*bucket = entry;
+
+	entry->older = self->newest;
+	if (self->newest) {
+		self->newest->newer = entry;
+	} else {
+		self->oldest = entry;
+	}
+
+	self->newest = entry;
+	self->size += entry_size;
+
+	pthread_mutex_unlock(&self->lock);
+	return;
+
+	cleanup1:
+	if (entry->key.data) {
+		strings_free(&entry->key, self->mem);
+	}
+
+	if (entry->response.data) {
+		mems_dealloc(self->mem, entry->response.data, response->size);
+	}
+
+	mems_dealloc(self->mem, entry, sizeof(https_cache_entry));
+
+	cleanup0:
+	pthread_mutex_unlock(&self->lock);
+}
+
+/*
+ * Checks if captured response 
+ * has status 200.
+ */
+bool https_captures_is_cacheable_private(const https_capture *self) {
+	static const char protocol[] = "HTTP/1.";
+	static const char status[] = " 200";
+
+	const char *response = (char *)self->response.data;
+	bool is_cacheable = 
+		!self->has_failed && 
+		self->response.size > 12 &&
+		strncmp(response, protocol, sizeof(protocol) - 1) == 0 && 
+		strncmp(response + 8, status, sizeof(status) - 1) == 0;
+
+	return is_cacheable;
+}
+
+error https_caches_init(
+	https_cache *self, https_cache_option option, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("option.headers", option.headers_size > 0 && !option.headers);
+	#endif
+
+	*self = (https_cache){
+		.ttl=option.ttl == 0 ? https_cache_ttl : option.ttl,
+		.capacity=option.capacity == 0 ? https_cache_capacity : option.capacity,
+		.buckets_size=https_cache_buckets,
+		.headers_size=option.headers_size,
+		.mem=mem,
+	};
+
+	size_t buckets_size = sizeof(https_cache_entry *) * self->buckets_size;
+	self->buckets = mems_alloc(mem, buckets_size);
+	if (!self->buckets) {
+		return fail;
+	}
+
+	memset(self->buckets, 0, buckets_size);
+
+	if (self->headers_size > 0) {
+		self->headers = mems_alloc(mem, sizeof(size_t) * self->headers_size);
+		if (!self->headers) {
+			mems_dealloc(mem, self->buckets, buckets_size);
+			return fail;
+		}
+
+		for (size_t i = 0; i < self->headers_size; i++) {
+			string header = strings_encapsulate(option.headers[i]);
+			self->headers[i] = strings_hash(&header);
+		}
+	}
+
+	pthread_mutex_init(&self->lock, null);
+	return ok;
+}
+
+void https_caches_clear(https_cache *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	pthread_mutex_lock(&self->lock);
+
+	while (self->oldest) {
+		https_caches_unlink_private(self, self->oldest);
+	}
+
+	pthread_mutex_unlock(&self->lock);
+}
+
+void https_caches_free(https_cache *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	https_caches_clear(self);
+
+	mems_dealloc(
+		self->mem, 
+		self->buckets, 
+		sizeof(https_cache_entry *) * self->buckets_size);
+
+	if (self->headers) {
+		mems_dealloc(self->mem, self->headers, sizeof(size_t) * self->headers_size);
+	}
+
+	pthread_mutex_destroy(&self->lock);
+}
+
+/* allocated in its own arena, so it outlives the accepting loop */
+typedef struct client_param {
+	int client;
+	router_tree *routes;
+	https_metrics *metrics;
+	ring *arenas;
+	allocator arena;
+	arena_mark mark;
+} client_param;
+
+/*
+ * Takes an arena from 'arenas', 
+ * making one if none is left.
+ */
+allocator https_arenas_acquire_private(ring *arenas) {
+	allocator arena = {0};
+
+	error pop_error = rings_try_pop(arenas, &arena);
+	if (pop_error) {
+		arena = arenas_init(https_arena_size);
+	}
+
+	return arena;
+}
+
+/*
+ * Resets 'arena' to 'mark', giving it back 
+ * to 'arenas' or freeing it if they are full.
+ */
+void https_arenas_release_private(
+	ring *arenas, allocator *arena, arena_mark mark) {
+
+	arenas_rewind(arena, mark, true);
+
+	error push_error = rings_try_push(arenas, arena);
+	if (push_error) {
+		mems_free(arena, null);
+	}
+}
+
+void *https_handle_client_private(void *args) {
+    client_param *arg = args;
+	int client_descriptor = arg->client;
+	router_tree *routes = arg->routes;
+	https_metrics *metrics = arg->metrics;
+	ring *arenas = arg->arenas;
+	allocator arena = arg->arena;
+	arena_mark mark = arg->mark;
+	const allocator *mem = &arena;
+
+	traces_scope("https_handle_client");
+
+	https_route_metrics *route_metrics = null;
+	size_t phases[https_private_phase] = {0};
+	bool has_phases[https_private_phase] = {0};
+	size_t started = 0;
+
+	if (metrics) {
+		__atomic_fetch_add(&metrics->in_flight, 1, __ATOMIC_RELAXED);
+		https_exchanged = (https_exchange){.is_measuring=true};
+	}
+
+
+	/* Receiving request */
+	
+	//ebyte_vec request = byte_vecs_receive(client_descriptor, MSG_WAITALL, 1024, mem);
+	byte_vec request = {0};
+	vectors_init(&request, sizeof(byte), string_small_size, mem);
+
+	traces_begin("https_receive");
+	long bytes = recv(
+		client_descriptor, 
+		request.data + request.size, 
+		string_small_size, 0);
+	traces_end("https_receive");
+
+	if (bytes < 0) {
+		#if cels_debug
+			fprintf(
+				stderr, 
+				"recv-error: %s (%d), client_descriptor: %d\n", 
+				strerror(errno), 
+				errno, 
+				client_descriptor);
+		#endif
+
+		goto cleanup0; 
+	} 
+
+	if (metrics) {
+		started = https_now_private();
+	}
+
+	request.size += bytes;
+	error push_error = vectors_push(&request, &(byte){'\0'}, mem);
+	if (push_error) { goto cleanup0; }
+
+	#if cels_debug
+		printf("request:\n");
+		byte_vecs_print(&request);
+		printf("\n");
+	#endif
+
+
+	/* tokenizing */
+
+	traces_begin("https_tokenize");
+	ebyte_map request_props = https_tokenize_private(
+		&request, mem);
+	traces_end("https_tokenize");
+
+	if (request_props.error != http_successfull) { 
+		#if cels_debug
+			fprintf(
+				stderr, 
+				colors_error("client '%d' had error '%d'\n"), 
+				client_descriptor,
+				request_props.error);
+		#endif
+
+		goto cleanup0; 
+	} 
+
+	#if cels_debug
+		printf("request: \n");
+		maps_print(
+			&request_props.value, 
+			(printfunc)strings_print, 
+			(printfunc)byte_vecs_print);
+		printf("\n");
+	#endif
+
+
+	/* routing */
+
+	traces_begin("https_route");
+	erouter_private callback = https_find_route_private(
+		routes, &request_props.value, mem);
+	traces_end("https_route");
+
+	if (metrics) {
+		phases[https_parse_phase] = https_now_private() - started;
+		has_phases[https_parse_phase] = true;
+		route_metrics = &metrics->unrouted;
+	}
+
+	if (callback.error != http_successfull) {
+		#if cels_debug
+			fprintf(
+				stderr, 
+				colors_error("'%d' had error '%d'\n"), 
+				client_descriptor,
+				callback.error);
+		#endif
+
+		if (callback.error == http_not_found_error) {
+			router_node *fallback = routes->data ? routes->data->down : null;
+			if (fallback && fallback->data.func) {
+				callback.value = fallback->data;
+			} else {
+				https_send_not_found(
+					null, client_descriptor, null, mem);
+
+				goto cleanup1;
+			}
+		} else {
+			https_send_not_found(
+				null, client_descriptor, null, mem);
+
+			goto cleanup1;
+		}
+	} 
+
+	errors_abort("callback.func", !callback.value.func);
+
+	if (metrics && callback.value.metrics) {
+		route_metrics = callback.value.metrics;
+	}
+
+
+	/* caching */
+
+	https_cache *cache = callback.value.cache;
+	https_capture capture = {.mem=mem};
+
+	char key[https_cache_key_size];
+	size_t key_size = 0;
+	size_t key_hash = 0;
+
+	if (cache) {
+		key_size = https_caches_key_private(
+			cache, &request_props.value, key, sizeof(key));
+	}
+
+	if (key_size > 0) {
+		key_hash = https_hash_private(key, key_size);
+
+		https_cache_entry *entry = 
+			https_caches_acquire_private(cache, key, key_size, key_hash);
+
+		if (entry) {
+			https_send_all_private(
+				client_descriptor, 
+				(char *)entry->response.data, 
+				entry->response.size, 
+				0);
+
+			https_caches_release_private(cache, entry);
+			goto cleanup1;
+		}
+
+		error init_error = vectors_init(
+			&capture.response, sizeof(byte), string_small_size, mem);
+
+		if (!init_error) {
+			https_captured = &capture;
+		}
+	}
+
+	size_t handling = metrics ? https_now_private() : 0;
+
+	traces_begin("https_handler");
+	callback.value.func(
+		&request_props.value, 
+		client_descriptor, 
+		callback.value.param,
+		mem);
+	traces_end("https_handler");
+
+	if (metrics) {
+		size_t handled = https_now_private() - handling;
+		size_t sent = https_exchanged.send_time;
+
+		phases[https_handler_phase] = handled > sent ? handled - sent : 0;
+		has_phases[https_handler_phase] = true;
+	}
+
+	if (https_captured) {
+		https_captured = null;
+
+		if (https_captures_is_cacheable_private(&capture)) {
+			https_caches_store_private(
+				cache, key, key_size, key_hash, &capture.response);
+		}
+	}
+
+
+	cleanup1:
+	if (route_metrics) {
+		phases[https_send_phase] = https_exchanged.send_time;
+		has_phases[https_send_phase] = 
+			https_exchanged.status != 0 || https_exchanged.send_time > 0;
+
+		https_route_metrics_record_private(route_metrics, phases, has_phases);
+	}
+
+	cleanup0:
+	if (metrics) {
+		__atomic_fetch_sub(&metrics->in_flight, 1, __ATOMIC_RELAXED);
+		https_exchanged.is_measuring = false;
+	}
+
+    close(client_descriptor);
+
+	/* the request, its properties and what the handler allocated */
+	https_arenas_release_private(arenas, &arena, mark);
+
+    return null;
+}
+
+router_private https_find_root_private(router_vec *callbacks) {
+	#if cels_debug
+		errors_abort("callbacks", vectors_check((const vector *)callbacks));
+	#endif
+
+	for (size_t i = 0; i < callbacks->size; i++) {
+		string *l = &callbacks->data[i].location;
+		if (l->size == 2 && l->data[0] == '/') {
+			router r = callbacks->data[i];
+
+			return (router_private) {
+				.location=r.location,
+				.param=r.param,
+				.func=r.func,
+				.cache=r.cache,
+				.metrics=r.metrics
+			};
+		}
+	}
+
+	return (router_private) {0};
+}
+
+error https_insert_route_private(
+	router_tree router, 
+	router_node **route, 
+	const string node_name, 
+	const struct router callback,
+	bool is_last,
+	const allocator *mem) {
+
+	size_t hash = strings_hash(&node_name);
+	router_node *hash_route = router_nodes_find_hash_private(
+		*route ? (*route)->down : null, hash);
+
+	if (hash_route) {
+		router_private *r = &hash_route->data;
+		if (!r->func && is_last) {
+			r->param = callback.param;
+			r->func = callback.func;
+			r->cache = callback.cache;
+			r->metrics = callback.metrics;
+		} else if (r->func && is_last) {
+			return http_route_collision_error;
+		}
+
+		*route = hash_route;
 	} else {
 		string loc = strings_clone(&node_name, mem);
 		router_node node = {
@@ -642,6 +1644,8 @@ error https_insert_route_private(
 		if (is_last) {
 			node.data.param = callback.param;
 			node.data.func = callback.func;
+			node.data.cache = callback.cache;
+			node.data.metrics = callback.metrics;
 		} 
 
 		router_node *node_capsule = mems_alloc(mem, sizeof(router_node));
@@ -681,7 +1685,7 @@ error https_insert_route_with_regex_private(
 		"vars_%s", mem, var_terms.data[0].data);
 
 	router_node *hash_route = router_nodes_find_hash_private(
-		*route, hash);
+		*route ? (*route)->down : null, hash);
 
 	regex_t regex = {0};
 	int reg_status = regcomp(
@@ -709,159 +1713,663 @@ error https_insert_route_with_regex_private(
 
 			router->param = callback.param;
 			router->func = callback.func;
+			router->cache = callback.cache;
+			router->metrics = callback.metrics;
 		} else {
 			regfree(&regex);
 			strings_free(&name, mem);
 		}
 
-		*route = hash_route;
+		*route = hash_route;
+	} else {
+		string loc = strings_clone(&node_name, mem);
+		router_node node = {
+			.data={
+				.location=loc,
+				.has_regex=true,
+				.regex=regex,
+				.hash=hash,
+				.name=name,
+			}
+		};
+
+		if (is_last) {
+			node.data.param = callback.param;
+			node.data.func = callback.func;
+			node.data.cache = callback.cache;
+			node.data.metrics = callback.metrics;
+		} 
+
+		router_node *node_capsule = mems_alloc(mem, sizeof(router_node));
+		errors_abort("node_capsule", !node_capsule);
+
+		*node_capsule = node;
+		if (*route && (*route)->down) {
+			mutrees_push(&router, (*route)->down, node_capsule);
+		} else {
+			mutrees_attach(&router, *route, node_capsule);
+		}
+
+		*route = node_capsule;
+	} 
+
+	return ok;
+}
+
+/* #to-review */
+cels_warn_unused
+erouter_tree https_create_router_private(
+	router_vec *callbacks, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort(
+			"callbacks", 
+			vectors_check((const vector *)callbacks));
+	#endif
+
+	error err = ok;
+
+	router_tree router = {0};
+	mutrees_init(router);
+
+	router_private index = https_find_root_private(callbacks);
+	router_node node = { .data=index };
+
+	router_node *node_capsule = mems_alloc(mem, sizeof(router_node));
+	errors_abort("node_capsule", !node_capsule);
+
+	*node_capsule = node;
+	mutrees_push(&router, null, node_capsule);
+
+
+	for (size_t i = 0; i < callbacks->size; i++) {
+		#if cels_debug
+			printf("callback: %zu/%zu\n", i, callbacks->size);
+		#endif
+
+		string location_normalized = strings_replace(
+			&callbacks->data[i].location, 
+			strings_do(" "), 
+			strings_do(""), 
+			0, mem);
+
+		string *rs = (string *)&route_sep;
+		string_vec location_terms = strings_split(
+			&location_normalized, *rs, 0, mem);
+
+		router_node *route = router.data;
+		for (size_t j = 0; j < location_terms.size; j++) {
+			bool is_last = j == location_terms.size - 1;
+			bool is_wildcard = strings_equals(
+				&location_terms.data[j], &strings_do("*"));
+
+			if (is_wildcard) {
+				if (!is_last) {
+					err = http_route_name_mal_formed_error;
+					goto cleanup1;
+				} else if (route->data.is_prefix) {
+					err = http_route_collision_error;
+					goto cleanup1;
+				}
+
+				route->data.is_prefix = true;
+				route->data.prefix_param = callbacks->data[i].param;
+				route->data.prefix_func = callbacks->data[i].func;
+				route->data.prefix_metrics = callbacks->data[i].metrics;
+				break;
+			}
+
+			string_vec var_terms = strings_split(
+				&location_terms.data[j], route_var_sep, 0, mem);
+
+			if (var_terms.size > 2) {
+				vectors_free(&var_terms, (freefunc)strings_free, mem);
+				err = http_route_name_mal_formed_error;
+				goto cleanup1;
+			}
+
+			#if cels_debug
+				vectors_debug(&var_terms, (printfunc)strings_print);
+				printf("\n");
+			#endif
+
+			bool is_variable_valid = strings_check_charset(
+				&var_terms.data[0], variable_charset);
+
+			if (!is_variable_valid) {
+				vectors_free(&var_terms, (freefunc)strings_free, mem);
+				err = http_route_name_invalid_error;
+				goto cleanup1;
+			}
+
+			error insert_error = ok;
+			if (var_terms.size < 2) {
+				insert_error = https_insert_route_private(
+					router, 
+					&route, 
+					location_terms.data[j], 
+					callbacks->data[i], 
+					is_last, 
+					mem);
+
+				vectors_free(&var_terms, (freefunc)strings_free, mem);
+			} else {
+				insert_error = https_insert_route_with_regex_private(
+					router, 
+					&route, 
+					location_terms.data[j], 
+					callbacks->data[i], 
+					is_last, 
+					var_terms,
+					mem);
+
+				vectors_free(&var_terms, (freefunc)strings_free, mem);
+			}
+
+			if (insert_error) {
+				err = insert_error;
+				goto cleanup1;
+			}
+		}
+
+
+		cleanup1:
+		vectors_free(&location_terms, (freefunc)strings_free, mem);
+		strings_free(&location_normalized, mem);
+
+		if (err) { 
+			goto cleanup0; 
+		}
+	}
+
+
+	return (erouter_tree){.value=router};
+
+	cleanup0:
+	mutrees_free(&router, (freefunc)router_privates_free, mem);
+
+	return (erouter_tree){.error=err};
+}
+
+/* https_statics */
+
+struct https_static_file {
+	size_t hash;
+	string path;
+	int descriptor;
+	size_t size;
+	time_t modified;
+	ino_t inode;
+	time_t checked;
+	size_t users;
+	bool is_retired;
+	/* used since the clock last passed */
+	bool is_referenced;
+	const char *type;
+	char etag[48];
+	char last_modified[32];
+};
+
+#define https_static_capacity 256
+#define https_static_revalidate 1
+
+static const char *https_static_types[][2] = {
+	{"html", "text/html; charset=utf-8"},
+	{"htm", "text/html; charset=utf-8"},
+	{"css", "text/css; charset=utf-8"},
+	{"js", "text/javascript; charset=utf-8"},
+	{"mjs", "text/javascript; charset=utf-8"},
+	{"json", "application/json"},
+	{"txt", "text/plain; charset=utf-8"},
+	{"xml", "application/xml"},
+	{"svg", "image/svg+xml"},
+	{"png", "image/png"},
+	{"jpg", "image/jpeg"},
+	{"jpeg", "image/jpeg"},
+	{"gif", "image/gif"},
+	{"webp", "image/webp"},
+	{"ico", "image/x-icon"},
+	{"woff", "font/woff"},
+	{"woff2", "font/woff2"},
+	{"ttf", "font/ttf"},
+	{"pdf", "application/pdf"},
+	{"wasm", "application/wasm"},
+	{"mp4", "video/mp4"},
+	{"webm", "video/webm"},
+};
+
+const char *https_statics_type_private(const string *path) {
+	const char *extension = strrchr(path->data, '.');
+	if (!extension || strchr(extension, '/')) {
+		return "application/octet-stream";
+	}
+
+	++extension;
+	size_t types_size = sizeof(https_static_types) / sizeof(*https_static_types);
+	for (size_t i = 0; i < types_size; i++) {
+		if (strcasecmp(extension, https_static_types[i][0]) == 0) {
+			return https_static_types[i][1];
+		}
+	}
+
+	return "application/octet-stream";
+}
+
+void https_static_files_free_private(
+	https_static_file *self, const allocator *mem) {
+
+	if (self->descriptor >= 0) {
+		close(self->descriptor);
+	}
+
+	strings_free(&self->path, mem);
+	mems_dealloc(mem, self, sizeof(https_static_file));
+}
+
+static https_static_file https_static_tombstone = {0};
+
+/*
+ * Finds the slot where path is or 
+ * would be placed, null if table is full.
+ */
+https_static_file **https_statics_find_private(
+	https_static *self, const string *path, size_t hash) {
+
+	https_static_file **tombstone = null;
+	size_t mask = self->capacity - 1;
+
+	for (size_t i = 0; i < self->capacity; i++) {
+		https_static_file **slot = &self->files[(hash + i) & mask];
+		if (!*slot) {
+			return tombstone ? tombstone : slot;
+		} else if (*slot == &https_static_tombstone) {
+			if (!tombstone) { tombstone = slot; }
+			continue;
+		}
+
+		bool is_equal = 
+			(*slot)->hash == hash && 
+			strings_equals(&(*slot)->path, path);
+
+		if (is_equal) {
+			return slot;
+		}
+	}
+
+	return tombstone;
+}
+
+/*
+ * Opens file at 'path' (relative to root) 
+ * filling its metadata.
+ */
+https_static_file *https_statics_open_private(
+	https_static *self, const string *path, size_t hash, time_t now) {
+
+	string full_path = strings_format(
+		"%s/%s", self->mem, self->root.data, path->data);
+
+	int descriptor = open(full_path.data, O_RDONLY | O_CLOEXEC);
+	strings_free(&full_path, self->mem);
+
+	if (descriptor < 0) {
+		return null;
+	}
+
+	struct stat status = {0};
+	int stat_status = fstat(descriptor, &status);
+
+	if (stat_status < 0 || !S_ISREG(status.st_mode)) {
+		close(descriptor);
+		return null;
+	}
+
+	https_static_file *file = mems_alloc(self->mem, sizeof(https_static_file));
+	if (!file) {
+		close(descriptor);
+		return null;
+	}
+
+	*file = (https_static_file){
+		.hash=hash,
+		.path=strings_clone(path, self->mem),
+		.descriptor=descriptor,
+		.size=status.st_size,
+		.modified=status.st_mtime,
+		.inode=status.st_ino,
+		.checked=now,
+		.type=https_statics_type_private(path),
+	};
+
+	snprintf(
+		file->etag, 
+		sizeof(file->etag), 
+		"\"%lx-%zx\"", 
+		(ulong)file->modified, 
+		file->size);
+
+	struct tm modified = {0};
+	gmtime_r(&file->modified, &modified);
+	strftime(
+		file->last_modified, 
+		sizeof(file->last_modified), 
+		"%a, %d %b %Y %H:%M:%S GMT", 
+		&modified);
+
+	return file;
+}
+
+void https_statics_release_private(
+	https_static *self, https_static_file *file) {
+
+	pthread_mutex_lock(&self->lock);
+
+	--file->users;
+	if (file->is_retired && file->users == 0) {
+		https_static_files_free_private(file, self->mem);
+	}
+
+	pthread_mutex_unlock(&self->lock);
+}
+
+/*
+ * Takes file out of its slot, freeing 
+ * it once no request is sending it.
+ */
+void https_statics_retire_private(
+	https_static *self, https_static_file **slot) {
+
+	https_static_file *file = *slot;
+	*slot = &https_static_tombstone;
+	--self->size;
+	++self->removed;
+
+	if (file->users == 0) {
+		https_static_files_free_private(file, self->mem);
+	} else {
+		file->is_retired = true;
+	}
+}
+
+/*
+ * Evicts a file not used since the 
+ * clock last passed by it - two 
+ * sweeps always find one.
+ */
+void https_statics_evict_private(https_static *self) {
+	size_t mask = self->capacity - 1;
+
+	for (size_t i = 0; i < self->capacity * 2; i++) {
+		https_static_file **slot = &self->files[self->hand];
+		self->hand = (self->hand + 1) & mask;
+
+		if (!*slot || *slot == &https_static_tombstone) {
+			continue;
+		}
+
+		if ((*slot)->is_referenced) {
+			(*slot)->is_referenced = false;
+			continue;
+		}
+
+		https_statics_retire_private(self, slot);
+		return;
+	}
+}
+
+/*
+ * Drops the tombstones by placing 
+ * the files again in the same table.
+ */
+error https_statics_purge_private(https_static *self) {
+	size_t files_size = self->size * sizeof(https_static_file *);
+
+	https_static_file **files = null;
+	if (files_size) {
+		files = mems_alloc(self->mem, files_size);
+		if (!files) { return fail; }
+	}
+
+	size_t size = 0;
+	for (size_t i = 0; i < self->capacity; i++) {
+		https_static_file *file = self->files[i];
+		if (!file || file == &https_static_tombstone) { continue; }
+
+		files[size++] = file;
+	}
+
+	memset(self->files, 0, sizeof(https_static_file *) * self->capacity);
+
+	for (size_t i = 0; i < size; i++) {
+		https_static_file **slot = 
+			https_statics_find_private(self, &files[i]->path, files[i]->hash);
+
+		*slot = files[i];
+	}
+
+	if (files) {
+		mems_dealloc(self->mem, files, files_size);
+	}
+
+	self->removed = 0;
+	return ok;
+}
+
+/*
+ * Caches file opened outside the lock, 
+ * unless another request cached the 
+ * same path meanwhile - then that one 
+ * is returned and file is freed.
+ */
+https_static_file *https_statics_publish_private(
+	https_static *self, https_static_file *file) {
+
+	pthread_mutex_lock(&self->lock);
+
+	https_static_file **slot = 
+		https_statics_find_private(self, &file->path, file->hash);
+
+	if (slot && *slot && *slot != &https_static_tombstone) {
+		https_static_file *cached = *slot;
+		cached->is_referenced = true;
+		++cached->users;
+
+		pthread_mutex_unlock(&self->lock);
+		https_static_files_free_private(file, self->mem);
+		return cached;
+	}
+
+	if (self->size >= self->capacity / 2) {
+		https_statics_evict_private(self);
+		slot = https_statics_find_private(self, &file->path, file->hash);
+	}
+
+	bool is_crowded = 
+		slot && !*slot && 
+		(self->size + self->removed + 1) * 4 > self->capacity * 3;
+
+	if (is_crowded) {
+		error purge_error = https_statics_purge_private(self);
+		slot = purge_error ? 
+			null : https_statics_find_private(self, &file->path, file->hash);
+	}
+
+	if (slot) {
+		if (*slot == &https_static_tombstone) {
+			--self->removed;
+		}
+
+		*slot = file;
+		++self->size;
 	} else {
-		string loc = strings_clone(&node_name, mem);
-		router_node node = {
-			.data={
-				.location=loc,
-				.has_regex=true,
-				.regex=regex,
-				.hash=hash,
-				.name=name,
-			}
-		};
-
-		if (is_last) {
-			node.data.param = callback.param;
-			node.data.func = callback.func;
-		} 
+		file->is_retired = true;
+	}
 
-		router_node *node_capsule = mems_alloc(mem, sizeof(router_node));
-		errors_abort("node_capsule", !node_capsule);
+	file->is_referenced = true;
+	++file->users;
+	pthread_mutex_unlock(&self->lock);
 
-		*node_capsule = node;
-		if (*route && (*route)->down) {
-			mutrees_push(&router, (*route)->down, node_capsule);
-		} else {
-			mutrees_attach(&router, *route, node_capsule);
-		}
+	return file;
+}
 
-		*route = node_capsule;
-	} 
+/*
+ * Parses an http-date, as in 
+ * "Sun, 06 Nov 1994 08:49:37 GMT", 
+ * returning -1 if it is malformed.
+ */
+time_t https_dates_parse_private(const char *date) {
+	struct tm parsed = {0};
+	const char *rest = strptime(date, "%a, %d %b %Y %H:%M:%S GMT", &parsed);
+
+	if (!rest || *rest != '\0') {
+		return -1;
+	}
 
-	return ok;
+	return timegm(&parsed);
 }
 
-/* #to-review */
-cels_warn_unused
-erouter_tree https_create_router_private(
-	router_vec *callbacks, const allocator *mem) {
+/*
+ * Gets cached file, revalidating it 
+ * against the filesystem at most once 
+ * a second - opening and stating 
+ * happen outside the lock.
+ *
+ * Returned file must be released.
+ */
+https_static_file *https_statics_acquire_private(
+	https_static *self, const string *path) {
 
-	#if cels_debug
-		errors_abort(
-			"callbacks", 
-			vectors_check((const vector *)callbacks));
-	#endif
+	size_t hash = https_hash_private(path->data, path->size - 1);
+	time_t now = time(null);
 
-	error err = ok;
+	pthread_mutex_lock(&self->lock);
 
-	router_tree router = {0};
-	mutrees_init(router);
+	https_static_file **slot = https_statics_find_private(self, path, hash);
+	bool is_cached = slot && *slot && *slot != &https_static_tombstone;
 
-	router_private index = https_find_root_private(callbacks);
-	router_node node = { .data=index };
+	https_static_file *cached = is_cached ? *slot : null;
+	bool is_fresh = false;
 
-	router_node *node_capsule = mems_alloc(mem, sizeof(router_node));
-	errors_abort("node_capsule", !node_capsule);
+	if (cached) {
+		cached->is_referenced = true;
+		++cached->users;
+		is_fresh = now - cached->checked < https_static_revalidate;
+	}
 
-	*node_capsule = node;
-	mutrees_push(&router, null, node_capsule);
+	pthread_mutex_unlock(&self->lock);
 
+	if (is_fresh) {
+		return cached;
+	}
 
-	for (size_t i = 0; i < callbacks->size; i++) {
-		#if cels_debug
-			printf("callback: %zu/%zu\n", i, callbacks->size);
-		#endif
+	if (cached) {
+		string full_path = strings_format(
+			"%s/%s", self->mem, self->root.data, path->data);
 
-		string location_normalized = strings_replace(
-			&callbacks->data[i].location, 
-			strings_do(" "), 
-			strings_do(""), 
-			0, mem);
+		struct stat status = {0};
+		int stat_status = stat(full_path.data, &status);
+		strings_free(&full_path, self->mem);
 
-		string *rs = (string *)&route_sep;
-		string_vec location_terms = strings_split(
-			&location_normalized, *rs, 0, mem);
+		is_fresh = 
+			stat_status == 0 && 
+			(size_t)status.st_size == cached->size && 
+			status.st_mtime == cached->modified && 
+			status.st_ino == cached->inode;
 
-		router_node *route = router.data;
-		for (size_t j = 0; j < location_terms.size; j++) {
-			string_vec var_terms = strings_split(
-				&location_terms.data[j], route_var_sep, 0, mem);
+		pthread_mutex_lock(&self->lock);
 
-			if (var_terms.size > 2) {
-				vectors_free(&var_terms, (freefunc)strings_free, mem);
-				err = http_route_name_mal_formed_error;
-				goto cleanup1;
-			}
+		if (is_fresh) {
+			cached->checked = now;
+			pthread_mutex_unlock(&self->lock);
+			return cached;
+		}
 
-			#if cels_debug
-				vectors_debug(&var_terms, (printfunc)strings_print);
-				printf("\n");
-			#endif
+		/* it may have been evicted or replaced while unlocked */
+		slot = https_statics_find_private(self, path, hash);
+		if (slot && *slot == cached) {
+			https_statics_retire_private(self, slot);
+		}
 
-			bool is_variable_valid = strings_check_charset(
-				&var_terms.data[0], variable_charset);
+		pthread_mutex_unlock(&self->lock);
+		https_statics_release_private(self, cached);
+	}
 
-			if (!is_variable_valid) {
-				vectors_free(&var_terms, (freefunc)strings_free, mem);
-				err = http_route_name_invalid_error;
-				goto cleanup1;
-			}
+	https_static_file *file = 
+		https_statics_open_private(self, path, hash, now);
 
-			error insert_error = ok;
-			bool is_last = j == location_terms.size - 1;
-			if (var_terms.size < 2) {
-				insert_error = https_insert_route_private(
-					router, 
-					&route, 
-					location_terms.data[j], 
-					callbacks->data[i], 
-					is_last, 
-					mem);
+	if (!file) {
+		return null;
+	}
 
-				vectors_free(&var_terms, (freefunc)strings_free, mem);
-			} else {
-				insert_error = https_insert_route_with_regex_private(
-					router, 
-					&route, 
-					location_terms.data[j], 
-					callbacks->data[i], 
-					is_last, 
-					var_terms,
-					mem);
+	return https_statics_publish_private(self, file);
+}
 
-				vectors_free(&var_terms, (freefunc)strings_free, mem);
-			}
+error https_statics_init(
+	https_static *self, 
+	const char *root, 
+	const char *prefix, 
+	https_static_option option, 
+	const allocator *mem) {
 
-			if (insert_error) {
-				err = insert_error;
-				goto cleanup1;
-			}
-		}
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("root", strs_check(root));
+		errors_abort("prefix", strs_check(prefix));
+		errors_abort("prefix[0]", prefix[0] != '/');
+	#endif
 
+	*self = (https_static){.max_age=option.max_age, .mem=mem};
 
-		cleanup1:
-		vectors_free(&location_terms, (freefunc)strings_free, mem);
-		strings_free(&location_normalized, mem);
+	size_t capacity = option.capacity == 0 ? 
+		https_static_capacity : option.capacity;
 
-		if (err) { 
-			goto cleanup0; 
-		}
+	self->capacity = maths_nearest_two_power(capacity * 2);
+	self->files = mems_alloc(mem, sizeof(https_static_file *) * self->capacity);
+	if (!self->files) {
+		return fail;
 	}
 
+	memset(self->files, 0, sizeof(https_static_file *) * self->capacity);
 
-	return (erouter_tree){.value=router};
+	self->root = strings_make(root, mem);
+	if (self->root.size > 2 && self->root.data[self->root.size - 2] == '/') {
+		self->root.data[--self->root.size - 1] = '\0';
+	}
 
-	cleanup0:
-	mutrees_free(&router, (freefunc)router_privates_free, mem);
+	self->prefix = strings_make(prefix, mem);
+	if (self->prefix.size > 2 && self->prefix.data[self->prefix.size - 2] == '/') {
+		self->prefix.data[--self->prefix.size - 1] = '\0';
+	}
 
-	return (erouter_tree){.error=err};
+	bool is_root = self->prefix.size == 2;
+	self->location = strings_format(
+		is_root ? "%s*" : "%s/*", mem, self->prefix.data);
+
+	pthread_mutex_init(&self->lock, null);
+	return ok;
+}
+
+void https_statics_free(https_static *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	for (size_t i = 0; i < self->capacity; i++) {
+		https_static_file *file = self->files[i];
+		if (file && file != &https_static_tombstone) {
+			https_static_files_free_private(file, self->mem);
+		}
+	}
+
+	mems_dealloc(
+		self->mem, 
+		self->files, 
+		sizeof(https_static_file *) * self->capacity);
+
+	strings_free(&self->root, self->mem);
+	strings_free(&self->prefix, self->mem);
+	strings_free(&self->location, self->mem);
+	pthread_mutex_destroy(&self->lock);
 }
 
 http_error https_serve(short port, router_vec *callbacks, const allocator *mem) {
@@ -870,6 +2378,32 @@ http_error https_serve(short port, router_vec *callbacks, const allocator *mem)
 	#endif
 
 	https_initialize_private();
+
+	https_metrics *metrics = null;
+	for (size_t i = 0; i < callbacks->size; i++) {
+		if (callbacks->data[i].func == https_send_metrics) {
+			metrics = callbacks->data[i].param;
+			break;
+		}
+	}
+
+	if (metrics) {
+		size_t routes_size = sizeof(https_route_metrics) * callbacks->size;
+		metrics->routes = mems_alloc(mem, routes_size);
+		if (!metrics->routes) {
+			return http_generic_error;
+		}
+
+		memset(metrics->routes, 0, routes_size);
+		metrics->routes_size = callbacks->size;
+		metrics->unrouted.location = strings_do("");
+
+		for (size_t i = 0; i < callbacks->size; i++) {
+			metrics->routes[i].location = callbacks->data[i].location;
+			callbacks->data[i].metrics = &metrics->routes[i];
+		}
+	}
+
 	erouter_tree router = https_create_router_private(callbacks, mem);
 	if (router.error != http_successfull) {
 		return router.error;
@@ -919,6 +2453,14 @@ http_error https_serve(short port, router_vec *callbacks, const allocator *mem)
 	}
 	#undef https_request_maximum
 
+	ring arenas = {0};
+	error arenas_error = rings_init(
+		&arenas, sizeof(allocator), https_arena_pool_size, mem);
+
+	if (arenas_error) {
+		return http_generic_error;
+	}
+
     while (true) {
 		struct sockaddr_in client_address = {0};
 		socklen_t client_address_size = sizeof(client_address);
@@ -936,11 +2478,38 @@ http_error https_serve(short port, router_vec *callbacks, const allocator *mem)
 			continue; 
 		}
 
+		if (metrics) {
+			__atomic_fetch_add(&metrics->accepted, 1, __ATOMIC_RELAXED);
+		}
+
+		allocator arena = https_arenas_acquire_private(&arenas);
+		arena_mark mark = arenas_mark(&arena);
+
+		client_param *param = mems_alloc(&arena, sizeof(client_param));
+		if (!param) {
+			close(client_descriptor);
+			https_arenas_release_private(&arenas, &arena, mark);
+			continue;
+		}
+
+		*param = (client_param){
+			.client=client_descriptor, 
+			.routes=&router.value, 
+			.metrics=metrics,
+			.arenas=&arenas,
+			.arena=arena,
+			.mark=mark};
+
 		pthread_t thread = {0};
-		client_param param = {
-			.client=client_descriptor, .routes=&router.value};
+		int create_error = pthread_create(
+			&thread, null, https_handle_client_private, param);
+
+		if (create_error) {
+			close(client_descriptor);
+			https_arenas_release_private(&arenas, &arena, mark);
+			continue;
+		}
 
-		pthread_create(&thread, null, https_handle_client_private, &param);
 		pthread_detach(thread);
     }
 
@@ -948,7 +2517,10 @@ http_error https_serve(short port, router_vec *callbacks, const allocator *mem)
 }
 
 void https_send_not_found(
-	notused byte_map *request, int client_connection, notused void *param) {
+	notused byte_map *request, 
+	int client_connection, 
+	notused void *param, 
+	notused const allocator *mem) {
 
 	static const byte_vec not_found_page = byte_vecs_premake(
 		"HTTP/1.1 404 Not Found\r\nContent-Type: text/html\r\n\r\n"
@@ -957,12 +2529,342 @@ void https_send_not_found(
 		"<body><h1>404</h1><h4>your page wasn't found</h4></body>"
 		"</html>");
 
+	size_t start = https_exchanged.is_measuring ? https_now_private() : 0;
+	https_exchanges_status_private(
+		(char *)not_found_page.data, not_found_page.size - 1);
+
 	send(client_connection, not_found_page.data, not_found_page.size - 1, 0);
+	https_exchanges_sent_private(start);
 }
 
 void https_send(
 	int client_connection, const byte_vec head, const byte_vec body) {
 
+	size_t start = https_exchanged.is_measuring ? https_now_private() : 0;
+	https_exchanges_status_private((char *)head.data, head.size - 1);
+
 	send(client_connection, head.data, head.size - 1, 0);
 	send(client_connection, body.data, body.size - 1, 0);
+	https_exchanges_sent_private(start);
+
+	https_capture *capture = https_captured;
+	if (!capture || capture->has_failed) {
+		return;
+	}
+
+	const byte_vec *parts[] = {&head, &body};
+	for (size_t i = 0; i < 2; i++) {
+		byte_vec *response = &capture->response;
+		size_t size = parts[i]->size - 1;
+
+		while (response->size + size >= response->capacity) {
+			error upscale_error = vectors_upscale(response, capture->mem);
+			if (upscale_error) {
+				capture->has_failed = true;
+				return;
+			}
+		}
+
+		memcpy(response->data + response->size, parts[i]->data, size);
+		response->size += size;
+	}
+}
+
+typedef enum https_range {
+	https_no_range,
+	https_valid_range,
+	https_unsatisfiable_range,
+} https_range;
+
+/*
+ * Parses a single 'bytes=' range, multiple 
+ * or mal-formed ranges are ignored.
+ */
+https_range https_statics_range_private(
+	const char *value, size_t size, size_t *start, size_t *end) {
+
+	static const char unit[] = "bytes=";
+	if (strncmp(value, unit, sizeof(unit) - 1) != 0 || strchr(value, ',')) {
+		return https_no_range;
+	}
+
+	value += sizeof(unit) - 1;
+
+	char *rest = null;
+	if (*value == '-') {
+		size_t suffix = strtoull(value + 1, &rest, 10);
+		if (rest == value + 1 || *rest != '\0') {
+			return https_no_range;
+		} else if (suffix == 0 || size == 0) {
+			return https_unsatisfiable_range;
+		}
+
+		*start = suffix < size ? size - suffix : 0;
+		*end = size - 1;
+		return https_valid_range;
+	}
+
+	if (*value < '0' || *value > '9') {
+		return https_no_range;
+	}
+
+	*start = strtoull(value, &rest, 10);
+	if (*rest != '-') {
+		return https_no_range;
+	}
+
+	value = rest + 1;
+	if (*value == '\0') {
+		*end = size - 1;
+	} else {
+		*end = strtoull(value, &rest, 10);
+		if (*rest != '\0' || *end < *start) {
+			return https_no_range;
+		}
+	}
+
+	if (*start >= size) {
+		return https_unsatisfiable_range;
+	} else if (*end >= size) {
+		*end = size - 1;
+	}
+
+	return https_valid_range;
+}
+
+void https_send_static(
+	byte_map *request, 
+	int client_connection, 
+	void *param, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("request", !request);
+		errors_abort("param", !param);
+	#endif
+
+	static const byte_vec method_not_allowed = byte_vecs_premake(
+		"HTTP/1.1 405 Method Not Allowed\r\n"
+		"Allow: GET, HEAD\r\nContent-Length: 0\r\n\r\n");
+
+	https_static *self = param;
+
+	byte_vec *method = maps_get(request, http_header_hashs[0]);
+	byte_vec *location = maps_get(request, http_header_hashs[1]);
+	if (!method || !location) {
+		https_send_not_found(request, client_connection, null, mem);
+		return;
+	}
+
+	bool is_head = strcmp((char *)method->data, "HEAD") == 0;
+	bool is_get = strcmp((char *)method->data, "GET") == 0;
+	if (!is_head && !is_get) {
+		https_send_all_private(
+			client_connection, 
+			(char *)method_not_allowed.data, 
+			method_not_allowed.size - 1, 
+			0);
+
+		return;
+	}
+
+
+	/* resolving path */
+
+	const char *path = (char *)location->data;
+	size_t path_size = strcspn(path, "?#");
+
+	bool is_root = self->prefix.size == 2;
+	size_t prefix_size = is_root ? 0 : self->prefix.size - 1;
+
+	bool has_prefix = 
+		path_size >= prefix_size && 
+		strncmp(path, self->prefix.data, prefix_size) == 0;
+
+	if (!has_prefix) {
+		https_send_not_found(request, client_connection, null, mem);
+		return;
+	}
+
+	path += prefix_size;
+	path_size -= prefix_size;
+
+	while (path_size > 0 && *path == '/') {
+		++path;
+		--path_size;
+	}
+
+	bool is_directory = path_size == 0 || path[path_size - 1] == '/';
+
+	char relative_path[PATH_MAX] = {0};
+	int relative_size = snprintf(
+		relative_path, 
+		sizeof(relative_path), 
+		is_directory ? "%.*sindex.html" : "%.*s", 
+		(int)path_size, 
+		path);
+
+	bool is_traversal = 
+		strcmp(relative_path, "..") == 0 ||
+		strncmp(relative_path, "../", 3) == 0 ||
+		strstr(relative_path, "/../") ||
+		(relative_size > 3 && strcmp(relative_path + relative_size - 3, "/..") == 0);
+
+	bool is_path_valid = 
+		!is_traversal && 
+		relative_size > 0 && 
+		relative_size < (int)sizeof(relative_path);
+
+	https_static_file *file = null;
+	if (is_path_valid) {
+		string relative = strings_encapsulate(relative_path);
+		file = https_statics_acquire_private(self, &relative);
+	}
+
+	if (!file) {
+		https_send_not_found(request, client_connection, null, mem);
+		return;
+	}
+
+
+	/* conditionals */
+
+	byte_vec *if_none_match = maps_get(request, strings_prehash("If-None-Match"));
+	byte_vec *if_modified_since = 
+		maps_get(request, strings_prehash("If-Modified-Since"));
+
+	bool is_not_modified = false;
+	if (if_none_match) {
+		const char *tags = (char *)if_none_match->data;
+		is_not_modified = strcmp(tags, "*") == 0 || strstr(tags, file->etag);
+	} else if (if_modified_since) {
+		time_t since = https_dates_parse_private((char *)if_modified_since->data);
+		is_not_modified = since != -1 && file->modified <= since;
+	}
+
+	char cache_control[48] = "";
+	if (self->max_age > 0) {
+		snprintf(
+			cache_control, 
+			sizeof(cache_control), 
+			"Cache-Control: max-age=%lu\r\n", 
+			self->max_age);
+	}
+
+	char head[512] = {0};
+	int head_size = 0;
+
+	if (is_not_modified) {
+		head_size = snprintf(
+			head, 
+			sizeof(head), 
+			"HTTP/1.1 304 Not Modified\r\n"
+			"ETag: %s\r\n"
+			"Last-Modified: %s\r\n"
+			"%s"
+			"Connection: close\r\n\r\n",
+			file->etag,
+			file->last_modified,
+			cache_control);
+
+		https_send_all_private(client_connection, head, head_size, 0);
+		goto cleanup;
+	}
+
+
+	/* ranges */
+
+	size_t start = 0;
+	size_t end = file->size - 1;
+	https_range range = https_no_range;
+
+	byte_vec *range_value = maps_get(request, strings_prehash("Range"));
+	byte_vec *if_range = maps_get(request, strings_prehash("If-Range"));
+
+	bool is_range_applicable = 
+		range_value && 
+		(!if_range || strcmp((char *)if_range->data, file->etag) == 0);
+
+	if (is_range_applicable) {
+		range = https_statics_range_private(
+			(char *)range_value->data, file->size, &start, &end);
+	}
+
+	if (range == https_unsatisfiable_range) {
+		head_size = snprintf(
+			head, 
+			sizeof(head), 
+			"HTTP/1.1 416 Range Not Satisfiable\r\n"
+			"Content-Range: bytes */%zu\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: close\r\n\r\n",
+			file->size);
+
+		https_send_all_private(client_connection, head, head_size, 0);
+		goto cleanup;
+	}
+
+	size_t length = file->size == 0 ? 0 : end - start + 1;
+	char content_range[80] = "";
+	if (range == https_valid_range) {
+		snprintf(
+			content_range, 
+			sizeof(content_range), 
+			"Content-Range: bytes %zu-%zu/%zu\r\n", 
+			start, 
+			end, 
+			file->size);
+	}
+
+	head_size = snprintf(
+		head, 
+		sizeof(head), 
+		"HTTP/1.1 %s\r\n"
+		"Content-Type: %s\r\n"
+		"Content-Length: %zu\r\n"
+		"%s"
+		"ETag: %s\r\n"
+		"Last-Modified: %s\r\n"
+		"%s"
+		"Accept-Ranges: bytes\r\n"
+		"Connection: close\r\n\r\n",
+		range == https_valid_range ? "206 Partial Content" : "200 OK",
+		file->type,
+		length,
+		content_range,
+		file->etag,
+		file->last_modified,
+		cache_control);
+
+	bool has_body = !is_head && length > 0;
+	error send_error = https_send_all_private(
+		client_connection, head, head_size, has_body ? MSG_MORE : 0);
+
+	if (send_error || !has_body) {
+		goto cleanup;
+	}
+
+
+	/* sending body without copying */
+
+	size_t sending = https_exchanged.is_measuring ? https_now_private() : 0;
+
+	off_t offset = start;
+	while (length > 0) {
+		long bytes = sendfile(
+			client_connection, file->descriptor, &offset, length);
+
+		if (bytes < 0 && errno == EINTR) {
+			continue;
+		} else if (bytes <= 0) {
+			break;
+		}
+
+		length -= bytes;
+	}
+
+	https_exchanges_sent_private(sending);
+
+	cleanup:
+	https_statics_release_private(self, file);
 }
@@ -1,6 +1,15 @@
 #ifndef https_h
 #define https_h
 
+/* for strptime and timegm outside gnu modes */
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 700
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
 #include <netinet/in.h>
 #include <pthread.h>
 #include <errno.h>
@@ -12,7 +21,12 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <sys/types.h> 
+#include <sys/stat.h>
+#include <sys/sendfile.h>
 #include <arpa/inet.h>
+#include <time.h>
+#include <limits.h>
+#include <stdarg.h>
 
 #include <openssl/bio.h>
 #include <openssl/ssl.h>
@@ -27,6 +41,7 @@
 #include "nodes.h"
 #include "utils.h"
 #include "bytes.h"
+#include "traces.h"
 
 
 /*
@@ -41,7 +56,14 @@
 
 /* routers */
 
-typedef void (*httpfunc) (byte_map *, int, void *);
+/*
+ * Handles a request, given its properties, the 
+ * client's descriptor, the route's param and 
+ * the connection's arena - which is reset once 
+ * the response is sent, so what is allocated 
+ * with it needn't be freed.
+ */
+typedef void (*httpfunc) (byte_map *, int, void *, const allocator *);
 
 typedef enum http_error {
 	http_successfull,
@@ -65,19 +87,32 @@ typedef enum http_error {
 	http_listen_failed_error,
 } http_error;
 
+typedef struct https_cache https_cache;
+typedef struct https_route_metrics https_route_metrics;
+
 typedef struct router {
 	string location;
 	httpfunc func;
 	void *param;
+	/* caches responses sent by 'func', may be null */
+	https_cache *cache;
+	/* set by https_serve when metrics are served */
+	https_route_metrics *metrics;
 } router;
 
 typedef struct router_private {
 	string location;
 	httpfunc func;
 	void *param;
+	https_cache *cache;
+	https_route_metrics *metrics;
 	string name;
 	size_t hash;
 	bool has_regex;
+	bool is_prefix;
+	httpfunc prefix_func;
+	void *prefix_param;
+	https_route_metrics *prefix_metrics;
 	regex_t regex;
 } router_private;
 
@@ -102,6 +137,36 @@ error router_vecs_push_with(
 	void *param, 
 	const allocator *mem);
 
+typedef struct https_static https_static;
+
+/*
+ * Pushes a route serving every file 
+ * under 'statics' prefix.
+ *
+ * Locations ending in '*' match the 
+ * rest of the path, so more specific 
+ * routes still take precedence.
+ *
+ * #to-review
+ */
+error router_vecs_push_static(
+	router_vec *self, https_static *statics, const allocator *mem);
+
+typedef struct https_metrics https_metrics;
+
+/*
+ * Pushes a route exposing 'metrics' 
+ * in prometheus' text format, which 
+ * turns metrics on for the server.
+ *
+ * #to-review
+ */
+error router_vecs_push_metrics(
+	router_vec *self, 
+	char *location, 
+	https_metrics *metrics, 
+	const allocator *mem);
+
 
 /* router_nodes and router_node_vecs */
 
@@ -132,16 +197,214 @@ bool router_nodes_check(const router_node *self);
 void router_nodes_debug(const router_node *self);
 
 
+/* https_caches */
+
+typedef struct https_cache_entry https_cache_entry;
+
+typedef struct https_cache_option {
+	/* seconds a response is reused, 0 is 60s */
+	ulong ttl;
+	/* maximum ammount of cached bytes, 0 is 16MiB */
+	size_t capacity;
+	/* headers that vary the response (like "Cookie"), may be null */
+	const char **headers;
+	size_t headers_size;
+} https_cache_option;
+
+struct https_cache {
+	pthread_mutex_t lock;
+	https_cache_entry **buckets;
+	size_t buckets_size;
+	https_cache_entry *newest;
+	https_cache_entry *oldest;
+	size_t size;
+	size_t capacity;
+	ulong ttl;
+	size_t *headers;
+	size_t headers_size;
+	const allocator *mem;
+};
+
+/*
+ * Initializes a response cache that may be 
+ * shared by routes (through 'router.cache').
+ *
+ * Responses of GET requests sent through 
+ * https_send with status 200 are kept 
+ * per method, location (with query) and 
+ * 'option.headers', being sent again 
+ * without calling the handler.
+ *
+ * 'mem' must be thread-safe (as null is),
+ * as every serving thread allocates through it.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error https_caches_init(
+	https_cache *self, https_cache_option option, const allocator *mem);
+
+/*
+ * Drops every cached response.
+ *
+ * #thread-safe #to-review
+ */
+void https_caches_clear(https_cache *self);
+
+/*
+ * Frees cache.
+ *
+ * Must only be called once no 
+ * request is being served by it.
+ *
+ * #to-review
+ */
+void https_caches_free(https_cache *self);
+
+
+/* https_statics */
+
+typedef struct https_static_file https_static_file;
+
+typedef struct https_static_option {
+	/* seconds sent in cache-control, 0 omits it */
+	ulong max_age;
+	/* maximum ammount of cached files, 0 is 256 */
+	size_t capacity;
+} https_static_option;
+
+struct https_static {
+	string root;
+	string prefix;
+	string location;
+	ulong max_age;
+	pthread_mutex_t lock;
+	https_static_file **files;
+	/* cached files, at most half of capacity */
+	size_t size;
+	size_t removed;
+	/* a power of two */
+	size_t capacity;
+	/* next slot the clock looks at to evict */
+	size_t hand;
+	const allocator *mem;
+};
+
+/*
+ * Initializes a static directory 'root' 
+ * to be served under 'prefix' (like "/assets").
+ *
+ * Open descriptors and file metadata are 
+ * cached and revalidated at most once 
+ * a second, while past 'option.capacity'
+ * files, those not used lately are evicted.
+ *
+ * 'mem' must be thread-safe (as null is),
+ * as every serving thread allocates through it.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error https_statics_init(
+	https_static *self, 
+	const char *root, 
+	const char *prefix, 
+	https_static_option option, 
+	const allocator *mem);
+
+/*
+ * Frees static directory, closing 
+ * every cached descriptor.
+ *
+ * Must only be called once no 
+ * request is being served by it.
+ *
+ * #to-review
+ */
+void https_statics_free(https_static *self);
+
+
+/* https_metrics */
+
+/* buckets grow by half-powers of two, from 1.5us to 51.5s, then +Inf */
+#define https_histogram_buckets 52
+
+typedef enum https_phase {
+	https_parse_phase,
+	https_handler_phase,
+	https_send_phase,
+	https_private_phase,
+} https_phase;
+
+typedef struct https_histogram {
+	size_t buckets[https_histogram_buckets];
+	size_t count;
+	/* nanoseconds */
+	size_t sum;
+} https_histogram;
+
+struct https_route_metrics {
+	string location;
+	size_t requests;
+	/* by status class (1xx to 5xx), 0 is unknown */
+	size_t statuses[6];
+	https_histogram phases[https_private_phase];
+};
+
+/*
+ * Metrics of a server, updated without locks 
+ * as requests are handled.
+ *
+ * Should be zeroed and pushed with 
+ * router_vecs_push_metrics before serving.
+ */
+struct https_metrics {
+	https_route_metrics *routes;
+	size_t routes_size;
+	/* requests no route matched */
+	https_route_metrics unrouted;
+	size_t accepted;
+	size_t in_flight;
+};
+
+/*
+ * Sends metrics passed as 'param' in 
+ * prometheus' text format.
+ *
+ * #thread-safe #to-review
+ */
+void https_send_metrics(
+	byte_map *request, 
+	int client_connection, 
+	void *param, 
+	const allocator *mem);
+
+
 /* https */
 
 static const byte_vec https_default_head = 
 	byte_vecs_premake("HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n");
 
+/* bytes an arena of a connection starts with */
+#ifndef https_arena_size
+#define https_arena_size 16384
+#endif
+
+/* arenas kept to be reused by later connections */
+#ifndef https_arena_pool_size
+#define https_arena_pool_size 64
+#endif
+
 /*
  * Serves a web-server to port 
  * with list of router callbacks 
  * provided.
  *
+ * Each connection gets an arena from a pool, 
+ * holding its request and what handlers 
+ * allocate, while 'mem' holds what lasts 
+ * as long as the server.
+ *
  * #allocates #to-review
  */
 http_error https_serve(short port, router_vec *callbacks, const allocator *mem);
@@ -152,7 +415,27 @@ http_error https_serve(short port, router_vec *callbacks, const allocator *mem);
  * #to-review
  */
 void https_send_not_found(
-	byte_map *request, int client_connection, void *param);
+	byte_map *request, 
+	int client_connection, 
+	void *param, 
+	const allocator *mem);
+
+/*
+ * Sends file requested under the 
+ * https_static passed as 'param' 
+ * using sendfile.
+ *
+ * Answers 'If-None-Match' and 
+ * 'If-Modified-Since' with 304 and 
+ * single 'Range' requests with 206.
+ *
+ * #thread-safe #to-review
+ */
+void https_send_static(
+	byte_map *request, 
+	int client_connection, 
+	void *param, 
+	const allocator *mem);
 
 /*
  * Sends body and head to client. 
@@ -484,6 +484,8 @@ estring_map jsons_unmake(const string *json, const allocator *mem) {
 		errors_abort("json", strings_check_extra(json));
 	#endif
 
+	traces_scope("jsons_unmake");
+
 	//json should be trimmed
 	bool is_object = json->data[0] == '{' && json->data[json->size - 2] == '}';
 	if (is_object) {
@@ -503,82 +505,55 @@ estring jsons_make(const string_map *self, const allocator *mem) {
 		errors_abort("self", binodes_check((const binode *)self));
 	#endif
 
-	string json = strings_make("{", mem);
-	error error = ok;
+	string_builder json = {0};
+	error init_error = string_builders_init(&json, string_small_size, mem);
+	if (init_error) { goto cleanup0; }
+
+	error push_error = string_builders_push_char(&json, '{', mem);
+	if (push_error) { goto cleanup0; }
 
 	string_map_iterator it = {0};
 	while (bitrees_next(self, &it)) {
-		bool push_error = strings_push_with(&json, "\"", mem);
-		if (push_error) {
-			error = fail;
-			break;
+		if (json.size > 1) {
+			push_error = string_builders_push_char(&json, ',', mem);
+			if (push_error) { goto cleanup0; }
 		}
 
-		push_error = strings_push(&json, it.data->data.key, mem);
-		if (push_error) {
-			error = fail;
-			break;
-		}
+		push_error = string_builders_push_char(&json, '"', mem);
+		if (push_error) { goto cleanup0; }
 
-		push_error = strings_push_with(&json, "\"", mem);
-		if (push_error) {
-			error = fail;
-			break;
-		}
+		push_error = string_builders_push(&json, &it.data->data.key, mem);
+		if (push_error) { goto cleanup0; }
 
-		push_error = strings_push_with(&json, ":", mem);
-		if (push_error) {
-			error = fail;
-			break;
-		}
+		push_error = string_builders_push_with(&json, "\":", mem);
+		if (push_error) { goto cleanup0; }
 
 		char value_start_char = it.data->data.value.data[0];
 		bool is_value_text = value_start_char != '[' && value_start_char != '{';
 
 		if (is_value_text) {
-			push_error = strings_push_with(&json, "\"", mem);
-			if (push_error) {
-				error = fail;
-				break;
-			}
-
-			push_error = strings_push(&json, it.data->data.value, mem);
-			if (push_error) {
-				error = fail;
-				break;
-			}
-
-			push_error = strings_push_with(&json, "\"", mem);
-			if (push_error) {
-				error = fail;
-				break;
-			}
-		} else {
-			push_error = strings_push(&json, it.data->data.value, mem);
-			if (push_error) {
-				error = fail;
-				break;
-			}
+			push_error = string_builders_push_char(&json, '"', mem);
+			if (push_error) { goto cleanup0; }
 		}
 
-		push_error = strings_push_with(&json, ",", mem);
-		if (push_error) {
-				error = fail;
-				break;
+		push_error = string_builders_push(&json, &it.data->data.value, mem);
+		if (push_error) { goto cleanup0; }
+
+		if (is_value_text) {
+			push_error = string_builders_push_char(&json, '"', mem);
+			if (push_error) { goto cleanup0; }
 		}
 	}
 
-	if (error) { goto cleanup0; }
-
-	bool pop_error = strings_pop(&json, mem);
-	if (pop_error) { goto cleanup0; }
-
-	bool push_error = strings_push_with(&json, "}", mem);
+	push_error = string_builders_push_char(&json, '}', mem);
 	if (push_error) { goto cleanup0; }
 
-	return (estring){.value=json};
+	string taken = string_builders_take(&json, mem);
+	if (!taken.data) { goto cleanup0; }
+
+	return (estring){.value=taken};
 
 	cleanup0:
-	strings_free(&json, mem);
+	string_builders_free(&json, mem);
 	return (estring){.error=json_invalid_error};
 }
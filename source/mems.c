@@ -33,6 +33,8 @@ typedef struct arena {
 	fat_pointer hole;
 	void *data;
 	struct arena *next;
+	/* block being bumped, kept by the first */
+	struct arena *current;
 } arena;
 
 bool arenas_check(const arena *self) {
@@ -61,6 +63,7 @@ void *arenas_init_helper(size_t capacity) {
 	arena *self_capsule = malloc(sizeof(arena));
 	errors_abort("self_capsule", !self_capsule);
 	*self_capsule = self;
+	self_capsule->current = self_capsule;
 
 	return self_capsule;
 }
@@ -72,47 +75,43 @@ void *arenas_allocate(arena *self, size_t size) {
 
 	if (size == 0) { return null; }
 
-	arena *next = self;
-	size_t standard_capacity = self->capacity;
-
-	while (true) {
-		if (next->hole.position && next->hole.size >= size) {
-			void *old_pos = next->hole.position;
+	arena *current = self->current;
+	fat_pointer *hole = &current->hole;
 
-			next->hole.position = (char *)next->hole.position + size;
-			next->hole.size -= size;
+	if (hole->position && hole->size >= size) {
+		void *old_pos = hole->position;
 
-			if (next->hole.size == 0) {
-				next->hole.position = null;
-			}
+		hole->position = (char *)hole->position + size;
+		hole->size -= size;
 
-			return old_pos;
+		if (hole->size == 0) {
+			hole->position = null;
 		}
 
-		size_t space_left = next->capacity - next->size;
-		if (space_left >= size) {
-			void *old_pos = (char *)next->data + next->size;
-
-			next->size += size;
-			return old_pos;
-		} 
+		return old_pos;
+	}
 
-		if (!next->next) {
-			break;
+	/* blocks past current are empty, kept by a rewind */
+	arena *next = current->next;
+	if (current->capacity - current->size < size) {
+		if (!next || next->capacity < size) {
+			size_t standard_capacity = self->capacity;
+			size_t new_capacity = size > standard_capacity ? 
+				maths_nearest_two_power(size) : standard_capacity;
+
+			next = arenas_init_helper(new_capacity);
+			next->next = current->next;
+			current->next = next;
 		}
 
-		next = next->next;
+		current = next;
+		self->current = current;
 	}
 
-	if (size > standard_capacity) {
-		size_t new_capacity = maths_nearest_two_power(size);
-		next->next = arenas_init_helper(new_capacity);
-	} else {
-		next->next = arenas_init_helper(standard_capacity);
-	}
+	void *old_pos = (char *)current->data + current->size;
+	current->size += size;
 
-	next->next->size += size;
-	return next->next->data;
+	return old_pos;
 }
 
 void arenas_debug(arena *self);
@@ -127,8 +126,8 @@ error arenas_deallocate(arena *self, void *block, size_t block_size) {
 	arena *blockin = self;
 	while ((blockin)) {
 		bool is_within = 
-			block >= self->data && 
-			block < (void *)((char *)self->data + self->size);
+			block >= blockin->data && 
+			block < (void *)((char *)blockin->data + blockin->size);
 
 		if (is_within) {
 			found_block = true;
@@ -247,71 +246,18 @@ void *arenas_reallocate(
 		blockin->size += rest_block_size;
 
 		return blockin->data;
-	} else if (is_last && !may_fit_rest) {
-		blockin->size -= prev_block_size;
-	} else if (!is_last){
-		bool may_fit_all = rest >= new_block_size;
-		if (may_fit_all) {
-			void *new_data = (char *)blockin->data + blockin->size;
-			blockin->size += new_block_size;
-
-			memcpy(new_data, block, prev_block_size);
-			arenas_deallocate(blockin, block, prev_block_size);
-
-			return new_data;
-		} 	
 	} 
 
-	bool create_new = true;
-	arena *lastblock = self;
-	while (true) {
-		#if cels_debug
-			errors_abort("lastblock", arenas_check(lastblock));
-		#endif
-
-		size_t rest = lastblock->capacity - lastblock->size;
-		bool may_fit_all = rest >= new_block_size;
-
-		if (may_fit_all) {
-			create_new = false;
-			break;
-		}
-
-		if (!lastblock->next) {
-			break;
-		} 
-
-		lastblock = lastblock->next;
-	}
-
-	if (!create_new) {
-		void *pos = (char *)lastblock->data + lastblock->size;
-
-		memcpy(pos, block, prev_block_size + 1);
-		arenas_deallocate(blockin, block, prev_block_size);
-		lastblock->size += new_block_size;
-
-		return pos;
-	}
-
-	size_t standard_capacity = blockin->capacity;
-
-	if (new_block_size <= standard_capacity) {
-		lastblock->next = arenas_init_helper(standard_capacity);
-	} else {
-		size_t new_capacity = maths_nearest_two_power(new_block_size);
-		lastblock->next = arenas_init_helper(new_capacity);
-	}
+	void *new_data = arenas_allocate(self, new_block_size);
+	if (!new_data) { return null; }
 
-	if (lastblock->next == null) {
-		return null;
-	}
+	size_t size = prev_block_size < new_block_size ? 
+		prev_block_size : new_block_size;
 
-	memcpy(lastblock->next->data, block, prev_block_size);
+	memcpy(new_data, block, size);
 	arenas_deallocate(blockin, block, prev_block_size);
 
-	lastblock->next->size += new_block_size;
-	return lastblock->next->data;
+	return new_data;
 }
 
 void arenas_debug(arena *self) {
@@ -361,6 +307,80 @@ void arenas_free(arena *self) {
 	free(self);
 }
 
+typedef struct virtual_arena virtual_arena;
+
+void *virtual_arenas_allocate(virtual_arena *self, size_t size);
+void virtual_arenas_rewind_private(
+	virtual_arena *self, size_t size, bool is_releasing);
+
+size_t virtual_arenas_size_private(const virtual_arena *self);
+
+arena_mark arenas_mark(const allocator *mem) {
+	#if cels_debug
+		errors_abort("mem", !mem);
+	#endif
+
+	if (mem->alloc == (allocfunc)virtual_arenas_allocate) {
+		return (arena_mark){.size=virtual_arenas_size_private(mem->storage)};
+	}
+
+	#if cels_debug
+		errors_abort("mem", mem->alloc != (allocfunc)arenas_allocate);
+	#endif
+
+	arena *self = mem->storage;
+	arena *current = self->current;
+
+	return (arena_mark){
+		.block=current,
+		.size=current->size,
+		.hole=current->hole.position,
+		.hole_size=current->hole.size,
+	};
+}
+
+void arenas_rewind(const allocator *mem, arena_mark mark, bool is_releasing) {
+	#if cels_debug
+		errors_abort("mem", !mem);
+	#endif
+
+	if (mem->alloc == (allocfunc)virtual_arenas_allocate) {
+		virtual_arenas_rewind_private(mem->storage, mark.size, is_releasing);
+		return;
+	}
+
+	#if cels_debug
+		errors_abort("mem", mem->alloc != (allocfunc)arenas_allocate);
+		errors_abort("mark.block", !mark.block);
+	#endif
+
+	arena *self = mem->storage;
+	arena *current = mark.block;
+
+	current->size = mark.size;
+	current->hole = (fat_pointer){.position=mark.hole, .size=mark.hole_size};
+	self->current = current;
+
+	arena *next = current->next;
+	if (is_releasing) {
+		current->next = null;
+	}
+
+	while (next) {
+		arena *following = next->next;
+
+		if (is_releasing) {
+			free(next->data);
+			free(next);
+		} else {
+			next->size = 0;
+			next->hole = (fat_pointer){0};
+		}
+
+		next = following;
+	}
+}
+
 allocator arenas_init(size_t capacity) {
 	arena *new_arena = arenas_init_helper(capacity);
 
@@ -376,6 +396,259 @@ allocator arenas_init(size_t capacity) {
 }
 
 
+/* virtual_arenas */
+
+/* alignment of any scalar, as c99 lacks max_align_t */
+typedef union mems_alignment_private {
+	long double number;
+	long long integer;
+	void *pointer;
+	void (*function)(void);
+} mems_alignment_private;
+
+/* lives at the start of its own reservation */
+struct virtual_arena {
+	size_t size;
+	size_t committed;
+	size_t capacity;
+	size_t commit_size;
+	size_t page_size;
+};
+
+static inline size_t mems_round_private(size_t size, size_t alignment) {
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t virtual_arenas_size_private(const virtual_arena *self) {
+	return self->size;
+}
+
+/*
+ * Commits pages until 'size' 
+ * bytes of self are usable.
+ */
+error virtual_arenas_commit_private(virtual_arena *self, size_t size) {
+	if (size <= self->committed) { return ok; }
+	if (size > self->capacity) { return fail; }
+
+	size_t committed = mems_round_private(size, self->commit_size);
+	if (committed > self->capacity) {
+		committed = self->capacity;
+	}
+
+	char *start = (char *)self + self->committed;
+	size_t length = committed - self->committed;
+
+	if (mprotect(start, length, PROT_READ | PROT_WRITE)) { return fail; }
+
+	self->committed = committed;
+	return ok;
+}
+
+void *virtual_arenas_allocate(virtual_arena *self, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (size == 0) { return null; }
+
+	size_t position = mems_round_private(self->size, sizeof(mems_alignment_private));
+	if (size > self->capacity - position) { return null; }
+
+	error commit_error = virtual_arenas_commit_private(self, position + size);
+	if (commit_error) { return null; }
+
+	self->size = position + size;
+	return (char *)self + position;
+}
+
+error virtual_arenas_deallocate(virtual_arena *self, void *block, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("block", !block);
+	#endif
+
+	char *start = (char *)self + sizeof(virtual_arena);
+	char *end = (char *)self + self->size;
+
+	bool is_within = (char *)block >= start && (char *)block < end;
+	if (!is_within) { return fail; }
+
+	if ((char *)block + size == end) {
+		self->size = (char *)block - (char *)self;
+	}
+
+	return ok;
+}
+
+void *virtual_arenas_reallocate(
+	virtual_arena *self, void *block, size_t prev_size, size_t new_size) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (!block) { 
+		return virtual_arenas_allocate(self, new_size); 
+	}
+
+	size_t position = (char *)block - (char *)self;
+	bool is_last = position + prev_size == self->size;
+
+	if (is_last && new_size <= self->capacity - position) {
+		error commit_error = 
+			virtual_arenas_commit_private(self, position + new_size);
+
+		if (commit_error) { return null; }
+
+		self->size = position + new_size;
+		return block;
+	}
+
+	void *new_data = virtual_arenas_allocate(self, new_size);
+	if (!new_data) { return null; }
+
+	memcpy(new_data, block, prev_size < new_size ? prev_size : new_size);
+	return new_data;
+}
+
+/*
+ * Drops allocations past 'size', giving 
+ * their pages back if 'is_releasing'.
+ */
+void virtual_arenas_rewind_private(
+	virtual_arena *self, size_t size, bool is_releasing) {
+
+	#if cels_debug
+		errors_abort("size", size > self->size || size < sizeof(virtual_arena));
+	#endif
+
+	self->size = size;
+	if (!is_releasing) { return; }
+
+	size_t kept = mems_round_private(size, self->page_size);
+	if (kept < self->committed) {
+		madvise((char *)self + kept, self->committed - kept, MADV_DONTNEED);
+	}
+}
+
+void virtual_arenas_debug(virtual_arena *self) {
+	printf(
+		"<virtual_arena>{.size: %zu, .committed: %zu, .capacity: %zu}\n",
+		self->size,
+		self->committed,
+		self->capacity);
+}
+
+void virtual_arenas_free(virtual_arena *self) {
+	munmap(self, self->capacity);
+}
+
+allocator virtual_arenas_init(size_t capacity, virtual_arena_option option) {
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t commit_size = virtual_arena_commit_size;
+
+	#ifdef MADV_HUGEPAGE
+		if (option.is_huge) {
+			commit_size = 2 * 1024 * 1024;
+		}
+	#endif
+
+	commit_size = mems_round_private(commit_size, page_size);
+	capacity = mems_round_private(capacity + sizeof(virtual_arena), commit_size);
+
+	/* huge-pages need an aligned start, so a commit more is reserved */
+	size_t reserved = capacity + (option.is_huge ? commit_size : 0);
+	char *data = mmap(
+		null, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (data == MAP_FAILED) {
+		return (allocator){.type=allocators_group_type, .error=fail};
+	}
+
+	if (option.is_huge) {
+		char *start = (char *)mems_round_private((uintptr_t)data, commit_size);
+		size_t head = start - data;
+
+		if (head) { munmap(data, head); }
+		munmap(start + capacity, reserved - head - capacity);
+		data = start;
+
+		#ifdef MADV_HUGEPAGE
+			madvise(data, capacity, MADV_HUGEPAGE);
+		#endif
+	}
+
+	if (mprotect(data, commit_size, PROT_READ | PROT_WRITE)) {
+		munmap(data, capacity);
+		return (allocator){.type=allocators_group_type, .error=fail};
+	}
+
+	virtual_arena *self = (virtual_arena *)data;
+	*self = (virtual_arena){
+		.size=sizeof(virtual_arena),
+		.committed=commit_size,
+		.capacity=capacity,
+		.commit_size=commit_size,
+		.page_size=page_size,
+	};
+
+	return (allocator) {
+		.type=allocators_group_type,
+		.storage=self,
+		.alloc=(allocfunc)virtual_arenas_allocate,
+		.dealloc=(deallocfunc)virtual_arenas_deallocate,
+		.realloc=(reallocfunc)virtual_arenas_reallocate,
+		.free=(cleanfunc)virtual_arenas_free,
+		.debug=(debugfunc)virtual_arenas_debug
+	};
+}
+
+void virtual_arenas_reset(const allocator *mem) {
+	#if cels_debug
+		errors_abort("mem", !mem);
+		errors_abort("mem", mem->alloc != (allocfunc)virtual_arenas_allocate);
+	#endif
+
+	virtual_arenas_rewind_private(mem->storage, sizeof(virtual_arena), true);
+}
+
+
+/* arena_scratches */
+
+static __thread allocator arena_scratches_arena = {0};
+
+arena_scratch arena_scratches_init(const allocator *mem) {
+	if (!mem) {
+		if (!arena_scratches_arena.storage) {
+			arena_scratches_arena = arenas_init(arena_scratch_size);
+		}
+
+		mem = &arena_scratches_arena;
+	}
+
+	return (arena_scratch){.mem=mem, .mark=arenas_mark(mem)};
+}
+
+void arena_scratches_free(arena_scratch *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (!self->mem) { return; }
+
+	arenas_rewind(self->mem, self->mark, false);
+	self->mem = null;
+}
+
+void arena_scratches_release(void) {
+	if (!arena_scratches_arena.storage) { return; }
+
+	arenas_free(arena_scratches_arena.storage);
+	arena_scratches_arena = (allocator){0};
+}
+
+
 /* stack_arenas */
 
 typedef struct stack_arena {
@@ -383,25 +656,31 @@ typedef struct stack_arena {
 	size_t capacity;
 	fat_pointer hole;
 	void *data;
+	/* heap arena taking what didn't fit, made on demand */
+	arena *spill;
 } stack_arena;
 
 /* TODO stack_arena_checks */
 
-void *stack_arenas_allocate(stack_arena *self, size_t size) {
-	if (size > self->capacity) { 
-		#if cels_debug
-			errors_print(
-				errors_error_mode, 
-				"stack_arenas_allocate.(size > self->capacity) "
-				"(%zu more than total - %zu)", 
-				self->capacity - size, 
-				self->capacity);
-		#endif
+bool stack_arenas_is_within_private(stack_arena *self, void *block) {
+	return 
+		(char *)block >= (char *)self->data && 
+		(char *)block < (char *)self->data + self->size;
+}
 
-		return null; 
+void *stack_arenas_spill_private(stack_arena *self, size_t size) {
+	if (!self->spill) {
+		size_t capacity = size > self->capacity ? size : self->capacity;
+		self->spill = arenas_init_helper(capacity);
 	}
 
-	size_t fit_in_hole = self->hole.position || self->hole.size >= size;
+	return arenas_allocate(self->spill, size);
+}
+
+void *stack_arenas_allocate(stack_arena *self, size_t size) {
+	if (size == 0) { return null; }
+
+	bool fit_in_hole = self->hole.position && self->hole.size >= size;
 	if (fit_in_hole) {
 		void *old_pos = self->hole.position;
 
@@ -423,15 +702,7 @@ void *stack_arenas_allocate(stack_arena *self, size_t size) {
 		return old_pos;
 	} 
 
-	#if cels_debug
-		errors_print(
-			errors_error_mode, 
-			"stack_arenas_allocate.(size > self->capacity - self->size) "
-			"(%zu more than available space)", 
-			size - (self->capacity - self->size));
-	#endif
-
-	return null;
+	return stack_arenas_spill_private(self, size);
 }
 
 error stack_arenas_deallocate(
@@ -441,12 +712,10 @@ error stack_arenas_deallocate(
 		return fail; 
 	}
 
-	bool is_out = 
-		block < self->data || block >= 
-		(void *)((char *)self->data + self->size);
+	if (!stack_arenas_is_within_private(self, block)) { 
+		if (!self->spill) { return fail; }
 
-	if (is_out) { 
-		return fail; 
+		return arenas_deallocate(self->spill, block, block_size);
 	} 
 
 	bool is_last = 
@@ -499,39 +768,28 @@ void *stack_arenas_reallocate(
 		return stack_arenas_allocate(self, new_size);
 	}
 
-	bool is_out = 
-		self->data >= block || 
-		block >= (void *)((char *)self->data + self->size);
+	if (!stack_arenas_is_within_private(self, block)) { 
+		if (!self->spill) { return null; }
 
-	if (is_out) { 
-		return null; 
+		return arenas_reallocate(self->spill, block, prev_size, new_size);
 	}
 
-	size_t rest = self->capacity - self->size;
-	long rest_block_size = new_size - prev_size;
-
 	bool is_last = (char *)self->data + self->size == (char *)block + prev_size;
-	bool may_fit_rest = (long)rest >= rest_block_size;
-	bool may_fit_all = rest >= new_size;
+	size_t rest = self->capacity - self->size + prev_size;
 
-	if (is_last && may_fit_rest) {
-		self->size += rest_block_size;
+	if (is_last && new_size <= rest) {
+		self->size = self->size - prev_size + new_size;
 		return block;
-	} else if (is_last && !may_fit_rest) {
-		return null;
-	} else if (!is_last) {
-		stack_arenas_deallocate(self, block, prev_size);
+	}
 
-		if (may_fit_all) {
-			void *new_data = (char *)self->data + self->size;
-			self->size += new_size;
-			memcpy(new_data, block, prev_size);
+	/* moving out of the stack, maybe to the spill */
+	void *new_data = stack_arenas_allocate(self, new_size);
+	if (!new_data) { return null; }
 
-			return new_data;
-		}
-	} 
+	memcpy(new_data, block, prev_size < new_size ? prev_size : new_size);
+	stack_arenas_deallocate(self, block, prev_size);
 
-	return null;
+	return new_data;
 }
 
 void stack_arenas_debug(stack_arena *self) {
@@ -560,21 +818,35 @@ void stack_arenas_debug(stack_arena *self) {
 	}
 
 	printf("\n");
+
+	if (self->spill) {
+		arenas_debug(self->spill);
+	}
 }
 
 void stack_arenas_free(stack_arena *self) {
-	free(self);
+	if (!self->spill) { return; }
+
+	arenas_free(self->spill);
+	self->spill = null;
 }
 
 allocator stack_arenas_init_helper(size_t capacity, char *buffer) {
-	stack_arena new_arena = (stack_arena){.capacity=capacity, .data=buffer};
-	stack_arena *capsule = malloc(sizeof(stack_arena));
-	errors_abort("capsule", !capsule);
-	*capsule = new_arena;
+	#if cels_debug
+		errors_abort("buffer", !buffer);
+		errors_abort(
+			"stack_arena_header_size", 
+			sizeof(stack_arena) > stack_arena_header_size);
+	#endif
+
+	stack_arena *self = (stack_arena *)buffer;
+	*self = (stack_arena){
+		.capacity=capacity, 
+		.data=buffer + stack_arena_header_size};
 
 	return (allocator) {
 		.type=allocators_group_type,
-		.storage=capsule,
+		.storage=self,
 		.alloc=(allocfunc)stack_arenas_allocate,
 		.dealloc=(deallocfunc)stack_arenas_deallocate,
 		.realloc=(reallocfunc)stack_arenas_reallocate,
@@ -583,6 +855,382 @@ allocator stack_arenas_init_helper(size_t capacity, char *buffer) {
 	};
 }
 
+void stack_arenas_close_private(allocator *mem) {
+	stack_arenas_free(mem->storage);
+}
+
+
+/* tlsfs */
+
+/* blocks are aligned to 16 bytes */
+#define tlsf_align_log 4
+#define tlsf_second_log 5
+#define tlsf_second_count (1 << tlsf_second_log)
+#define tlsf_first_shift (tlsf_second_log + tlsf_align_log)
+#define tlsf_first_count 40
+#define tlsf_small_size ((size_t)1 << tlsf_first_shift)
+#define tlsf_size_maximum ((size_t)1 << 46)
+
+typedef struct tlsf_block tlsf_block;
+
+struct tlsf_block {
+	/* physically previous block, null on the first of a region */
+	tlsf_block *previous;
+	/* bytes of data, the lowest bit is set while it's free */
+	size_t size;
+	/* links of its free-list, overlapping data while it's free */
+	tlsf_block *next_free;
+	tlsf_block *previous_free;
+};
+
+#define tlsf_block_header offsetof(tlsf_block, next_free)
+
+typedef struct tlsf_region tlsf_region;
+
+struct tlsf_region {
+	tlsf_region *next;
+	size_t size;
+};
+
+typedef struct tlsf {
+	size_t capacity;
+	/* bit i is set if 'second_maps[i]' has any bit set */
+	size_t first_map;
+	/* bit j is set if 'blocks[i][j]' isn't empty */
+	uint32_t second_maps[tlsf_first_count];
+	tlsf_block *blocks[tlsf_first_count][tlsf_second_count];
+	tlsf_region *regions;
+} tlsf;
+
+static inline size_t tlsf_blocks_size_private(const tlsf_block *self) {
+	return self->size & ~(size_t)1;
+}
+
+static inline bool tlsf_blocks_is_free_private(const tlsf_block *self) {
+	return self->size & 1;
+}
+
+static inline tlsf_block *tlsf_blocks_next_private(const tlsf_block *self) {
+	return (tlsf_block *)
+		((char *)self + tlsf_block_header + tlsf_blocks_size_private(self));
+}
+
+static inline size_t tlsfs_last_bit_private(size_t size) {
+	return sizeof(size_t) * 8 - 1 - __builtin_clzl(size);
+}
+
+/*
+ * Rounds 'size' up to the alignment, 
+ * leaving room for the free-list links.
+ */
+static inline size_t tlsfs_adjust_private(size_t size) {
+	size = mems_round_private(size, (size_t)1 << tlsf_align_log);
+	return size < 2 * sizeof(tlsf_block *) ? 2 * sizeof(tlsf_block *) : size;
+}
+
+/*
+ * Rounds 'size' up to the next class, so 
+ * any block listed there is big enough.
+ */
+static inline size_t tlsfs_round_private(size_t size) {
+	if (size < tlsf_small_size) { return size; }
+
+	size_t round = 
+		((size_t)1 << (tlsfs_last_bit_private(size) - tlsf_second_log)) - 1;
+
+	return (size + round) & ~round;
+}
+
+void tlsfs_map_private(size_t size, size_t *first, size_t *second) {
+	if (size < tlsf_small_size) {
+		*first = 0;
+		*second = size / (tlsf_small_size / tlsf_second_count);
+		return;
+	}
+
+	size_t last = tlsfs_last_bit_private(size);
+
+	*first = last - (tlsf_first_shift - 1);
+	*second = (size >> (last - tlsf_second_log)) ^ tlsf_second_count;
+}
+
+void tlsfs_insert_private(tlsf *self, tlsf_block *block) {
+	size_t first = 0;
+	size_t second = 0;
+	tlsfs_map_private(tlsf_blocks_size_private(block), &first, &second);
+
+	tlsf_block *head = self->blocks[first][second];
+
+	block->next_free = head;
+	block->previous_free = null;
+
+	if (head) {
+		head->previous_free = block;
+	}
+
+	self->blocks[first][second] = block;
+	self->first_map |= (size_t)1 << first;
+	self->second_maps[first] |= (uint32_t)1 << second;
+}
+
+void tlsfs_remove_private(tlsf *self, tlsf_block *block) {
+	size_t first = 0;
+	size_t second = 0;
+	tlsfs_map_private(tlsf_blocks_size_private(block), &first, &second);
+
+	if (block->next_free) {
+		block->next_free->previous_free = block->previous_free;
+	}
+
+	if (block->previous_free) {
+		block->previous_free->next_free = block->next_free;
+		return;
+	}
+
+	self->blocks[first][second] = block->next_free;
+	if (block->next_free) { return; }
+
+	self->second_maps[first] &= ~((uint32_t)1 << second);
+	if (!self->second_maps[first]) {
+		self->first_map &= ~((size_t)1 << first);
+	}
+}
+
+/*
+ * Finds a free block of at least 'size' 
+ * by the first set bits of the maps.
+ */
+tlsf_block *tlsfs_find_private(tlsf *self, size_t size) {
+	size_t first = 0;
+	size_t second = 0;
+	tlsfs_map_private(tlsfs_round_private(size), &first, &second);
+
+	size_t second_map = self->second_maps[first] & (~(size_t)0 << second);
+	if (!second_map) {
+		size_t first_map = self->first_map & (~(size_t)0 << (first + 1));
+		if (!first_map) { return null; }
+
+		first = __builtin_ctzl(first_map);
+		second_map = self->second_maps[first];
+	}
+
+	second = __builtin_ctzl(second_map);
+	return self->blocks[first][second];
+}
+
+/*
+ * Marks 'block' as free, merging it 
+ * with its neighbours if they are.
+ */
+void tlsfs_release_private(tlsf *self, tlsf_block *block) {
+	block->size |= 1;
+
+	tlsf_block *previous = block->previous;
+	if (previous && tlsf_blocks_is_free_private(previous)) {
+		tlsfs_remove_private(self, previous);
+		previous->size += tlsf_block_header + tlsf_blocks_size_private(block);
+		block = previous;
+	}
+
+	tlsf_block *next = tlsf_blocks_next_private(block);
+	if (tlsf_blocks_is_free_private(next)) {
+		tlsfs_remove_private(self, next);
+		block->size += tlsf_block_header + tlsf_blocks_size_private(next);
+	}
+
+	tlsf_blocks_next_private(block)->previous = block;
+	tlsfs_insert_private(self, block);
+}
+
+/*
+ * Trims used 'block' to 'size', 
+ * freeing the rest if it fits a block.
+ */
+void tlsfs_split_private(tlsf *self, tlsf_block *block, size_t size) {
+	size_t block_size = tlsf_blocks_size_private(block);
+	if (block_size - size < sizeof(tlsf_block)) { return; }
+
+	tlsf_block *rest = (tlsf_block *)((char *)block + tlsf_block_header + size);
+	rest->previous = block;
+	rest->size = block_size - size - tlsf_block_header;
+
+	block->size = size;
+	tlsfs_release_private(self, rest);
+}
+
+/*
+ * Adds a region with a free block 
+ * of at least 'size', ended by an 
+ * used block of no size.
+ */
+error tlsfs_grow_private(tlsf *self, size_t size) {
+	size_t overhead = sizeof(tlsf_region) + 2 * tlsf_block_header;
+	size_t needed = tlsfs_round_private(size) + overhead;
+	size_t region_size = needed > self->capacity ? 
+		maths_nearest_two_power(needed) : self->capacity;
+
+	tlsf_region *region = malloc(region_size);
+	if (!region) { return fail; }
+
+	*region = (tlsf_region){.next=self->regions, .size=region_size};
+	self->regions = region;
+
+	tlsf_block *block = (tlsf_block *)(region + 1);
+	block->previous = null;
+	block->size = (region_size - overhead) | 1;
+
+	tlsf_block *end = tlsf_blocks_next_private(block);
+	end->previous = block;
+	end->size = 0;
+
+	tlsfs_insert_private(self, block);
+	return ok;
+}
+
+void *tlsfs_allocate(tlsf *self, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (size == 0 || size > tlsf_size_maximum) { return null; }
+	size = tlsfs_adjust_private(size);
+
+	tlsf_block *block = tlsfs_find_private(self, size);
+	if (!block) {
+		error grow_error = tlsfs_grow_private(self, size);
+		if (grow_error) { return null; }
+
+		block = tlsfs_find_private(self, size);
+	}
+
+	tlsfs_remove_private(self, block);
+	block->size &= ~(size_t)1;
+	tlsfs_split_private(self, block, size);
+
+	return (char *)block + tlsf_block_header;
+}
+
+error tlsfs_deallocate(tlsf *self, void *data, notused size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (!data) { return fail; }
+
+	tlsf_block *block = (tlsf_block *)((char *)data - tlsf_block_header);
+
+	#if cels_debug
+		errors_abort("block (freed twice)", tlsf_blocks_is_free_private(block));
+	#endif
+
+	tlsfs_release_private(self, block);
+	return ok;
+}
+
+void *tlsfs_reallocate(
+	tlsf *self, void *data, size_t prev_size, size_t new_size) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (!data) {
+		return tlsfs_allocate(self, new_size);
+	}
+
+	if (new_size == 0 || new_size > tlsf_size_maximum) { return null; }
+
+	tlsf_block *block = (tlsf_block *)((char *)data - tlsf_block_header);
+	size_t block_size = tlsf_blocks_size_private(block);
+	size_t size = tlsfs_adjust_private(new_size);
+
+	/* growing in place over a free neighbour */
+	tlsf_block *next = tlsf_blocks_next_private(block);
+	size_t room = block_size;
+	if (tlsf_blocks_is_free_private(next)) {
+		room += tlsf_block_header + tlsf_blocks_size_private(next);
+	}
+
+	if (room >= size) {
+		if (block_size < size) {
+			tlsfs_remove_private(self, next);
+			block->size = room;
+			tlsf_blocks_next_private(block)->previous = block;
+		}
+
+		tlsfs_split_private(self, block, size);
+		return data;
+	}
+
+	void *new_data = tlsfs_allocate(self, new_size);
+	if (!new_data) { return null; }
+
+	size_t kept = prev_size < block_size ? prev_size : block_size;
+	memcpy(new_data, data, kept < new_size ? kept : new_size);
+	tlsfs_release_private(self, block);
+
+	return new_data;
+}
+
+void tlsfs_debug(tlsf *self) {
+	size_t regions = 0;
+	size_t used = 0;
+	size_t available = 0;
+
+	for (tlsf_region *region = self->regions; region; region = region->next) {
+		tlsf_block *block = (tlsf_block *)(region + 1);
+
+		/* the region's end is the only block without size */
+		while (tlsf_blocks_size_private(block)) {
+			if (tlsf_blocks_is_free_private(block)) {
+				available += tlsf_blocks_size_private(block);
+			} else {
+				used += tlsf_blocks_size_private(block);
+			}
+
+			block = tlsf_blocks_next_private(block);
+		}
+
+		regions++;
+	}
+
+	printf(
+		"<tlsf>{.regions: %zu, .used: %zu, .free: %zu}\n", 
+		regions, 
+		used, 
+		available);
+}
+
+void tlsfs_free(tlsf *self) {
+	tlsf_region *region = self->regions;
+
+	while (region) {
+		tlsf_region *next = region->next;
+		free(region);
+		region = next;
+	}
+
+	free(self);
+}
+
+allocator tlsfs_init(size_t capacity) {
+	tlsf *self = malloc(sizeof(tlsf));
+	errors_abort("self", !self);
+
+	*self = (tlsf){
+		.capacity=mems_round_private(capacity, (size_t)1 << tlsf_align_log)};
+
+	return (allocator) {
+		.type=allocators_group_type,
+		.storage=self,
+		.alloc=(allocfunc)tlsfs_allocate,
+		.dealloc=(deallocfunc)tlsfs_deallocate,
+		.realloc=(reallocfunc)tlsfs_reallocate,
+		.free=(cleanfunc)tlsfs_free,
+		.debug=(debugfunc)tlsfs_debug
+	};
+}
+
 
 /* allocs */
 
@@ -611,6 +1259,296 @@ allocator allocs_init(void) {
 }
 
 
+/* trackers */
+
+static bool trackers_is_enabled = true;
+static tracker *trackers_registry = null;
+static bool trackers_lock = false;
+
+void trackers_lock_private(void) {
+	while (__atomic_test_and_set(&trackers_lock, __ATOMIC_ACQUIRE)) {}
+}
+
+void trackers_unlock_private(void) {
+	__atomic_clear(&trackers_lock, __ATOMIC_RELEASE);
+}
+
+void trackers_add_private(size_t *counter, size_t value) {
+	__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+size_t trackers_load_private(const size_t *counter) {
+	return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+size_t trackers_bucket_private(size_t size) {
+	size_t bucket = 0;
+	while (size > 1 && bucket < tracker_buckets - 1) {
+		size >>= 1;
+		++bucket;
+	}
+
+	return bucket;
+}
+
+void trackers_grow_private(tracker *self, size_t size) {
+	size_t in_use = __atomic_add_fetch(&self->in_use, size, __ATOMIC_RELAXED);
+	size_t peak = trackers_load_private(&self->peak);
+
+	while (in_use > peak) {
+		bool has_swapped = __atomic_compare_exchange_n(
+			&self->peak,
+			&peak,
+			in_use,
+			true,
+			__ATOMIC_RELAXED,
+			__ATOMIC_RELAXED);
+
+		if (has_swapped) { break; }
+	}
+}
+
+void trackers_shrink_private(tracker *self, size_t size) {
+	__atomic_fetch_sub(&self->in_use, size, __ATOMIC_RELAXED);
+}
+
+void *trackers_allocate(tracker *self, size_t size) {
+	void *data = mems_alloc(self->mem, size);
+	if (!__atomic_load_n(&trackers_is_enabled, __ATOMIC_RELAXED)) {
+		return data;
+	}
+
+	if (!data) {
+		trackers_add_private(&self->failures, 1);
+		return null;
+	}
+
+	trackers_add_private(&self->allocs, 1);
+	trackers_add_private(&self->total, size);
+	trackers_add_private(&self->histogram[trackers_bucket_private(size)], 1);
+	trackers_grow_private(self, size);
+
+	if (self->option.hook) {
+		self->option.hook(
+			self, tracker_alloc_event, data, size, self->option.params);
+	}
+
+	return data;
+}
+
+void *trackers_reallocate(tracker *self, void *data, size_t prev, size_t size) {
+	void *new_data = mems_realloc(self->mem, data, prev, size);
+	if (!__atomic_load_n(&trackers_is_enabled, __ATOMIC_RELAXED)) {
+		return new_data;
+	}
+
+	if (!new_data) {
+		trackers_add_private(&self->failures, 1);
+		return null;
+	}
+
+	trackers_add_private(&self->reallocs, 1);
+	trackers_add_private(&self->histogram[trackers_bucket_private(size)], 1);
+
+	if (size > prev) {
+		trackers_add_private(&self->total, size - prev);
+		trackers_grow_private(self, size - prev);
+	} else {
+		trackers_shrink_private(self, prev - size);
+	}
+
+	if (self->option.hook) {
+		self->option.hook(
+			self, tracker_realloc_event, new_data, size, self->option.params);
+	}
+
+	return new_data;
+}
+
+error trackers_deallocate(tracker *self, void *data, size_t size) {
+	if (__atomic_load_n(&trackers_is_enabled, __ATOMIC_RELAXED)) {
+		trackers_add_private(&self->deallocs, 1);
+		trackers_shrink_private(self, size);
+
+		if (self->option.hook) {
+			self->option.hook(
+				self, tracker_dealloc_event, data, size, self->option.params);
+		}
+	}
+
+	return mems_dealloc(self->mem, data, size);
+}
+
+void trackers_release(tracker *self) {
+	if (!self->mem || self->mem->type != allocators_group_type) {
+		return;
+	}
+
+	if (self->option.hook) {
+		self->option.hook(
+			self, tracker_free_event, null, self->in_use, self->option.params);
+	}
+
+	__atomic_store_n(&self->in_use, 0, __ATOMIC_RELAXED);
+	mems_free(self->mem, null);
+}
+
+void trackers_debug(tracker *self) {
+	trackers_print(self);
+
+	if (self->mem && self->mem->debug) {
+		self->mem->debug(self->mem->storage);
+	}
+}
+
+allocator trackers_init(
+	tracker *self,
+	const char *tag,
+	tracker_option option,
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("tag", !tag);
+	#endif
+
+	#if !cels_trackers
+		(void)self;
+		(void)tag;
+		(void)option;
+
+		return mem ? *mem : allocs_init();
+	#else
+	*self = (tracker){.tag=tag, .mem=mem, .option=option};
+
+	trackers_lock_private();
+	self->next = trackers_registry;
+	trackers_registry = self;
+	trackers_unlock_private();
+
+	return (allocator) {
+		.type=allocators_group_type,
+		.storage=self,
+		.alloc=(allocfunc)trackers_allocate,
+		.realloc=(reallocfunc)trackers_reallocate,
+		.dealloc=(deallocfunc)trackers_deallocate,
+		.free=(cleanfunc)trackers_release,
+		.debug=(debugfunc)trackers_debug
+	};
+	#endif
+}
+
+void trackers_enable(bool is_enabled) {
+	__atomic_store_n(&trackers_is_enabled, is_enabled, __ATOMIC_RELAXED);
+}
+
+/*
+ * Snapshots the counters of tracker
+ * adding them to 'sum'.
+ */
+void trackers_sum_private(const tracker *self, tracker *sum) {
+	sum->allocs += trackers_load_private(&self->allocs);
+	sum->reallocs += trackers_load_private(&self->reallocs);
+	sum->deallocs += trackers_load_private(&self->deallocs);
+	sum->failures += trackers_load_private(&self->failures);
+	sum->in_use += trackers_load_private(&self->in_use);
+	sum->peak += trackers_load_private(&self->peak);
+	sum->total += trackers_load_private(&self->total);
+
+	for (size_t i = 0; i < tracker_buckets; i++) {
+		sum->histogram[i] += trackers_load_private(&self->histogram[i]);
+	}
+}
+
+void trackers_print_private(const tracker *self) {
+	printf(
+		"<tracker>{.tag: \"%s\", .allocs: %zu, .reallocs: %zu, "
+		".deallocs: %zu, .failures: %zu, .in_use: %zu, .peak: %zu, "
+		".total: %zu, .histogram: {",
+		self->tag,
+		self->allocs,
+		self->reallocs,
+		self->deallocs,
+		self->failures,
+		self->in_use,
+		self->peak,
+		self->total);
+
+	bool is_first = true;
+	for (size_t i = 0; i < tracker_buckets; i++) {
+		if (self->histogram[i] == 0) { continue; }
+
+		printf(
+			"%s%zu: %zu", 
+			is_first ? "" : ", ", 
+			(size_t)1 << i, 
+			self->histogram[i]);
+
+		is_first = false;
+	}
+
+	printf("}}\n");
+}
+
+void trackers_print(const tracker *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	tracker sum = {.tag=self->tag};
+	trackers_sum_private(self, &sum);
+	trackers_print_private(&sum);
+}
+
+void trackers_report(void) {
+	trackers_lock_private();
+
+	for (tracker *t = trackers_registry; t; t = t->next) {
+		bool is_reported = false;
+		for (tracker *p = trackers_registry; p != t; p = p->next) {
+			if (strcmp(p->tag, t->tag) == 0) {
+				is_reported = true;
+				break;
+			}
+		}
+
+		if (is_reported) { continue; }
+
+		tracker sum = {.tag=t->tag};
+		for (tracker *o = t; o; o = o->next) {
+			if (strcmp(o->tag, t->tag) == 0) {
+				trackers_sum_private(o, &sum);
+			}
+		}
+
+		trackers_print_private(&sum);
+	}
+
+	trackers_unlock_private();
+}
+
+void trackers_free(tracker *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	trackers_lock_private();
+
+	tracker **next = &trackers_registry;
+	while (*next) {
+		if (*next == self) {
+			*next = self->next;
+			break;
+		}
+
+		next = &(*next)->next;
+	}
+
+	trackers_unlock_private();
+	self->next = null;
+}
+
+
 /* mems */
 
 void *mems_alloc(const allocator *mem, size_t len) {
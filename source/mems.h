@@ -1,8 +1,16 @@
 #ifndef cels_mems_h
 #define cels_mems_h
 
+/* for mmap's and madvise's flags outside gnu modes */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include "errors.h"
 #include "maths.h"
 
@@ -66,19 +74,161 @@ bool allocators_check(const allocator *self);
 cels_warn_unused
 allocator arenas_init(size_t capacity);
 
+typedef struct arena_mark {
+	/* block being bumped when marked, null on virtual arenas */
+	void *block;
+	size_t size;
+	void *hole;
+	size_t hole_size;
+} arena_mark;
+
+/*
+ * Marks the position of arena 'mem',
+ * so everything allocated after it may 
+ * be dropped at once by arenas_rewind.
+ *
+ * 'mem' must be made by arenas_init
+ * or virtual_arenas_init.
+ *
+ * #to-review
+ */
+cels_warn_unused
+arena_mark arenas_mark(const allocator *mem);
+
+/*
+ * Drops everything allocated in 'mem'
+ * since 'mark', keeping trailing blocks
+ * for the next allocations unless
+ * 'is_releasing'.
+ *
+ * Data allocated before 'mark' must 
+ * not have been grown after it.
+ *
+ * #to-review
+ */
+void arenas_rewind(const allocator *mem, arena_mark mark, bool is_releasing);
+
+
+/* virtual_arenas */
+
+/* bytes committed at once, huge-pages commit 2MiB */
+#ifndef virtual_arena_commit_size
+#define virtual_arena_commit_size 65536
+#endif
+
+typedef struct virtual_arena_option {
+	/* asks for transparent huge-pages, if the system has them */
+	bool is_huge;
+} virtual_arena_option;
+
+/*
+ * Initializes a group allocator that reserves
+ * 'capacity' bytes of address space at once,
+ * committing pages as allocations reach them -
+ * so data never moves nor chains, and to
+ * allocate is to bump a pointer.
+ *
+ * Allocations past 'capacity' fail, while
+ * if reserving fails, 'error' is set.
+ *
+ * #posix-reliant #to-review
+ */
+cels_warn_unused
+allocator virtual_arenas_init(size_t capacity, virtual_arena_option option);
+
+/*
+ * Drops everything allocated in 'mem',
+ * giving its pages back to the system
+ * while keeping them reserved.
+ *
+ * #posix-reliant #to-review
+ */
+void virtual_arenas_reset(const allocator *mem);
+
+
+/* arena_scratches */
+
+/* bytes of each block of a thread's scratch arena */
+#ifndef arena_scratch_size
+#define arena_scratch_size 65536
+#endif
+
+typedef struct arena_scratch {
+	const allocator *mem;
+	arena_mark mark;
+} arena_scratch;
+
+/*
+ * Begins a scratch region in arena 'mem', 
+ * or in an arena of the calling thread if 
+ * null - allocate temporaries through 
+ * 'scratch.mem' until arena_scratches_free.
+ *
+ * Scratches may nest, but must end
+ * in the order they began.
+ *
+ * #thread-safe #to-review
+ */
+cels_warn_unused
+arena_scratch arena_scratches_init(const allocator *mem);
+
+/*
+ * Ends scratch, dropping everything
+ * allocated since it began.
+ *
+ * #to-review
+ */
+void arena_scratches_free(arena_scratch *self);
+
+/*
+ * Declares scratch 'name', as in 
+ * arena_scratches_init, that ends when 
+ * the enclosing scope is left.
+ *
+ * #thread-safe #to-review
+ */
+#define arena_scratches_scope(name, mem) \
+	__attribute__((cleanup(arena_scratches_free))) \
+	arena_scratch name = arena_scratches_init(mem)
+
+/*
+ * Frees the scratch arena of the calling
+ * thread, no scratch of it may be in use.
+ *
+ * #to-review
+ */
+void arena_scratches_release(void);
+
 
 /* stack_arenas */
 
+/* room kept before the buffer, for the arena itself */
+#define stack_arena_header_size 64
+
 /*
  * Initializes a group allocator that allocates 
  * to the stack, meaning that the variables 
- * allocated with it are ultimately automatic
- * and so, it should'nt be freed.
+ * allocated with it are ultimately automatic.
+ *
+ * Once 'cap' is exhausted, it spills to a 
+ * heap arena, so it should be freed - which
+ * frees only what was spilled.
  *
  * #to-review
  */
 #define stack_arenas_init(cap) \
-	stack_arenas_init_helper(cap, alloca(cap))
+	stack_arenas_init_helper(cap, alloca(stack_arena_header_size + (cap)))
+
+/*
+ * Declares 'name' as a stack arena of 'cap'
+ * bytes that is freed when the enclosing 
+ * scope is left, be it by a return or a goto.
+ *
+ * #to-review
+ */
+#define stack_arenas_scope(name, cap) \
+	__attribute__((cleanup(stack_arenas_close_private))) \
+	allocator name = stack_arenas_init(cap)
 
 /*
  * Use stack_arenas_init instead.
@@ -88,6 +238,32 @@ allocator arenas_init(size_t capacity);
 cels_warn_unused
 allocator stack_arenas_init_helper(size_t capacity, char *buffer);
 
+/*
+ * Use stack_arenas_scope instead.
+ *
+ * #private #shouldnt-be-used
+ */
+void stack_arenas_close_private(allocator *mem);
+
+
+/* tlsfs */
+
+/*
+ * Initializes a group allocator of two-level 
+ * segregated fit - blocks may be freed in any 
+ * order and are merged with free neighbours at 
+ * once, while allocating and freeing take 
+ * constant time.
+ *
+ * It grows by regions of 'capacity' bytes
+ * (or more, for bigger allocations), given 
+ * back only when it is freed.
+ *
+ * #to-review
+ */
+cels_warn_unused
+allocator tlsfs_init(size_t capacity);
+
 
 /* allocs */
 
@@ -102,6 +278,109 @@ cels_warn_unused
 allocator allocs_init(void);
 
 
+/* trackers */
+
+#ifndef cels_trackers
+#define cels_trackers 1
+#endif
+
+/* size classes, bucket i holds sizes in [2^i, 2^(i + 1)) */
+#define tracker_buckets 16
+
+typedef enum tracker_event {
+	tracker_alloc_event,
+	tracker_realloc_event,
+	tracker_dealloc_event,
+	tracker_free_event,
+} tracker_event;
+
+typedef struct tracker tracker;
+
+typedef void (*trackfunc)(
+	const tracker *self,
+	tracker_event event,
+	void *data,
+	size_t size,
+	void *params);
+
+typedef struct tracker_option {
+	/* called on every event, may be null */
+	trackfunc hook;
+	void *params;
+} tracker_option;
+
+struct tracker {
+	/* subsystem or call site, reports are grouped by it */
+	const char *tag;
+	const allocator *mem;
+	tracker_option option;
+
+	size_t allocs;
+	size_t reallocs;
+	size_t deallocs;
+	size_t failures;
+	size_t in_use;
+	size_t peak;
+	size_t total;
+	size_t histogram[tracker_buckets];
+
+	tracker *next;
+};
+
+/*
+ * Initializes a tracker around 'mem' (which
+ * may be null) and returns a group allocator
+ * that forwards to it while counting allocs,
+ * reallocs, deallocs, bytes in use, peak and
+ * sizes - 'self' must outlive it.
+ *
+ * Freeing the returned allocator frees 'mem'
+ * if it is a group allocator, else blocks
+ * should be released with mems_dealloc.
+ *
+ * If cels_trackers is false, 'mem' (or
+ * allocs_init) is returned untouched.
+ *
+ * #thread-safe #to-review
+ */
+cels_warn_unused
+allocator trackers_init(
+	tracker *self,
+	const char *tag,
+	tracker_option option,
+	const allocator *mem);
+
+/*
+ * Turns counting of every tracker on or off
+ * at runtime, disabled trackers only forward.
+ *
+ * #thread-safe #to-review
+ */
+void trackers_enable(bool is_enabled);
+
+/*
+ * Prints the counters of tracker.
+ *
+ * #to-review
+ */
+void trackers_print(const tracker *self);
+
+/*
+ * Prints the counters of every tracker
+ * in use, summed by tag.
+ *
+ * #thread-safe #to-review
+ */
+void trackers_report(void);
+
+/*
+ * Stops reporting tracker.
+ *
+ * #thread-safe #to-review
+ */
+void trackers_free(tracker *self);
+
+
 /* mems */
 
 /*
@@ -3,212 +3,32 @@
 
 /* binodes */
 
-void binodes_right_rotate_private(notused binode *self, binode *new_node) {
-	#if cels_debug
-		errors_abort("self", binodes_check(self));
-		errors_abort("new_node", binodes_check(new_node));
-	#endif
-
-    binode* left = new_node->left;
-    new_node->left = left->right;
-
-    if (new_node->left) {
-        new_node->left->parent = new_node;
-	}
-
-    left->parent = new_node->parent;
-    if (!new_node->parent) {
-        self = left;
-	} else if (new_node == new_node->parent->left) {
-        new_node->parent->left = left;
-	} else {
-        new_node->parent->right = left;
-	}
-
-    left->right = new_node;
-    new_node->parent = left;
-}
- 
-void binodes_left_rotate_private(notused binode *self, binode *new_node) {
-	#if cels_debug
-		errors_abort("self", binodes_check(self));
-		errors_abort("new_node", binodes_check(new_node));
-	#endif
-
-    binode* right = new_node->right;
-    new_node->right = right->left;
-
-    if (new_node->right) {
-        new_node->right->parent = new_node;
-	}
-
-    right->parent = new_node->parent;
-    if (!new_node->parent) {
-        self = right;
-	} else if (new_node == new_node->parent->left) {
-        new_node->parent->left = right;
-	} else {
-        new_node->parent->right = right;
+binode *binodes_first_private(binode *self) {
+	while (self->left) {
+		self = self->left;
 	}
 
-    right->left = new_node;
-    new_node->parent = right;
+	return self;
 }
 
 /*
- * This function normalizes the red-black tree 
- * violentions made bi insertion bi binodes_push.
- *
- * I've got this from gist.github.com/VictorGarritano/5f894be162d39e9bdd5c
+ * Gets the node following 'self' in-order, 
+ * or null if it is the last.
  */
-void binodes_normalize_private(binode *self, binode *new_node) {
-	#if cels_debug
-		errors_abort("self", binodes_check(self));
-		errors_abort("new_node", binodes_check(new_node));
-	#endif
-
-	bool is_new_node_unique = 
-		new_node != self && new_node != self->left && new_node != self->right;
-
-	bool is_new_node_parent_red = 
-		new_node->parent && new_node->parent->color == binode_red_color;
-
-    // iterate until new_node is not the self and new_node's parent color is red
-    while (is_new_node_unique && is_new_node_parent_red) {
-        binode *y = null;
-
-        // Find uncle and store uncle in y
-		bool does_parent_exists = 
-			new_node->parent && 
-			new_node->parent->parent;
-
-		bool does_parent_exists_at_left = 
-			does_parent_exists && 
-			new_node->parent == new_node->parent->parent->left;
-
-        if (does_parent_exists_at_left) {
-            y = new_node->parent->parent->right;
-		} else if (does_parent_exists) {
-            y = new_node->parent->parent->left;
-		}
-
-        // If uncle is RED, do following
-        // (i)  Change color of parent and uncle as BLACK
-        // (ii) Change color of grandparent as RED
-        // (iii) Move new_node to grandparent
-        if (!y) {
-            new_node = new_node->parent->parent;
-		} else if (y->color == binode_red_color) {
-            y->color = binode_black_color;
-            new_node->parent->color = binode_black_color;
-            new_node->parent->parent->color = binode_red_color;
-            new_node = new_node->parent->parent;
-        } else {
-            // Left-Left (LL) case, do following
-            // (i)  Swap color of parent and grandparent
-            // (ii) Right Rotate Grandparent
-			
-			bool does_parent_exists = 
-				new_node->parent && 
-				new_node->parent->parent;
-
-			bool case1 = 
-				does_parent_exists && 
-				new_node->parent == new_node->parent->parent->left && 
-				new_node == new_node->parent->left;
-
-            if (case1) {
-                binode_color color = new_node->parent->color ;
-                new_node->parent->color = new_node->parent->parent->color;
-                new_node->parent->parent->color = color;
-                binodes_right_rotate_private(self,new_node->parent->parent);
-            }
-
-            // Left-Right (LR) case, do following
-            // (i)  Swap color of current node  and grandparent
-            // (ii) Left Rotate Parent
-            // (iii) Right Rotate Grand Parent
-
-			does_parent_exists = 
-				new_node->parent && 
-				new_node->parent->parent;
-
-			bool case2 = 
-				does_parent_exists && 
-				new_node->parent == new_node->parent->parent->left && 
-				new_node == new_node->parent->right;
-
-            if (case2) {
-                binode_color color = new_node->color ;
-                new_node->color = new_node->parent->parent->color;
-                new_node->parent->parent->color = color;
-                binodes_left_rotate_private(self,new_node->parent);
-                binodes_right_rotate_private(self,new_node->parent->parent);
-            }
-
-            // Right-Right (RR) case, do following
-            // (i)  Swap color of parent and grandparent
-            // (ii) Left Rotate Grandparent
-
-			does_parent_exists = 
-				new_node->parent && 
-				new_node->parent->parent;
-
-			bool case3 = 
-				does_parent_exists && 
-				new_node->parent == new_node->parent->parent->right && 
-				new_node == new_node->parent->right;
-
-            if (case3) {
-                binode_color color = new_node->parent->color;
-                new_node->parent->color = new_node->parent->parent->color;
-                new_node->parent->parent->color = color;
-                binodes_left_rotate_private(self,new_node->parent->parent);
-            }
-
-            // Right-Left (RL) case, do following
-            // (i)  Swap color of current node  and grandparent
-            // (ii) Right Rotate Parent
-            // (iii) Left Rotate Grand Parent
-
-			does_parent_exists = 
-				new_node->parent && 
-				new_node->parent->parent;
-
-			bool case4 = 
-				does_parent_exists && 
-				new_node->parent == new_node->parent->parent->right && 
-				new_node == new_node->parent->left;
-
-            if (case4) {
-                binode_color color = new_node->color;
-                new_node->color = new_node->parent->parent->color;
-                new_node->parent->parent->color = color;
-                binodes_right_rotate_private(self,new_node->parent);
-                binodes_left_rotate_private(self,new_node->parent->parent);
-            }
-        }
-    }
-
-    self->color = binode_black_color; 
-}
-
-binode *binodes_find_left_most_private(binode *self) {
-	if (!self || !self->left) {
-		return null;
+binode *binodes_successor_private(binode *self) {
+	if (self->right) {
+		return binodes_first_private(self->right);
 	}
 
-	binode *left_most = self->left;
-	while (true) {
-		if (left_most->left) {
-			left_most = left_most->left;
-			continue;
-		} 
-
-		break;
+	while (self->parent && self == self->parent->right) {
+		self = self->parent;
 	}
 
-	return left_most;
+	return self->parent;
+}
+
+static inline bool binodes_is_red_private(const binode *self) {
+	return self && self->color == binode_red_color;
 }
 
 bool binodes_check(const binode *self) {
@@ -234,92 +54,343 @@ bool binodes_check(const binode *self) {
 
 /* bitrees */
 
-void bitrees_next_right_procedure_private(
-	binode *self, bitree_iterator *iterator) {
+/*
+ * Puts 'node' in place of 'old' 
+ * under the parent of 'old'.
+ */
+void bitrees_replace_private(bitree *self, binode *old, binode *node) {
+	if (!old->parent) {
+		self->data = node;
+	} else if (old == old->parent->left) {
+		old->parent->left = node;
+	} else {
+		old->parent->right = node;
+	}
+
+	if (node) {
+		node->parent = old->parent;
+	}
+}
 
-	binode *left_most = binodes_find_left_most_private(self);
+void bitrees_left_rotate_private(bitree *self, binode *node) {
+	binode *right = node->right;
 
-	if (left_most) {
-		iterator->data = left_most;
-		iterator->internal.left = left_most;
-		iterator->internal.right = left_most->parent->right;
-		iterator->internal.state = bitree_left_most_iterator_state;
-	} else {
-		iterator->data = self;
-		iterator->internal.right = self;
-		iterator->internal.state = bitree_right_most_iterator_state;
+	node->right = right->left;
+	if (right->left) {
+		right->left->parent = node;
 	}
+
+	bitrees_replace_private(self, node, right);
+
+	right->left = node;
+	node->parent = right;
 }
 
-bool bitrees_next(const void *self, void *iterator) {
-	const bitree *s = self;
-	bitree_iterator *it = iterator; 
+void bitrees_right_rotate_private(bitree *self, binode *node) {
+	binode *left = node->left;
 
-	if (!s || !s->data) { return false; }
+	node->left = left->right;
+	if (left->right) {
+		left->right->parent = node;
+	}
 
-	it->internal.prev = it->data;
+	bitrees_replace_private(self, node, left);
 
-	if (it->internal.state == bitree_initial_iterator_state) {
-		if (s->data->left) {
-			binode *left_most = binodes_find_left_most_private(s->data);
-			it->data = left_most;
-			it->internal.left = left_most;
-			it->internal.right = left_most->parent->right;
-			it->internal.state = bitree_left_most_iterator_state;
-			return true;
-		} else if (s->data->right) {
-			bitrees_next_right_procedure_private(s->data->right, it);
-			return true;
+	left->right = node;
+	node->parent = left;
+}
+
+/*
+ * Restores the red-black properties 
+ * after 'node' (red) was pushed.
+ */
+void bitrees_normalize_private(bitree *self, binode *node) {
+	while (binodes_is_red_private(node->parent)) {
+		binode *parent = node->parent;
+		binode *grandparent = parent->parent;
+
+		if (parent == grandparent->left) {
+			binode *uncle = grandparent->right;
+
+			if (binodes_is_red_private(uncle)) {
+				parent->color = binode_black_color;
+				uncle->color = binode_black_color;
+				grandparent->color = binode_red_color;
+				node = grandparent;
+				continue;
+			}
+
+			if (node == parent->right) {
+				node = parent;
+				bitrees_left_rotate_private(self, node);
+				parent = node->parent;
+			}
+
+			parent->color = binode_black_color;
+			grandparent->color = binode_red_color;
+			bitrees_right_rotate_private(self, grandparent);
 		} else {
-			it->data = s->data;
-			it->internal.state = bitree_finished_iterator_state;
-			return true;
+			binode *uncle = grandparent->left;
+
+			if (binodes_is_red_private(uncle)) {
+				parent->color = binode_black_color;
+				uncle->color = binode_black_color;
+				grandparent->color = binode_red_color;
+				node = grandparent;
+				continue;
+			}
+
+			if (node == parent->left) {
+				node = parent;
+				bitrees_right_rotate_private(self, node);
+				parent = node->parent;
+			}
+
+			parent->color = binode_black_color;
+			grandparent->color = binode_red_color;
+			bitrees_left_rotate_private(self, grandparent);
 		}
-	} else if (it->internal.state == bitree_left_most_iterator_state) {
-		if (it->internal.right) {
-			bitrees_next_right_procedure_private(it->internal.right, it);
-			return true;
-		} 
+	}
 
-		it->data = it->internal.left->parent;
-		it->internal.right = it->internal.left->parent;
-		it->internal.state = bitree_returning_node_iterator_state;
-		return true;
-	} else if (it->internal.state == bitree_right_most_iterator_state) {
-		it->data = it->internal.right->parent;
-		it->internal.right = it->internal.right->parent;
-		it->internal.state = bitree_returning_node_iterator_state;
-		return true;
-	} else if (it->internal.state == bitree_returning_node_iterator_state) {
-		if (!it->internal.right->parent) {
-			return false;
-		} 
+	self->data->color = binode_black_color;
+}
+
+/*
+ * Restores the red-black properties after 
+ * a black node was unlinked, 'node' (maybe 
+ * null) being the child of 'parent' that 
+ * took its place.
+ */
+void bitrees_denormalize_private(bitree *self, binode *node, binode *parent) {
+	while (node != self->data && !binodes_is_red_private(node)) {
+		if (node == parent->left) {
+			binode *sibling = parent->right;
+
+			if (binodes_is_red_private(sibling)) {
+				sibling->color = binode_black_color;
+				parent->color = binode_red_color;
+				bitrees_left_rotate_private(self, parent);
+				sibling = parent->right;
+			}
 
-		bool is_left_side = 
-			it->internal.right->parent->left == it->internal.right;
+			bool are_nephews_black = 
+				!binodes_is_red_private(sibling->left) && 
+				!binodes_is_red_private(sibling->right);
 
-		if (is_left_side) {
-			if (it->internal.right->parent->right) {
-				bitrees_next_right_procedure_private(
-					it->internal.right->parent->right, it);
-				return true;
-			} else {
-				it->data = it->internal.right->parent;
-				it->internal.right = it->internal.right->parent;
-				it->internal.state = bitree_returning_node_iterator_state;
-				return true;
+			if (are_nephews_black) {
+				sibling->color = binode_red_color;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (!binodes_is_red_private(sibling->right)) {
+				sibling->left->color = binode_black_color;
+				sibling->color = binode_red_color;
+				bitrees_right_rotate_private(self, sibling);
+				sibling = parent->right;
 			}
+
+			sibling->color = parent->color;
+			parent->color = binode_black_color;
+			sibling->right->color = binode_black_color;
+			bitrees_left_rotate_private(self, parent);
+			node = self->data;
 		} else {
-			it->data = it->internal.right->parent;
-			it->internal.right = it->internal.right->parent;
-			it->internal.state = bitree_returning_node_iterator_state;
-			return true;
+			binode *sibling = parent->left;
+
+			if (binodes_is_red_private(sibling)) {
+				sibling->color = binode_black_color;
+				parent->color = binode_red_color;
+				bitrees_right_rotate_private(self, parent);
+				sibling = parent->left;
+			}
+
+			bool are_nephews_black = 
+				!binodes_is_red_private(sibling->left) && 
+				!binodes_is_red_private(sibling->right);
+
+			if (are_nephews_black) {
+				sibling->color = binode_red_color;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (!binodes_is_red_private(sibling->left)) {
+				sibling->right->color = binode_black_color;
+				sibling->color = binode_red_color;
+				bitrees_left_rotate_private(self, sibling);
+				sibling = parent->left;
+			}
+
+			sibling->color = parent->color;
+			parent->color = binode_black_color;
+			sibling->left->color = binode_black_color;
+			bitrees_right_rotate_private(self, parent);
+			node = self->data;
 		}
+	}
+
+	if (node) {
+		node->color = binode_black_color;
+	}
+}
+
+/*
+ * Unlinks 'node' from 'self', relinking 
+ * (rather than copying) its successor so 
+ * pointers to other nodes stay valid.
+ */
+void bitrees_unlink_private(bitree *self, binode *node) {
+	binode_color removed_color = node->color;
+	binode *child = null;
+	binode *parent = null;
+
+	if (!node->left) {
+		child = node->right;
+		parent = node->parent;
+		bitrees_replace_private(self, node, child);
+	} else if (!node->right) {
+		child = node->left;
+		parent = node->parent;
+		bitrees_replace_private(self, node, child);
 	} else {
+		binode *successor = binodes_first_private(node->right);
+		removed_color = successor->color;
+		child = successor->right;
+
+		if (successor->parent == node) {
+			parent = successor;
+		} else {
+			parent = successor->parent;
+			bitrees_replace_private(self, successor, child);
+
+			successor->right = node->right;
+			successor->right->parent = successor;
+		}
+
+		bitrees_replace_private(self, node, successor);
+		successor->left = node->left;
+		successor->left->parent = successor;
+		successor->color = node->color;
+	}
+
+	if (removed_color == binode_black_color) {
+		bitrees_denormalize_private(self, child, parent);
+	}
+}
+
+/*
+ * Removes the node with 'hash', cleaning its 
+ * key and (if 'value_cleaner') its value, then 
+ * keeps it on the free list of 'self'.
+ */
+error bitrees_remove_private(
+	void *self, 
+	size_t hash, 
+	freefunc key_cleaner, 
+	freefunc value_cleaner, 
+	const allocator *mem) {
+
+	bitree *s = self;
+
+	binode *node = s->data;
+	while (node && node->hash != hash) {
+		node = hash < node->hash ? node->left : node->right;
+	}
+
+	if (!node) { return fail; }
+
+	if (key_cleaner) {
+		key_cleaner(&node->data, mem);
+	}
+
+	if (value_cleaner) {
+		value_cleaner((char *)&node->data + s->extra_size, mem);
+	}
+
+	bitrees_unlink_private(s, node);
+	--s->size;
+
+	node->left = null;
+	node->parent = null;
+	node->right = s->freed;
+	s->freed = node;
+
+	return ok;
+}
+
+/*
+ * Frees every node (and the free list) of 'self' 
+ * without recursion, by rotating left children 
+ * up until the tree is a list.
+ */
+void bitrees_free_private(
+	void *self, 
+	freefunc key_cleaner, 
+	freefunc value_cleaner, 
+	const allocator *mem) {
+
+	bitree *s = self;
+
+	binode *node = s->data;
+	while (node) {
+		binode *left = node->left;
+		if (left) {
+			node->left = left->right;
+			left->right = node;
+			node = left;
+			continue;
+		}
+
+		binode *right = node->right;
+
+		if (key_cleaner) {
+			key_cleaner(&node->data, mem);
+		}
+
+		if (value_cleaner) {
+			value_cleaner((char *)&node->data + s->extra_size, mem);
+		}
+
+		mems_dealloc(mem, node, s->node_size);
+		node = right;
+	}
+
+	while (s->freed) {
+		binode *next = s->freed->right;
+		mems_dealloc(mem, s->freed, s->node_size);
+		s->freed = next;
+	}
+
+	s->data = null;
+	s->size = 0;
+}
+
+bool bitrees_next(const void *self, void *iterator) {
+	const bitree *s = self;
+	bitree_iterator *it = iterator; 
+
+	if (!s || !s->data) { return false; }
+
+	binode *next = null;
+	if (it->internal.state == bitree_initial_iterator_state) {
+		next = binodes_first_private(s->data);
+	} else if (it->internal.state == bitree_returning_node_iterator_state) {
+		next = binodes_successor_private(it->data);
+	}
+
+	it->internal.prev = it->data;
+
+	if (!next) {
+		it->internal.state = bitree_finished_iterator_state;
 		return false;
 	}
 
-	return false;
+	it->data = next;
+	it->internal.state = bitree_returning_node_iterator_state;
+	return true;
 }
 
 void *bitrees_get(const void *self, size_t hash) {
@@ -327,25 +398,15 @@ void *bitrees_get(const void *self, size_t hash) {
 
 	#if cels_debug
 		errors_abort("self", !s);
-		errors_abort("self.data", binodes_check(s->data));
+		errors_abort("self.data", s->data && binodes_check(s->data));
 	#endif
 
 	binode *node = s->data;
 	while (node) {
 		if (hash < node->hash) {
-			if (node->left && node->frequency > 0) {
-				node = node->left;
-				continue;
-			} 
-
-			return null;
+			node = node->left;
 		} else if (hash > node->hash) {
-			if (node->right && node->frequency > 0) {
-				node = node->right;
-				continue;
-			} 
-
-			return null;
+			node = node->right;
 		} else {
 			return node;
 		}
@@ -357,60 +418,62 @@ void *bitrees_get(const void *self, size_t hash) {
 error bitrees_push(void *self, void *item, size_t hash, const allocator *mem) {
 	bitree *s = self;
 
-	binode *node = mems_alloc(mem, s->node_size);
-	if (!node) { return fail; }
-
-	node->hash = hash;
-	node->color = binode_black_color;
-	node->frequency = 1;
-	memcpy(&node->data, item, s->type_size);
-
 	#if cels_debug
 		errors_abort("self", !self);
-		errors_abort("node", binodes_check(node));
 	#endif
 
-    if (!s->data) { 
-		s->data = node; 
-		++s->size;
-
-		return ok;
-	}
-
+	binode *parent = null;
 	binode *next = s->data;
 	while (next) {
-		if (node->hash < next->hash) {
-			if (next->left && next->frequency > 0) {
-				next = next->left;
-				continue;
-			} 
-
-			next->left = node;
-			next->left->parent = next;
-			++s->size;
-			break;
-		} else if (node->hash > next->hash) {
-			if (next->right && next->frequency > 0) {
-				next = next->right;
-				continue;
-			} 
-
-			next->right = node;
-			next->right->parent = next;
-			++s->size;
-			break;
-		} else {
+		if (hash == next->hash) {
 			++next->frequency;
-			mems_dealloc(mem, node, s->node_size);
 			return fail;
 		}
+
+		parent = next;
+		next = hash < next->hash ? next->left : next->right;
+	}
+
+	binode *node = s->freed;
+	if (node) {
+		s->freed = node->right;
+	} else {
+		node = mems_alloc(mem, s->node_size);
+		if (!node) { return fail; }
+	}
+
+	node->left = null;
+	node->right = null;
+	node->parent = parent;
+	node->hash = hash;
+	node->color = binode_red_color;
+	node->frequency = 1;
+	memcpy(&node->data, item, s->type_size);
+
+	if (!parent) {
+		s->data = node;
+	} else if (hash < parent->hash) {
+		parent->left = node;
+	} else {
+		parent->right = node;
 	}
 
-	binodes_normalize_private(s->data, node);
+	++s->size;
+	bitrees_normalize_private(s, node);
 
 	return ok;
 }
 
+error bitrees_remove(
+	void *self, size_t hash, freefunc cleaner, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	return bitrees_remove_private(self, hash, cleaner, null, mem);
+}
+
 
 /* mutrees */
 
@@ -656,53 +719,272 @@ void mutrees_free(void *self, freefunc cleaner, const allocator *mem) {
 }
 
 
-/* pools */
-
-pool_block *pool_blocks_init_private(
-	size_t item_size, size_t capacity, const allocator *mem) {
+/* mutree-compacts */
 
-	void *items = mems_alloc(mem, capacity * item_size);
-	if (!items) { return null; }
-	
-	pool_block node = {
-		.next=null,
-		.data=items,
-		.capacity=capacity,
-		.size=0,
-	};
-	
-	pool_block *node_capsule = mems_alloc(mem, sizeof(pool_block));
-	*node_capsule = node;
-	
-	return node_capsule;
-}
+/* links of a cell, in the order they are declared in mucells */
+typedef enum mutree_compact_link {
+	mutree_compact_parent_link,
+	mutree_compact_left_link,
+	mutree_compact_down_link,
+	mutree_compact_next_link,
+} mutree_compact_link;
 
-void pools_init(
-	void *self, 
-	size_t item_size, 
-	size_t type_size, 
-	size_t offset_size, 
-	size_t capacity, 
-	const allocator *mem) {
+static inline void *mutree_compacts_cell_private(
+	const mutree_compact *self, size_t index) {
 
-	pool *s = self;
+	return (char *)self->data + index * self->cell_size;
+}
 
-	pool_block *block = pool_blocks_init_private(item_size, capacity, mem);
-	errors_abort("block", !block);
-	
-	pool pool = {
-		.data=block,
-		.capacity=capacity,
-		.item_size=item_size,
-		.type_size=type_size,
-		.offset_size=offset_size,
-	};
+/* 
+ * Cells are only as aligned as their own type 
+ * (a 'cell_size' of 20 is common), so they are 
+ * reached through their links, never as a mucell.
+ */
+static inline uint32_t *mutree_compacts_links_private(
+	const mutree_compact *self, size_t index) {
 
-	*s = pool;
+	return (uint32_t *)mutree_compacts_cell_private(self, index);
 }
 
-error pools_push(void *self, void *item, const allocator *mem) {
-	pool *s = self;
+/*
+ * Walks 'self' pre-order, from its
+ * current node - returning the next
+ * one and updating its 'depth'.
+ */
+const munode *mutrees_walk_private(const munode *node, size_t *depth) {
+	if (node->down) {
+		++*depth;
+		return node->down;
+	}
+
+	while (node && !node->left) {
+		node = node->parent;
+		--*depth;
+	}
+
+	return node ? node->left : null;
+}
+
+error mutrees_compact(const void *self, void *compact, const allocator *mem) {
+	const mutree *s = self;
+	mutree_compact *c = compact;
+
+	#if cels_debug
+		errors_abort("self", !s);
+		errors_abort("compact", !c);
+		errors_abort("compact.cell_size", !c->cell_size);
+	#endif
+
+	c->data = null;
+	c->size = 0;
+
+	size_t size = 0;
+	size_t depth = 0;
+	for (const munode *n = s->data; n; n = mutrees_walk_private(n, &depth)) {
+		++size;
+	}
+
+	if (size == 0) { return ok; }
+	if (size >= mutree_compact_none) { return fail; }
+
+	c->data = mems_alloc(mem, size * c->cell_size);
+	if (!c->data) { return fail; }
+
+	/* last cell written at each depth, then the breadth-wise queue */
+	uint32_t *indexes = mems_alloc(mem, size * sizeof(uint32_t));
+	if (!indexes) { goto cleanup0; }
+
+	/* both sizes count trailing padding, so the smallest holds the data */
+	size_t data_size = s->node_size - offsetof(munode, data);
+	size_t cell_offset = offsetof(mucell, data);
+	if (data_size > c->cell_size - cell_offset) {
+		data_size = c->cell_size - cell_offset;
+	}
+
+	depth = 0;
+	const munode *node = s->data;
+	for (uint32_t i = 0; node; i++) {
+		uint32_t *links = mutree_compacts_links_private(c, i);
+		links[mutree_compact_parent_link] = mutree_compact_none;
+		links[mutree_compact_left_link] = mutree_compact_none;
+		links[mutree_compact_down_link] = mutree_compact_none;
+		links[mutree_compact_next_link] = mutree_compact_none;
+		memcpy((char *)links + cell_offset, &node->data, data_size);
+
+		if (depth > 0) {
+			uint32_t parent = indexes[depth - 1];
+			uint32_t *parent_links = mutree_compacts_links_private(c, parent);
+			links[mutree_compact_parent_link] = parent;
+
+			if (parent_links[mutree_compact_down_link] == mutree_compact_none) {
+				parent_links[mutree_compact_down_link] = i;
+			} else {
+				uint32_t *left_links = 
+					mutree_compacts_links_private(c, indexes[depth]);
+
+				left_links[mutree_compact_left_link] = i;
+			}
+		} else if (i > 0) {
+			uint32_t *left_links = mutree_compacts_links_private(c, indexes[0]);
+			left_links[mutree_compact_left_link] = i;
+		}
+
+		indexes[depth] = i;
+		node = mutrees_walk_private(node, &depth);
+	}
+
+	c->size = size;
+
+	size_t head = 0;
+	size_t tail = 0;
+	uint32_t previous = mutree_compact_none;
+
+	indexes[tail++] = 0;
+	while (head < tail) {
+		uint32_t i = indexes[head++];
+
+		while (i != mutree_compact_none) {
+			uint32_t *links = mutree_compacts_links_private(c, i);
+
+			if (previous != mutree_compact_none) {
+				uint32_t *previous_links = 
+					mutree_compacts_links_private(c, previous);
+
+				previous_links[mutree_compact_next_link] = i;
+			}
+
+			if (links[mutree_compact_down_link] != mutree_compact_none) {
+				indexes[tail++] = links[mutree_compact_down_link];
+			}
+
+			previous = i;
+			i = links[mutree_compact_left_link];
+		}
+	}
+
+	mems_dealloc(mem, indexes, size * sizeof(uint32_t));
+	return ok;
+
+	cleanup0:
+	mems_dealloc(mem, c->data, size * c->cell_size);
+	c->data = null;
+	return fail;
+}
+
+bool mutree_compacts_next(const void *self, void *iterator) {
+	const mutree_compact *s = self;
+	mutree_compact_iterator *it = iterator;
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	if (!it->internal.is_started) {
+		it->internal.index = 0;
+		it->internal.is_started = true;
+	} else if (it->internal.index < s->size) {
+		++it->internal.index;
+	}
+
+	if (it->internal.index >= s->size) {
+		it->data = null;
+		return false;
+	}
+
+	it->data = mutree_compacts_cell_private(s, it->internal.index);
+	return true;
+}
+
+bool mutree_compacts_next_breadth_wise(const void *self, void *iterator) {
+	const mutree_compact *s = self;
+	mutree_compact_iterator *it = iterator;
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	if (!it->internal.is_started) {
+		it->internal.index = s->size ? 0 : mutree_compact_none;
+		it->internal.is_started = true;
+	} else if (it->internal.index != mutree_compact_none) {
+		uint32_t *links = mutree_compacts_links_private(s, it->internal.index);
+		it->internal.index = links[mutree_compact_next_link];
+	}
+
+	if (it->internal.index == mutree_compact_none) {
+		it->data = null;
+		return false;
+	}
+
+	it->data = mutree_compacts_cell_private(s, it->internal.index);
+	return true;
+}
+
+void mutree_compacts_free(void *self, const allocator *mem) {
+	mutree_compact *s = self;
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (s->data) {
+		mems_dealloc(mem, s->data, s->size * s->cell_size);
+	}
+
+	s->data = null;
+	s->size = 0;
+}
+
+
+/* pools */
+
+pool_block *pool_blocks_init_private(
+	size_t item_size, size_t capacity, const allocator *mem) {
+
+	void *items = mems_alloc(mem, capacity * item_size);
+	if (!items) { return null; }
+	
+	pool_block node = {
+		.next=null,
+		.data=items,
+		.capacity=capacity,
+		.size=0,
+	};
+	
+	pool_block *node_capsule = mems_alloc(mem, sizeof(pool_block));
+	*node_capsule = node;
+	
+	return node_capsule;
+}
+
+void pools_init(
+	void *self, 
+	size_t item_size, 
+	size_t type_size, 
+	size_t offset_size, 
+	size_t capacity, 
+	const allocator *mem) {
+
+	pool *s = self;
+
+	pool_block *block = pool_blocks_init_private(item_size, capacity, mem);
+	errors_abort("block", !block);
+	
+	pool pool = {
+		.data=block,
+		.capacity=capacity,
+		.item_size=item_size,
+		.type_size=type_size,
+		.offset_size=offset_size,
+	};
+
+	*s = pool;
+}
+
+error pools_push(void *self, void *item, const allocator *mem) {
+	pool *s = self;
 
 	if (!s || !s->capacity) { return fail; }
 	
@@ -902,23 +1184,14 @@ error sets_push(void *self, void *item, size_t hash, const allocator *mem) {
 	return bitrees_push(self, item, hash, mem);
 }
 
-void sets_free(void *self, freefunc cleaner, const allocator *mem) {
-	const bitree *s = self;
-
-	bitree_iterator it = {0};
-	while (bitrees_next(self, &it)) {
-		if (cleaner) {
-			cleaner(&it.data->data, mem);
-		}
+error sets_remove(
+	void *self, size_t hash, freefunc cleaner, const allocator *mem) {
 
-		if (it.internal.prev) {
-			mems_dealloc(mem, it.internal.prev, s->node_size);
-		}
+	return bitrees_remove_private(self, hash, cleaner, null, mem);
+}
 
-		if (it.data == s->data) {
-			mems_dealloc(mem, it.data, s->node_size);
-		}
-	}
+void sets_free(void *self, freefunc cleaner, const allocator *mem) {
+	bitrees_free_private(self, cleaner, null, mem);
 }
 
 
@@ -960,31 +1233,1822 @@ error maps_push(void *self, void *item, size_t hash, const allocator *mem) {
 	return bitrees_push(self, item, hash, mem);
 }
 
+error maps_remove(
+	void *self, 
+	size_t hash, 
+	freefunc key_cleaner, 
+	freefunc value_cleaner, 
+	const allocator *mem) {
+
+	return bitrees_remove_private(self, hash, key_cleaner, value_cleaner, mem);
+}
+
 void maps_free(
 	void *self, 
 	freefunc key_cleaner, 
 	freefunc value_cleaner, 
 	const allocator *mem) {
 
-	const bitree *s = self;
+	bitrees_free_private(self, key_cleaner, value_cleaner, mem);
+}
 
-	bitree_iterator it = {0};
-	while (bitrees_next(self, &it)) {
-		if (key_cleaner) {
-			key_cleaner(&it.data->data, mem);
+
+/* bptrees */
+
+typedef struct bptree_step {
+	bpnode *node;
+	size_t index;
+} bptree_step;
+
+static inline char *bpnodes_key_private(
+	const bptree *tree, const bpnode *self, size_t index) {
+
+	return (char *)self->data + index * tree->key_size;
+}
+
+static inline char *bpnodes_value_private(
+	const bptree *tree, const bpnode *self, size_t index) {
+
+	return (char *)self->data + tree->tail_offset + index * tree->value_size;
+}
+
+static inline bpnode **bpnodes_children_private(
+	const bptree *tree, const bpnode *self) {
+
+	return (bpnode **)((char *)self->data + tree->tail_offset);
+}
+
+/*
+ * Gets the first index whose key
+ * is not less than 'key'.
+ */
+size_t bpnodes_lower_private(
+	const bptree *tree, const bpnode *self, const void *key) {
+
+	size_t low = 0;
+	size_t high = self->size;
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		const void *other = bpnodes_key_private(tree, self, middle);
+
+		if (tree->compare(other, key) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
 		}
+	}
 
-		if (value_cleaner) {
-			void *v = (char *)&it.data->data + s->extra_size;
-			value_cleaner(v, mem);
+	return low;
+}
+
+/*
+ * Gets the first index whose key
+ * is greater than 'key'.
+ */
+size_t bpnodes_upper_private(
+	const bptree *tree, const bpnode *self, const void *key) {
+
+	size_t low = 0;
+	size_t high = self->size;
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		const void *other = bpnodes_key_private(tree, self, middle);
+
+		if (tree->compare(other, key) <= 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
 		}
+	}
+
+	return low;
+}
+
+void bpnodes_insert_leaf_private(
+	const bptree *tree,
+	bpnode *self,
+	size_t index,
+	const void *key,
+	const void *value) {
+
+	size_t moved = self->size - index;
+
+	char *keys = bpnodes_key_private(tree, self, index);
+	memmove(keys + tree->key_size, keys, moved * tree->key_size);
+	memcpy(keys, key, tree->key_size);
+
+	char *values = bpnodes_value_private(tree, self, index);
+	memmove(values + tree->value_size, values, moved * tree->value_size);
+	if (value) { memcpy(values, value, tree->value_size); }
+
+	++self->size;
+}
+
+/*
+ * Inserts 'key' at 'index' and 'child'
+ * right after it.
+ */
+void bpnodes_insert_branch_private(
+	const bptree *tree,
+	bpnode *self,
+	size_t index,
+	const void *key,
+	bpnode *child) {
+
+	size_t moved = self->size - index;
+
+	char *keys = bpnodes_key_private(tree, self, index);
+	memmove(keys + tree->key_size, keys, moved * tree->key_size);
+	memcpy(keys, key, tree->key_size);
+
+	bpnode **children = bpnodes_children_private(tree, self) + index + 1;
+	memmove(children + 1, children, moved * sizeof(bpnode *));
+	*children = child;
+
+	++self->size;
+}
+
+/*
+ * Erases the key at 'index' and the
+ * value or child right after it.
+ */
+void bpnodes_erase_private(const bptree *tree, bpnode *self, size_t index) {
+	size_t moved = self->size - index - 1;
+
+	char *keys = bpnodes_key_private(tree, self, index);
+	memmove(keys, keys + tree->key_size, moved * tree->key_size);
+
+	if (self->is_leaf) {
+		char *values = bpnodes_value_private(tree, self, index);
+		memmove(values, values + tree->value_size, moved * tree->value_size);
+	} else {
+		bpnode **children = bpnodes_children_private(tree, self) + index + 1;
+		memmove(children, children + 1, moved * sizeof(bpnode *));
+	}
+
+	--self->size;
+}
+
+/*
+ * Moves a key from 'left', the sibling 
+ * before 'self', through 'parent'.
+ */
+void bpnodes_borrow_left_private(
+	const bptree *tree, bpnode *self, bpnode *left, bpnode *parent, size_t index) {
+
+	char *separator = bpnodes_key_private(tree, parent, index - 1);
+	char *keys = bpnodes_key_private(tree, self, 0);
+	memmove(keys + tree->key_size, keys, self->size * tree->key_size);
+
+	if (self->is_leaf) {
+		char *values = bpnodes_value_private(tree, self, 0);
+		memmove(values + tree->value_size, values, self->size * tree->value_size);
+
+		memcpy(keys, bpnodes_key_private(tree, left, left->size - 1), tree->key_size);
+		memcpy(
+			values, 
+			bpnodes_value_private(tree, left, left->size - 1), 
+			tree->value_size);
+
+		memcpy(separator, keys, tree->key_size);
+	} else {
+		bpnode **children = bpnodes_children_private(tree, self);
+		memmove(children + 1, children, (self->size + 1) * sizeof(bpnode *));
+
+		memcpy(keys, separator, tree->key_size);
+		children[0] = bpnodes_children_private(tree, left)[left->size];
+
+		memcpy(
+			separator, 
+			bpnodes_key_private(tree, left, left->size - 1), 
+			tree->key_size);
+	}
+
+	--left->size;
+	++self->size;
+}
+
+/*
+ * Moves a key from 'right', the sibling 
+ * after 'self', through 'parent'.
+ */
+void bpnodes_borrow_right_private(
+	const bptree *tree, bpnode *self, bpnode *right, bpnode *parent, size_t index) {
 
-		if (it.internal.prev) {
-			mems_dealloc(mem, it.internal.prev, s->node_size);
+	char *separator = bpnodes_key_private(tree, parent, index);
+	char *key = bpnodes_key_private(tree, self, self->size);
+
+	if (self->is_leaf) {
+		memcpy(key, bpnodes_key_private(tree, right, 0), tree->key_size);
+		memcpy(
+			bpnodes_value_private(tree, self, self->size), 
+			bpnodes_value_private(tree, right, 0), 
+			tree->value_size);
+
+		++self->size;
+		bpnodes_erase_private(tree, right, 0);
+
+		memcpy(separator, bpnodes_key_private(tree, right, 0), tree->key_size);
+		return;
+	}
+
+	bpnode **children = bpnodes_children_private(tree, right);
+
+	memcpy(key, separator, tree->key_size);
+	bpnodes_children_private(tree, self)[self->size + 1] = children[0];
+	++self->size;
+
+	memcpy(separator, bpnodes_key_private(tree, right, 0), tree->key_size);
+
+	char *keys = bpnodes_key_private(tree, right, 0);
+	memmove(keys, keys + tree->key_size, (right->size - 1) * tree->key_size);
+	memmove(children, children + 1, right->size * sizeof(bpnode *));
+	--right->size;
+}
+
+/*
+ * Merges 'right' into 'self', dropping 
+ * the key at 'index' of 'parent' 
+ * between them.
+ */
+void bpnodes_merge_private(
+	const bptree *tree, 
+	bpnode *self, 
+	bpnode *right, 
+	bpnode *parent, 
+	size_t index, 
+	const allocator *mem) {
+
+	if (self->is_leaf) {
+		memcpy(
+			bpnodes_key_private(tree, self, self->size),
+			bpnodes_key_private(tree, right, 0),
+			right->size * tree->key_size);
+
+		memcpy(
+			bpnodes_value_private(tree, self, self->size),
+			bpnodes_value_private(tree, right, 0),
+			right->size * tree->value_size);
+
+		self->size += right->size;
+		self->next = right->next;
+	} else {
+		memcpy(
+			bpnodes_key_private(tree, self, self->size),
+			bpnodes_key_private(tree, parent, index),
+			tree->key_size);
+
+		memcpy(
+			bpnodes_key_private(tree, self, self->size + 1),
+			bpnodes_key_private(tree, right, 0),
+			right->size * tree->key_size);
+
+		memcpy(
+			bpnodes_children_private(tree, self) + self->size + 1,
+			bpnodes_children_private(tree, right),
+			(right->size + 1) * sizeof(bpnode *));
+
+		self->size += right->size + 1;
+	}
+
+	bpnodes_erase_private(tree, parent, index);
+	mems_dealloc(mem, right, tree->node_size);
+}
+
+/*
+ * Frees 'self' and its subtree, calling 
+ * the cleaners on every pair.
+ */
+void bpnodes_free_private(
+	const bptree *tree, 
+	bpnode *self, 
+	freefunc key_cleaner, 
+	freefunc value_cleaner, 
+	const allocator *mem) {
+
+	if (!self->is_leaf) {
+		bpnode **children = bpnodes_children_private(tree, self);
+		for (size_t i = 0; i <= self->size; i++) {
+			bpnodes_free_private(tree, children[i], key_cleaner, value_cleaner, mem);
 		}
+	} else {
+		for (size_t i = 0; i < self->size; i++) {
+			if (key_cleaner) {
+				key_cleaner(bpnodes_key_private(tree, self, i), mem);
+			}
 
-		if (it.data == s->data) {
-			mems_dealloc(mem, it.data, s->node_size);
+			if (value_cleaner) {
+				value_cleaner(bpnodes_value_private(tree, self, i), mem);
+			}
 		}
 	}
+
+	mems_dealloc(mem, self, tree->node_size);
+}
+
+/*
+ * Checks the subtree of 'self', whose keys 
+ * must be in ['low', 'high'), also following 
+ * the leaf links through 'leaf'.
+ */
+bool bpnodes_check_private(
+	const bptree *tree, 
+	const bpnode *self, 
+	const void *low, 
+	const void *high, 
+	size_t depth, 
+	size_t *size, 
+	const bpnode **leaf) {
+
+	if (!self) { return true; }
+	if (self->size > tree->order) { return true; }
+
+	bool is_root = self == tree->data;
+	size_t minimum = self->is_leaf ? tree->order / 2 : (tree->order - 1) / 2;
+	if (!is_root && self->size < minimum) { return true; }
+	if (!self->is_leaf && self->size == 0) { return true; }
+
+	for (size_t i = 0; i < self->size; i++) {
+		const void *key = bpnodes_key_private(tree, self, i);
+
+		if (low && tree->compare(key, low) < 0) { return true; }
+		if (high && tree->compare(key, high) >= 0) { return true; }
+
+		if (i > 0) {
+			const void *previous = bpnodes_key_private(tree, self, i - 1);
+			if (tree->compare(previous, key) >= 0) { return true; }
+		}
+	}
+
+	if (self->is_leaf) {
+		if (depth + 1 != tree->height) { return true; }
+		if (*leaf != self) { return true; }
+
+		*leaf = self->next;
+		*size += self->size;
+
+		return false;
+	}
+
+	bpnode **children = bpnodes_children_private(tree, self);
+	for (size_t i = 0; i <= self->size; i++) {
+		const void *child_low = i > 0 ? bpnodes_key_private(tree, self, i - 1) : low;
+		const void *child_high = i < self->size ? bpnodes_key_private(tree, self, i) : high;
+
+		bool is_invalid = bpnodes_check_private(
+			tree, children[i], child_low, child_high, depth + 1, size, leaf);
+
+		if (is_invalid) { return true; }
+	}
+
+	return false;
+}
+
+/*
+ * Walks from the root to the leaf 
+ * where 'key' belongs, recording 
+ * the path, and returns its depth.
+ */
+size_t bptrees_descend_private(
+	const bptree *self, const void *key, bptree_step *path) {
+
+	size_t depth = 0;
+	bpnode *node = self->data;
+
+	while (!node->is_leaf) {
+		size_t index = bpnodes_upper_private(self, node, key);
+		path[depth++] = (bptree_step){.node=node, .index=index};
+
+		node = bpnodes_children_private(self, node)[index];
+	}
+
+	path[depth] = (bptree_step){.node=node, .index=0};
+	return depth;
+}
+
+/*
+ * Gets the smallest key under 'node'.
+ */
+const void *bptrees_first_key_private(const bptree *self, const bpnode *node) {
+	while (!node->is_leaf) {
+		node = bpnodes_children_private(self, node)[0];
+	}
+
+	return bpnodes_key_private(self, node, 0);
+}
+
+bptree bptrees_init(size_t key_size, size_t value_size, orderfunc compare) {
+	#if cels_debug
+		errors_abort("key_size", key_size == 0);
+		errors_abort("compare", !compare);
+	#endif
+
+	size_t order = bptree_node_size / key_size;
+	if (order < 4) { order = 4; }
+
+	/* word-aligned like every other node, as arenas don't align further */
+	size_t alignment = sizeof(void *);
+	size_t keys_size = order * key_size;
+	size_t tail_offset = (keys_size + alignment - 1) / alignment * alignment;
+
+	size_t values_size = order * value_size;
+	size_t children_size = (order + 1) * sizeof(bpnode *);
+	size_t tail_size = values_size > children_size ? values_size : children_size;
+	tail_size = (tail_size + alignment - 1) / alignment * alignment;
+
+	return (bptree){
+		.key_size=key_size,
+		.value_size=value_size,
+		.order=order,
+		.node_size=sizeof(bpnode) + tail_offset + tail_size,
+		.tail_offset=tail_offset,
+		.compare=compare,
+	};
+}
+
+bool bptrees_check(const bptree *self) {
+	if (!self || !self->compare || self->order < 4) { return true; }
+
+	if (!self->data) {
+		return self->size != 0 || self->height != 0 || self->first;
+	}
+
+	size_t size = 0;
+	const bpnode *leaf = self->first;
+
+	bool is_invalid = bpnodes_check_private(
+		self, self->data, null, null, 0, &size, &leaf);
+
+	return is_invalid || leaf || size != self->size;
+}
+
+void *bptrees_get(const bptree *self, const void *key) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", !key);
+	#endif
+
+	if (!self->data) { return null; }
+
+	bpnode *node = self->data;
+	while (!node->is_leaf) {
+		size_t index = bpnodes_upper_private(self, node, key);
+		node = bpnodes_children_private(self, node)[index];
+	}
+
+	size_t index = bpnodes_lower_private(self, node, key);
+	if (index == node->size) { return null; }
+
+	const void *found = bpnodes_key_private(self, node, index);
+	if (self->compare(found, key) != 0) { return null; }
+
+	return bpnodes_value_private(self, node, index);
+}
+
+error bptrees_push(
+	bptree *self, const void *key, const void *value, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", !key);
+		errors_abort("value", !value && self->value_size > 0);
+	#endif
+
+	if (!self->data) {
+		bpnode *leaf = mems_alloc(mem, self->node_size);
+		if (!leaf) { return fail; }
+
+		*leaf = (bpnode){.is_leaf=true};
+		bpnodes_insert_leaf_private(self, leaf, 0, key, value);
+
+		self->data = leaf;
+		self->first = leaf;
+		self->height = 1;
+		self->size = 1;
+
+		return ok;
+	}
+
+	bptree_step path[bptree_max_height];
+	size_t depth = bptrees_descend_private(self, key, path);
+
+	bpnode *leaf = path[depth].node;
+	size_t index = bpnodes_lower_private(self, leaf, key);
+
+	bool is_present = 
+		index < leaf->size && 
+		self->compare(bpnodes_key_private(self, leaf, index), key) == 0;
+
+	if (is_present) {
+		if (value) {
+			memcpy(bpnodes_value_private(self, leaf, index), value, self->value_size);
+		}
+
+		return ok;
+	}
+
+	if (leaf->size < self->order) {
+		bpnodes_insert_leaf_private(self, leaf, index, key, value);
+		++self->size;
+
+		return ok;
+	}
+
+	/* every full node up the path splits, so new nodes are taken upfront */
+
+	size_t splits = 0;
+	while (splits <= depth && path[depth - splits].node->size == self->order) {
+		++splits;
+	}
+
+	size_t needed = splits + (splits > depth);
+
+	#if cels_debug
+		errors_abort("self.height", self->height + (splits > depth) > bptree_max_height);
+	#endif
+
+	bpnode *spares[bptree_max_height + 1] = {0};
+	for (size_t i = 0; i < needed; i++) {
+		spares[i] = mems_alloc(mem, self->node_size);
+		if (spares[i]) { continue; }
+
+		for (size_t j = 0; j < i; j++) {
+			mems_dealloc(mem, spares[j], self->node_size);
+		}
+
+		return fail;
+	}
+
+
+	/* splitting the leaf */
+
+	size_t middle = self->order / 2;
+	bpnode *right = spares[0];
+	*right = (bpnode){.is_leaf=true, .size=leaf->size - middle, .next=leaf->next};
+
+	memcpy(
+		bpnodes_key_private(self, right, 0), 
+		bpnodes_key_private(self, leaf, middle), 
+		right->size * self->key_size);
+
+	memcpy(
+		bpnodes_value_private(self, right, 0), 
+		bpnodes_value_private(self, leaf, middle), 
+		right->size * self->value_size);
+
+	leaf->size = middle;
+	leaf->next = right;
+
+	if (index <= middle) {
+		bpnodes_insert_leaf_private(self, leaf, index, key, value);
+	} else {
+		bpnodes_insert_leaf_private(self, right, index - middle, key, value);
+	}
+
+	++self->size;
+
+
+	/* carrying separators up */
+
+	char carry[self->key_size];
+	char promoted[self->key_size];
+	memcpy(carry, bpnodes_key_private(self, right, 0), self->key_size);
+
+	bpnode *child = right;
+	size_t used = 1;
+
+	for (size_t level = depth; level-- > 0;) {
+		bpnode *node = path[level].node;
+		size_t position = path[level].index;
+
+		if (node->size < self->order) {
+			bpnodes_insert_branch_private(self, node, position, carry, child);
+			return ok;
+		}
+
+		bpnode *sibling = spares[used++];
+		*sibling = (bpnode){.size=self->order - middle - 1};
+
+		memcpy(promoted, bpnodes_key_private(self, node, middle), self->key_size);
+
+		memcpy(
+			bpnodes_key_private(self, sibling, 0), 
+			bpnodes_key_private(self, node, middle + 1), 
+			sibling->size * self->key_size);
+
+		memcpy(
+			bpnodes_children_private(self, sibling), 
+			bpnodes_children_private(self, node) + middle + 1, 
+			(sibling->size + 1) * sizeof(bpnode *));
+
+		node->size = middle;
+
+		if (position <= middle) {
+			bpnodes_insert_branch_private(self, node, position, carry, child);
+		} else {
+			bpnodes_insert_branch_private(
+				self, sibling, position - middle - 1, carry, child);
+		}
+
+		memcpy(carry, promoted, self->key_size);
+		child = sibling;
+	}
+
+
+	/* growing a new root */
+
+	bpnode *root = spares[used];
+	*root = (bpnode){.size=1};
+
+	memcpy(bpnodes_key_private(self, root, 0), carry, self->key_size);
+	bpnodes_children_private(self, root)[0] = self->data;
+	bpnodes_children_private(self, root)[1] = child;
+
+	self->data = root;
+	++self->height;
+
+	return ok;
+}
+
+error bptrees_remove(
+	bptree *self, const void *key, void *value, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", !key);
+	#endif
+
+	if (!self->data) { return fail; }
+
+	bptree_step path[bptree_max_height];
+	size_t depth = bptrees_descend_private(self, key, path);
+
+	bpnode *leaf = path[depth].node;
+	size_t index = bpnodes_lower_private(self, leaf, key);
+
+	bool is_present = 
+		index < leaf->size && 
+		self->compare(bpnodes_key_private(self, leaf, index), key) == 0;
+
+	if (!is_present) { return fail; }
+
+	if (value) {
+		memcpy(value, bpnodes_value_private(self, leaf, index), self->value_size);
+	}
+
+	bpnodes_erase_private(self, leaf, index);
+	--self->size;
+
+	if (depth == 0) {
+		if (leaf->size == 0) {
+			mems_dealloc(mem, leaf, self->node_size);
+
+			self->data = null;
+			self->first = null;
+			self->height = 0;
+		}
+
+		return ok;
+	}
+
+
+	/* rebalancing upwards */
+
+	for (size_t level = depth; level > 0; level--) {
+		bpnode *node = path[level].node;
+
+		size_t minimum = node->is_leaf ? self->order / 2 : (self->order - 1) / 2;
+		if (node->size >= minimum) { return ok; }
+
+		bpnode *parent = path[level - 1].node;
+		size_t position = path[level - 1].index;
+		bpnode **siblings = bpnodes_children_private(self, parent);
+
+		bpnode *left = position > 0 ? siblings[position - 1] : null;
+		bpnode *right = position < parent->size ? siblings[position + 1] : null;
+
+		if (left && left->size > minimum) {
+			bpnodes_borrow_left_private(self, node, left, parent, position);
+			return ok;
+		} 
+		
+		if (right && right->size > minimum) {
+			bpnodes_borrow_right_private(self, node, right, parent, position);
+			return ok;
+		} 
+		
+		if (left) {
+			bpnodes_merge_private(self, left, node, parent, position - 1, mem);
+		} else {
+			bpnodes_merge_private(self, node, right, parent, position, mem);
+		}
+	}
+
+	bpnode *root = self->data;
+	if (root->size == 0) {
+		self->data = bpnodes_children_private(self, root)[0];
+		--self->height;
+
+		mems_dealloc(mem, root, self->node_size);
+	}
+
+	return ok;
+}
+
+error bptrees_load(
+	bptree *self,
+	const void *keys,
+	const void *values,
+	size_t size,
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.data", self->data != null);
+		errors_abort("keys", !keys && size > 0);
+		errors_abort("values", !values && size > 0 && self->value_size > 0);
+
+		for (size_t i = 1; i < size; i++) {
+			const char *previous = (const char *)keys + (i - 1) * self->key_size;
+			const char *key = previous + self->key_size;
+
+			errors_abort("keys (not ascending)", self->compare(previous, key) >= 0);
+		}
+	#endif
+
+	if (size == 0) { return ok; }
+
+
+	/* filling leaves evenly, so none is below the minimum */
+
+	size_t count = (size + self->order - 1) / self->order;
+	bpnode **level = mems_alloc(mem, count * sizeof(bpnode *));
+	if (!level) { return fail; }
+
+	const char *key = keys;
+	const char *value = values;
+	bpnode *previous = null;
+
+	for (size_t i = 0; i < count; i++) {
+		bpnode *leaf = mems_alloc(mem, self->node_size);
+		if (!leaf) {
+			for (size_t j = 0; j < i; j++) {
+				mems_dealloc(mem, level[j], self->node_size);
+			}
+
+			mems_dealloc(mem, level, count * sizeof(bpnode *));
+			return fail;
+		}
+
+		*leaf = (bpnode){.is_leaf=true, .size=size / count + (i < size % count)};
+
+		memcpy(bpnodes_key_private(self, leaf, 0), key, leaf->size * self->key_size);
+		key += leaf->size * self->key_size;
+
+		if (self->value_size > 0) {
+			memcpy(
+				bpnodes_value_private(self, leaf, 0), 
+				value, 
+				leaf->size * self->value_size);
+
+			value += leaf->size * self->value_size;
+		}
+
+		if (previous) { previous->next = leaf; }
+		previous = leaf;
+		level[i] = leaf;
+	}
+
+	bpnode *first = level[0];
+	size_t height = 1;
+
+
+	/* stacking branches the same way */
+
+	while (count > 1) {
+		size_t parents = (count + self->order) / (self->order + 1);
+		bpnode **upper = mems_alloc(mem, parents * sizeof(bpnode *));
+		if (!upper) { goto cleanup; }
+
+		size_t child = 0;
+		for (size_t i = 0; i < parents; i++) {
+			bpnode *branch = mems_alloc(mem, self->node_size);
+			if (!branch) {
+				for (size_t j = 0; j < i; j++) {
+					mems_dealloc(mem, upper[j], self->node_size);
+				}
+
+				mems_dealloc(mem, upper, parents * sizeof(bpnode *));
+				goto cleanup;
+			}
+
+			size_t children_size = count / parents + (i < count % parents);
+			*branch = (bpnode){.size=children_size - 1};
+
+			bpnode **children = bpnodes_children_private(self, branch);
+			for (size_t j = 0; j < children_size; j++) {
+				children[j] = level[child + j];
+
+				if (j == 0) { continue; }
+
+				memcpy(
+					bpnodes_key_private(self, branch, j - 1),
+					bptrees_first_key_private(self, children[j]),
+					self->key_size);
+			}
+
+			child += children_size;
+			upper[i] = branch;
+		}
+
+		mems_dealloc(mem, level, count * sizeof(bpnode *));
+
+		level = upper;
+		count = parents;
+		++height;
+	}
+
+	self->data = level[0];
+	self->first = first;
+	self->height = height;
+	self->size = size;
+
+	mems_dealloc(mem, level, sizeof(bpnode *));
+	return ok;
+
+	cleanup:
+	for (size_t i = 0; i < count; i++) {
+		bpnodes_free_private(self, level[i], null, null, mem);
+	}
+
+	mems_dealloc(mem, level, count * sizeof(bpnode *));
+	return fail;
+}
+
+void bptrees_lower_bound(const bptree *self, const void *key, void *iterator) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", !key);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	bptree_iterator *it = iterator;
+	*it = (bptree_iterator){.internal={.is_started=true}};
+
+	if (!self->data) { return; }
+
+	bptree_step path[bptree_max_height];
+	size_t depth = bptrees_descend_private(self, key, path);
+
+	bpnode *leaf = path[depth].node;
+	it->internal.node = leaf;
+	it->internal.index = bpnodes_lower_private(self, leaf, key);
+}
+
+void bptrees_upper_bound(const bptree *self, const void *key, void *iterator) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", !key);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	bptree_iterator *it = iterator;
+	*it = (bptree_iterator){.internal={.is_started=true}};
+
+	if (!self->data) { return; }
+
+	bptree_step path[bptree_max_height];
+	size_t depth = bptrees_descend_private(self, key, path);
+
+	bpnode *leaf = path[depth].node;
+	it->internal.node = leaf;
+	it->internal.index = bpnodes_upper_private(self, leaf, key);
+}
+
+void bptrees_range(
+	const bptree *self, const void *low, const void *high, void *iterator) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	bptree_iterator *it = iterator;
+
+	if (low) {
+		bptrees_lower_bound(self, low, it);
+	} else {
+		*it = (bptree_iterator){0};
+	}
+
+	it->internal.end = high;
+}
+
+bool bptrees_next(const bptree *self, void *iterator) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	bptree_iterator *it = iterator;
+
+	if (!it->internal.is_started) {
+		it->internal.node = self->first;
+		it->internal.index = 0;
+		it->internal.is_started = true;
+	}
+
+	bpnode *node = it->internal.node;
+	while (node && it->internal.index >= node->size) {
+		node = node->next;
+		it->internal.index = 0;
+	}
+
+	it->internal.node = node;
+	if (!node) { goto cleanup; }
+
+	void *key = bpnodes_key_private(self, node, it->internal.index);
+	const void *end = it->internal.end;
+
+	if (end && self->compare(key, end) >= 0) {
+		it->internal.node = null;
+		goto cleanup;
+	}
+
+	it->key = key;
+	it->value = bpnodes_value_private(self, node, it->internal.index);
+	++it->internal.index;
+
+	return true;
+
+	cleanup:
+	it->key = null;
+	it->value = null;
+	return false;
+}
+
+void bptrees_free(
+	bptree *self,
+	freefunc key_cleaner,
+	freefunc value_cleaner,
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->data) {
+		bpnodes_free_private(self, self->data, key_cleaner, value_cleaner, mem);
+	}
+
+	self->data = null;
+	self->first = null;
+	self->height = 0;
+	self->size = 0;
+}
+
+
+/* shard-maps */
+
+typedef enum shard_map_state {
+	shard_map_empty_state,
+	shard_map_full_state,
+	shard_map_removed_state,
+} shard_map_state;
+
+typedef struct shard_map_entry {
+	size_t hash;
+	size_t state;
+	char value[];
+} shard_map_entry;
+
+static inline size_t shard_maps_mix_private(size_t hash) {
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+static inline shard_map_shard *shard_maps_shard_private(
+	const shard_map *self, size_t mixed) {
+
+	return &self->shards[(mixed >> self->shift) & (self->shards_size - 1)];
+}
+
+static inline shard_map_entry *shard_maps_entry_private(
+	const shard_map *self, const shard_map_table *table, size_t index) {
+
+	return (shard_map_entry *)((char *)table->data + index * self->entry_size);
+}
+
+static inline void shard_maps_lock_private(shard_map_shard *shard) {
+	pthread_mutex_lock(&shard->lock);
+
+	size_t sequence = shard->sequence;
+	__atomic_store_n(&shard->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void shard_maps_unlock_private(shard_map_shard *shard) {
+	size_t sequence = shard->sequence;
+	__atomic_store_n(&shard->sequence, sequence + 1, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&shard->lock);
+}
+
+/*
+ * Finds the entry of 'hash', else null,
+ * setting 'vacant' to the first slot
+ * an insertion may take.
+ */
+shard_map_entry *shard_maps_find_private(
+	const shard_map *self,
+	const shard_map_table *table,
+	size_t hash,
+	size_t mixed,
+	shard_map_entry **vacant) {
+
+	*vacant = null;
+	if (!table) { return null; }
+
+	size_t mask = table->capacity - 1;
+	for (size_t i = 0; i < table->capacity; i++) {
+		shard_map_entry *entry = 
+			shard_maps_entry_private(self, table, (mixed + i) & mask);
+
+		if (entry->state == shard_map_empty_state) {
+			if (!*vacant) { *vacant = entry; }
+			return null;
+		} else if (entry->state == shard_map_removed_state) {
+			if (!*vacant) { *vacant = entry; }
+		} else if (entry->hash == hash) {
+			return entry;
+		}
+	}
+
+	return null;
+}
+
+/*
+ * Gets the capacity keeping the shard 
+ * at most half full after an insertion.
+ */
+static inline size_t shard_maps_capacity_private(const shard_map_shard *shard) {
+	size_t capacity = 16;
+	while ((shard->size + 1) * 2 > capacity) {
+		capacity *= 2;
+	}
+
+	return capacity;
+}
+
+/*
+ * Places the full entry 'entry' in 
+ * the first empty slot of 'table'.
+ */
+void shard_maps_place_private(
+	const shard_map *self, shard_map_table *table, const shard_map_entry *entry) {
+
+	size_t mask = table->capacity - 1;
+	size_t mixed = shard_maps_mix_private(entry->hash);
+
+	for (size_t i = 0; i < table->capacity; i++) {
+		shard_map_entry *other = 
+			shard_maps_entry_private(self, table, (mixed + i) & mask);
+
+		if (other->state == shard_map_empty_state) {
+			memcpy(other, entry, self->entry_size);
+			return;
+		}
+	}
+}
+
+/*
+ * Drops the tombstones of the shard 
+ * by placing its entries again in the 
+ * same table - readers retry meanwhile
+ * as the shard's sequence is odd.
+ */
+error shard_maps_purge_private(
+	shard_map *self, shard_map_shard *shard, const allocator *mem) {
+
+	shard_map_table *table = shard->table;
+	size_t entries_size = shard->size * self->entry_size;
+
+	char *entries = null;
+	if (entries_size) {
+		entries = mems_alloc(mem, entries_size);
+		if (!entries) { return fail; }
+	}
+
+	size_t size = 0;
+	for (size_t i = 0; i < table->capacity; i++) {
+		shard_map_entry *entry = shard_maps_entry_private(self, table, i);
+		if (entry->state != shard_map_full_state) { continue; }
+
+		memcpy(entries + size * self->entry_size, entry, self->entry_size);
+		++size;
+	}
+
+	memset(table->data, 0, table->capacity * self->entry_size);
+
+	for (size_t i = 0; i < size; i++) {
+		shard_map_entry *entry = 
+			(shard_map_entry *)(entries + i * self->entry_size);
+
+		shard_maps_place_private(self, table, entry);
+	}
+
+	if (entries) {
+		mems_dealloc(mem, entries, entries_size);
+	}
+
+	shard->removed = 0;
+	return ok;
+}
+
+/*
+ * Moves the entries of the shard to a 
+ * table at most half full, publishing 
+ * it and keeping the old one alive.
+ */
+error shard_maps_grow_private(
+	shard_map *self, shard_map_shard *shard, const allocator *mem) {
+
+	size_t capacity = shard_maps_capacity_private(shard);
+
+	shard_map_table *table = 
+		mems_alloc(mem, sizeof(shard_map_table) + capacity * self->entry_size);
+
+	if (!table) { return fail; }
+
+	memset(table->data, 0, capacity * self->entry_size);
+	table->capacity = capacity;
+	table->next = shard->table;
+
+	shard_map_table *old = shard->table;
+	for (size_t i = 0; old && i < old->capacity; i++) {
+		shard_map_entry *entry = shard_maps_entry_private(self, old, i);
+		if (entry->state != shard_map_full_state) { continue; }
+
+		shard_maps_place_private(self, table, entry);
+	}
+
+	__atomic_store_n(&shard->table, table, __ATOMIC_RELEASE);
+	shard->removed = 0;
+
+	return ok;
+}
+
+error shard_maps_put_private(
+	shard_map *self,
+	size_t hash,
+	const void *value,
+	void *old,
+	bool is_replacing,
+	const allocator *mem) {
+
+	size_t mixed = shard_maps_mix_private(hash);
+	shard_map_shard *shard = shard_maps_shard_private(self, mixed);
+	shard_maps_lock_private(shard);
+
+	shard_map_entry *vacant = null;
+	shard_map_entry *entry = 
+		shard_maps_find_private(self, shard->table, hash, mixed, &vacant);
+
+	if (entry) {
+		if (!is_replacing) { goto cleanup0; }
+
+		if (old) { memcpy(old, entry->value, self->value_size); }
+		memcpy(entry->value, value, self->value_size);
+
+		shard_maps_unlock_private(shard);
+		return ok;
+	}
+
+	/* only outgrowing the table makes a new one, tombstones are purged */
+	size_t capacity = shard->table ? shard->table->capacity : 0;
+	if ((shard->size + shard->removed + 1) * 4 > capacity * 3) {
+		error grow_error = shard_maps_capacity_private(shard) > capacity ? 
+			shard_maps_grow_private(self, shard, mem) :
+			shard_maps_purge_private(self, shard, mem);
+
+		if (grow_error) { goto cleanup0; }
+		shard_maps_find_private(self, shard->table, hash, mixed, &vacant);
+	}
+
+	if (vacant->state == shard_map_removed_state) {
+		--shard->removed;
+	}
+
+	memcpy(vacant->value, value, self->value_size);
+	__atomic_store_n(&vacant->hash, hash, __ATOMIC_RELAXED);
+	__atomic_store_n(&vacant->state, shard_map_full_state, __ATOMIC_RELAXED);
+	__atomic_store_n(&shard->size, shard->size + 1, __ATOMIC_RELAXED);
+
+	shard_maps_unlock_private(shard);
+	return ok;
+
+	cleanup0:
+	shard_maps_unlock_private(shard);
+	return fail;
+}
+
+error shard_maps_init(
+	shard_map *self, size_t value_size, size_t shards, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (shards == 0) { 
+		shards = shard_map_shards; 
+	}
+
+	size_t bits = 0;
+	while (((size_t)1 << bits) < shards) {
+		++bits;
+	}
+
+	*self = (shard_map){
+		.value_size=value_size,
+		.entry_size=sizeof(shard_map_entry) + 
+			(value_size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t),
+		.shards_size=(size_t)1 << bits,
+		.shift=bits ? sizeof(size_t) * 8 - bits : 0,
+	};
+
+	/* aligned by hand, so each shard sits in its own lines */
+	size_t shards_size = self->shards_size * sizeof(shard_map_shard) + node_line_size;
+	self->block = mems_alloc(mem, shards_size);
+	if (!self->block) { return fail; }
+
+	uintptr_t start = (uintptr_t)self->block + node_line_size - 1;
+	self->shards = (shard_map_shard *)(start - start % node_line_size);
+
+	for (size_t i = 0; i < self->shards_size; i++) {
+		self->shards[i] = (shard_map_shard){0};
+		pthread_mutex_init(&self->shards[i].lock, null);
+	}
+
+	return ok;
+}
+
+bool shard_maps_get(const shard_map *self, size_t hash, void *value) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.shards", !self->shards);
+	#endif
+
+	size_t mixed = shard_maps_mix_private(hash);
+	shard_map_shard *shard = shard_maps_shard_private(self, mixed);
+
+	while (true) {
+		size_t sequence = __atomic_load_n(&shard->sequence, __ATOMIC_ACQUIRE);
+		if (sequence & 1) { 
+			sched_yield();
+			continue; 
+		}
+
+		bool is_found = false;
+		shard_map_table *table = __atomic_load_n(&shard->table, __ATOMIC_ACQUIRE);
+
+		size_t capacity = table ? table->capacity : 0;
+		for (size_t i = 0; i < capacity; i++) {
+			shard_map_entry *entry = 
+				shard_maps_entry_private(self, table, (mixed + i) & (capacity - 1));
+
+			size_t state = __atomic_load_n(&entry->state, __ATOMIC_RELAXED);
+			size_t other = __atomic_load_n(&entry->hash, __ATOMIC_RELAXED);
+
+			if (state == shard_map_empty_state) {
+				break;
+			} else if (state == shard_map_full_state && other == hash) {
+				if (value) { memcpy(value, entry->value, self->value_size); }
+				is_found = true;
+				break;
+			}
+		}
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&shard->sequence, __ATOMIC_RELAXED) == sequence) {
+			return is_found;
+		}
+	}
+}
+
+error shard_maps_insert(
+	shard_map *self, size_t hash, const void *value, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.shards", !self->shards);
+		errors_abort("value", !value && self->value_size);
+	#endif
+
+	return shard_maps_put_private(self, hash, value, null, false, mem);
+}
+
+error shard_maps_upsert(
+	shard_map *self,
+	size_t hash,
+	const void *value,
+	void *old,
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.shards", !self->shards);
+		errors_abort("value", !value && self->value_size);
+	#endif
+
+	return shard_maps_put_private(self, hash, value, old, true, mem);
+}
+
+error shard_maps_remove(shard_map *self, size_t hash, void *value) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.shards", !self->shards);
+	#endif
+
+	size_t mixed = shard_maps_mix_private(hash);
+	shard_map_shard *shard = shard_maps_shard_private(self, mixed);
+	shard_maps_lock_private(shard);
+
+	shard_map_entry *vacant = null;
+	shard_map_entry *entry = 
+		shard_maps_find_private(self, shard->table, hash, mixed, &vacant);
+
+	if (!entry) {
+		shard_maps_unlock_private(shard);
+		return fail;
+	}
+
+	if (value) { memcpy(value, entry->value, self->value_size); }
+
+	__atomic_store_n(&entry->state, shard_map_removed_state, __ATOMIC_RELAXED);
+	__atomic_store_n(&shard->size, shard->size - 1, __ATOMIC_RELAXED);
+	++shard->removed;
+
+	shard_maps_unlock_private(shard);
+	return ok;
+}
+
+size_t shard_maps_size(const shard_map *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	size_t size = 0;
+	for (size_t i = 0; i < self->shards_size; i++) {
+		size += __atomic_load_n(&self->shards[i].size, __ATOMIC_RELAXED);
+	}
+
+	return size;
+}
+
+error shard_maps_snapshot(
+	shard_map *self, shard_map_snapshot *snapshot, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("snapshot", !snapshot);
+	#endif
+
+	*snapshot = (shard_map_snapshot){.entry_size=self->entry_size};
+
+	for (size_t i = 0; i < self->shards_size; i++) {
+		shard_map_shard *shard = &self->shards[i];
+		pthread_mutex_lock(&shard->lock);
+
+		if (snapshot->size + shard->size > snapshot->capacity) {
+			size_t capacity = (snapshot->size + shard->size) * 2;
+
+			char *data = mems_realloc(
+				mem, 
+				snapshot->data, 
+				snapshot->capacity * self->entry_size, 
+				capacity * self->entry_size);
+
+			if (!data) { 
+				pthread_mutex_unlock(&shard->lock);
+				goto cleanup0; 
+			}
+
+			snapshot->data = data;
+			snapshot->capacity = capacity;
+		}
+
+		shard_map_table *table = shard->table;
+		for (size_t j = 0; table && j < table->capacity; j++) {
+			shard_map_entry *entry = shard_maps_entry_private(self, table, j);
+			if (entry->state != shard_map_full_state) { continue; }
+
+			char *destination = snapshot->data + snapshot->size * self->entry_size;
+			memcpy(destination, entry, self->entry_size);
+			++snapshot->size;
+		}
+
+		pthread_mutex_unlock(&shard->lock);
+	}
+
+	return ok;
+
+	cleanup0:
+	shard_map_snapshots_free(snapshot, mem);
+	return fail;
+}
+
+bool shard_map_snapshots_next(const shard_map_snapshot *self, void *iterator) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("iterator", !iterator);
+	#endif
+
+	shard_map_iterator *it = iterator;
+
+	if (it->internal.index >= self->size) {
+		it->hash = 0;
+		it->value = null;
+		return false;
+	}
+
+	shard_map_entry *entry = 
+		(shard_map_entry *)(self->data + it->internal.index * self->entry_size);
+
+	it->hash = entry->hash;
+	it->value = entry->value;
+	++it->internal.index;
+
+	return true;
+}
+
+void shard_map_snapshots_free(shard_map_snapshot *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->data) {
+		mems_dealloc(mem, self->data, self->capacity * self->entry_size);
+	}
+
+	self->data = null;
+	self->size = 0;
+	self->capacity = 0;
+}
+
+void shard_maps_free(shard_map *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	for (size_t i = 0; self->shards && i < self->shards_size; i++) {
+		shard_map_shard *shard = &self->shards[i];
+
+		shard_map_table *table = shard->table;
+		while (table) {
+			shard_map_table *next = table->next;
+			size_t size = sizeof(shard_map_table) + table->capacity * self->entry_size;
+
+			mems_dealloc(mem, table, size);
+			table = next;
+		}
+
+		pthread_mutex_destroy(&shard->lock);
+	}
+
+	if (self->block) {
+		size_t shards_size = 
+			self->shards_size * sizeof(shard_map_shard) + node_line_size;
+
+		mems_dealloc(mem, self->block, shards_size);
+	}
+
+	self->block = null;
+	self->shards = null;
+	self->shards_size = 0;
+}
+
+
+/* rings */
+
+typedef struct ring_cell {
+	size_t sequence;
+	char item[];
+} ring_cell;
+
+static inline size_t rings_capacity_private(size_t capacity) {
+	size_t result = 2;
+	while (result < capacity) {
+		result *= 2;
+	}
+
+	return result;
+}
+
+static inline ring_cell *rings_cell_private(const ring *self, size_t position) {
+	size_t index = position & (self->capacity - 1);
+	return (ring_cell *)(self->data + index * self->cell_size);
+}
+
+error rings_init(
+	ring *self, size_t item_size, size_t capacity, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	*self = (ring){0};
+	self->capacity = rings_capacity_private(capacity);
+	self->item_size = item_size;
+	self->cell_size = sizeof(ring_cell) + 
+		(item_size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+
+	self->data = mems_alloc(mem, self->capacity * self->cell_size);
+	if (!self->data) { return fail; }
+
+	for (size_t i = 0; i < self->capacity; i++) {
+		rings_cell_private(self, i)->sequence = i;
+	}
+
+	return ok;
+}
+
+error rings_try_push(ring *self, const void *item) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.data", !self->data);
+	#endif
+
+	ring_cell *cell = null;
+	size_t position = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+
+	while (true) {
+		cell = rings_cell_private(self, position);
+
+		size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+		if (difference == 0) {
+			bool is_claimed = __atomic_compare_exchange_n(
+				&self->head, 
+				&position, 
+				position + 1, 
+				true, 
+				__ATOMIC_RELAXED, 
+				__ATOMIC_RELAXED);
+
+			if (is_claimed) { break; }
+		} else if (difference < 0) {
+			return fail;
+		} else {
+			position = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(cell->item, item, self->item_size);
+	__atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+
+	return ok;
+}
+
+error rings_try_pop(ring *self, void *item) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.data", !self->data);
+	#endif
+
+	ring_cell *cell = null;
+	size_t position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+
+	while (true) {
+		cell = rings_cell_private(self, position);
+
+		size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+		if (difference == 0) {
+			bool is_claimed = __atomic_compare_exchange_n(
+				&self->tail, 
+				&position, 
+				position + 1, 
+				true, 
+				__ATOMIC_RELAXED, 
+				__ATOMIC_RELAXED);
+
+			if (is_claimed) { break; }
+		} else if (difference < 0) {
+			return fail;
+		} else {
+			position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy(item, cell->item, self->item_size);
+	__atomic_store_n(
+		&cell->sequence, position + self->capacity, __ATOMIC_RELEASE);
+
+	return ok;
+}
+
+void rings_push(ring *self, const void *item) {
+	while (rings_try_push(self, item)) {
+		sched_yield();
+	}
+}
+
+void rings_pop(ring *self, void *item) {
+	while (rings_try_pop(self, item)) {
+		sched_yield();
+	}
+}
+
+size_t rings_push_batch(ring *self, const void *items, size_t size) {
+	#if cels_debug
+		errors_abort("items", !items && size);
+	#endif
+
+	const char *item = items;
+
+	size_t i = 0;
+	for (; i < size; i++) {
+		if (rings_try_push(self, item + i * self->item_size)) { break; }
+	}
+
+	return i;
+}
+
+size_t rings_pop_batch(ring *self, void *items, size_t size) {
+	#if cels_debug
+		errors_abort("items", !items && size);
+	#endif
+
+	char *item = items;
+
+	size_t i = 0;
+	for (; i < size; i++) {
+		if (rings_try_pop(self, item + i * self->item_size)) { break; }
+	}
+
+	return i;
+}
+
+size_t rings_size(const ring *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	size_t tail = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+	size_t head = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+
+	return head > tail ? head - tail : 0;
+}
+
+void rings_free(ring *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->data) {
+		mems_dealloc(mem, self->data, self->capacity * self->cell_size);
+	}
+
+	self->data = null;
+	self->head = 0;
+	self->tail = 0;
+}
+
+
+/* spsc-rings */
+
+/*
+ * Copies 'size' items between 'items' 
+ * and the spsc-ring from 'position', 
+ * wrapping around its end.
+ */
+void spsc_rings_copy_private(
+	spsc_ring *self, size_t position, void *items, size_t size, bool is_pushing) {
+
+	size_t index = position & (self->capacity - 1);
+	size_t first = self->capacity - index < size ? self->capacity - index : size;
+
+	size_t first_size = first * self->item_size;
+	size_t rest_size = (size - first) * self->item_size;
+
+	char *slot = self->data + index * self->item_size;
+	char *item = items;
+
+	if (is_pushing) {
+		memcpy(slot, item, first_size);
+		memcpy(self->data, item + first_size, rest_size);
+	} else {
+		memcpy(item, slot, first_size);
+		memcpy(item + first_size, self->data, rest_size);
+	}
+}
+
+error spsc_rings_init(
+	spsc_ring *self, size_t item_size, size_t capacity, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	*self = (spsc_ring){0};
+	self->capacity = rings_capacity_private(capacity);
+	self->item_size = item_size;
+
+	self->data = mems_alloc(mem, self->capacity * self->item_size);
+	if (!self->data) { return fail; }
+
+	return ok;
+}
+
+size_t spsc_rings_push_batch(spsc_ring *self, const void *items, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.data", !self->data);
+		errors_abort("items", !items && size);
+	#endif
+
+	size_t head = self->head;
+	if (self->capacity - (head - self->tail_cache) < size) {
+		self->tail_cache = __atomic_load_n(&self->tail, __ATOMIC_ACQUIRE);
+	}
+
+	size_t vacant = self->capacity - (head - self->tail_cache);
+	if (size > vacant) { 
+		size = vacant; 
+	}
+
+	if (size == 0) { return 0; }
+
+	spsc_rings_copy_private(self, head, (void *)items, size, true);
+	__atomic_store_n(&self->head, head + size, __ATOMIC_RELEASE);
+
+	return size;
+}
+
+size_t spsc_rings_pop_batch(spsc_ring *self, void *items, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("self.data", !self->data);
+		errors_abort("items", !items && size);
+	#endif
+
+	size_t tail = self->tail;
+	if (self->head_cache - tail < size) {
+		self->head_cache = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+	}
+
+	size_t used = self->head_cache - tail;
+	if (size > used) { 
+		size = used; 
+	}
+
+	if (size == 0) { return 0; }
+
+	spsc_rings_copy_private(self, tail, items, size, false);
+	__atomic_store_n(&self->tail, tail + size, __ATOMIC_RELEASE);
+
+	return size;
+}
+
+error spsc_rings_try_push(spsc_ring *self, const void *item) {
+	return spsc_rings_push_batch(self, item, 1) == 1 ? ok : fail;
+}
+
+error spsc_rings_try_pop(spsc_ring *self, void *item) {
+	return spsc_rings_pop_batch(self, item, 1) == 1 ? ok : fail;
+}
+
+void spsc_rings_push(spsc_ring *self, const void *item) {
+	while (spsc_rings_try_push(self, item)) {
+		sched_yield();
+	}
+}
+
+void spsc_rings_pop(spsc_ring *self, void *item) {
+	while (spsc_rings_try_pop(self, item)) {
+		sched_yield();
+	}
+}
+
+void spsc_rings_free(spsc_ring *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->data) {
+		mems_dealloc(mem, self->data, self->capacity * self->item_size);
+	}
+
+	self->data = null;
+	self->head = 0;
+	self->tail = 0;
 }
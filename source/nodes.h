@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
 #include "mems.h"
 #include "errors.h"
 
@@ -16,6 +18,15 @@
  */
 
 
+/* 
+ * bytes data shared by threads is padded to,
+ * two cache-lines for the adjacent prefetcher
+ */
+#ifndef node_line_size
+#define node_line_size 128
+#endif
+
+
 /* binodes and bitrees */
 
 /*
@@ -42,6 +53,8 @@
 		size_t node_size; \
 		size_t extra_size; \
 		type0 *data; \
+		/* removed nodes kept for reuse, linked by 'right' */ \
+		type0 *freed; \
 	}
 
 #define bitree_iterators(type0) \
@@ -59,15 +72,11 @@ typedef enum binode_color {
 
 typedef enum bitree_iterator_state {
 	bitree_initial_iterator_state,
-	bitree_left_most_iterator_state,
-	bitree_right_most_iterator_state,
 	bitree_returning_node_iterator_state,
 	bitree_finished_iterator_state,
 } bitree_iterator_state;
 
 typedef struct bitree_iterator_internal {
-	binode *left;
-	binode *right;
 	binode *prev;
 	bitree_iterator_state state;
 } bitree_iterator_internal;
@@ -118,12 +127,29 @@ error bitrees_push(
  */
 void* bitrees_get(const void *self, size_t hash);
 
+/*
+ * Removes node with hash, calling 'cleaner' 
+ * (if not null) on its data, and keeps the 
+ * node to be reused by later pushes.
+ *
+ * 'self' must be a bitree-like structure.
+ *
+ * Returns fail if hash is absent.
+ *
+ * #to-review
+ */
+error bitrees_remove(
+	void *self, size_t hash, freefunc cleaner, const allocator *mem);
+
 /*
  * Iterates self in-order executing callback.
  *
  * 'self' must be a bitree-like structure and 
  * 'iterator' a bitree-iterator-like one.
  *
+ * Removing the current node invalidates 
+ * the iterator.
+ *
  * #to-review
  */
 bool bitrees_next(const void *self, void *iterator);
@@ -238,6 +264,114 @@ void mutrees_free(
 	void *self, freefunc cleaner, const allocator *mem);
 
 
+/* mutree-compacts */
+
+/*
+ * A frozen mutree laid out in pre-order 
+ * in a single array, linked by 32-bit 
+ * indexes instead of pointers - so walking
+ * it is walking memory forward.
+ *
+ * Besides parent, sibling (left) and first 
+ * child (down), each cell links the next
+ * cell breadth-wise, so neither iterator
+ * allocates.
+ */
+
+/* index that links no cell */
+#define mutree_compact_none UINT32_MAX
+
+#define mucells(name, type0) \
+	struct name { \
+		uint32_t parent; \
+		uint32_t left; \
+		uint32_t down; \
+		uint32_t next; \
+		type0 data; \
+	}
+
+#define mutree_compacts(type0) \
+	struct { \
+		type0 *data; \
+		size_t size; \
+		size_t cell_size; \
+	}
+
+#define mutree_compact_iterators(type0) \
+	struct { \
+		type0 *data; \
+		mutree_compact_iterator_internal internal; \
+	}
+
+typedef struct mucell mucell;
+typedef mucells(mucell, void *) mucell;
+typedef mutree_compacts(mucell) mutree_compact;
+
+typedef struct mutree_compact_iterator_internal {
+	uint32_t index;
+	bool is_started;
+} mutree_compact_iterator_internal;
+
+typedef mutree_compact_iterators(mucell) mutree_compact_iterator;
+
+/*
+ * Initializes mutree-compact.
+ *
+ * #to-review
+ */
+#define mutree_compacts_init(self) { \
+	self.cell_size = sizeof(*self.data); \
+}
+
+/*
+ * Lays 'self' out into 'compact', in
+ * pre-order, copying the data of each
+ * node shallowly - so it is owned by
+ * whichever tree frees it.
+ *
+ * 'self' must be a mutree-like structure,
+ * while 'compact' shall be an initialized 
+ * mutree-compact-like one, of the same data.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error mutrees_compact(const void *self, void *compact, const allocator *mem);
+
+/*
+ * Iterates through 'self' pre-order.
+ *
+ * 'self' must be a mutree-compact-like 
+ * structure, while 'iterator' shall be a 
+ * mutree-compact-iterator-like one.
+ *
+ * #to-review
+ */
+bool mutree_compacts_next(const void *self, void *iterator);
+
+/*
+ * Iterates through 'self' breadth-wise.
+ *
+ * 'self' must be a mutree-compact-like 
+ * structure, while 'iterator' shall be a 
+ * mutree-compact-iterator-like one.
+ *
+ * #to-review
+ */
+bool mutree_compacts_next_breadth_wise(const void *self, void *iterator);
+
+/*
+ * Frees mutree-compact, but not the
+ * data of its cells.
+ *
+ * 'self' must be a mutree-compact-like 
+ * structure.
+ *
+ * #to-review
+ */
+void mutree_compacts_free(void *self, const allocator *mem);
+
+
 /* sets*/
 
 #define sets(name, type0) \
@@ -307,6 +441,22 @@ void *sets_get(const void *self, size_t hash);
 error sets_push(
 	void *self, void *item, size_t hash, const allocator *mem);
 
+/*
+ * Removes item from set provided item's hash.
+ *
+ * 'self' must be a set-like structure.
+ *
+ * A 'cleaner' may be provided to free the 
+ * underlying data, while the node is kept 
+ * for later pushes.
+ *
+ * Returns fail if hash is absent.
+ *
+ * #to-review
+ */
+error sets_remove(
+	void *self, size_t hash, freefunc cleaner, const allocator *mem);
+
 /*
  * Frees set.
  *
@@ -402,6 +552,26 @@ void *maps_get(const void *self, size_t hash);
 error maps_push(
 	void *self, void *item, size_t hash, const allocator *mem);
 
+/*
+ * Removes pair from map provided key's hash.
+ *
+ * 'self' must be a map-like structure.
+ *
+ * A 'key_cleaner' and 'value_cleaner' may be 
+ * provided to free the underlying data, while 
+ * the node is kept for later pushes.
+ *
+ * Returns fail if hash is absent.
+ *
+ * #to-review
+ */
+error maps_remove(
+	void *self, 
+	size_t hash, 
+	freefunc key_cleaner, 
+	freefunc value_cleaner, 
+	const allocator *mem);
+
 /*
  * Frees map.
  *
@@ -419,6 +589,603 @@ void maps_free(
 	const allocator *mem);
 
 
+/* bpnodes and bptrees */
+
+/*
+ * A b+tree ordered by a comparator, keys
+ * and values are copied into wide nodes
+ * (sized by bptree_node_size) and leaves
+ * are linked for in-order scans.
+ */
+
+/* bytes of keys per node, a few cache-lines */
+#ifndef bptree_node_size
+#define bptree_node_size 256
+#endif
+
+/* levels a bptree may reach */
+#define bptree_max_height 32
+
+typedef struct bpnode bpnode;
+
+struct bpnode {
+	bool is_leaf;
+	size_t size;
+	/* next leaf, null on branches */
+	bpnode *next;
+	/* keys then values (on leaves) or children */
+	char data[];
+};
+
+typedef struct bptree {
+	size_t size;
+	size_t height;
+	size_t key_size;
+	size_t value_size;
+	/* maximum keys per node */
+	size_t order;
+	size_t node_size;
+	/* offset of values or children within data */
+	size_t tail_offset;
+	orderfunc compare;
+	bpnode *data;
+	bpnode *first;
+} bptree;
+
+typedef struct bptree_iterator_internal {
+	bpnode *node;
+	size_t index;
+	/* exclusive upper-bound, null if none */
+	const void *end;
+	bool is_started;
+} bptree_iterator_internal;
+
+#define bptree_iterators(type0, type1) \
+	struct { \
+		type0 *key; \
+		type1 *value; \
+		bptree_iterator_internal internal; \
+	}
+
+typedef bptree_iterators(void, void) bptree_iterator;
+
+#define bptrees(name, type0, type1) \
+	typedef bptree name; \
+	typedef bptree_iterators(type0, type1) name##_iterator;
+
+/*
+ * Initializes an empty bptree of keys
+ * sized 'key_size' ordered by 'compare'
+ * holding values sized 'value_size'.
+ *
+ * #to-review
+ */
+cels_warn_unused
+bptree bptrees_init(size_t key_size, size_t value_size, orderfunc compare);
+
+/*
+ * Checks if bptree is correct,
+ * it walks the whole tree.
+ *
+ * #to-review
+ */
+bool bptrees_check(const bptree *self);
+
+/*
+ * Gets the value of 'key', or null if
+ * it is absent.
+ *
+ * #to-review
+ */
+void *bptrees_get(const bptree *self, const void *key);
+
+/*
+ * Pushes a copy of 'key' and 'value',
+ * replacing the value if 'key' is
+ * already there (its old value is
+ * not freed) - 'value' may be null
+ * if 'value_size' is 0.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error bptrees_push(
+	bptree *self, const void *key, const void *value, const allocator *mem);
+
+/*
+ * Removes 'key', copying its value
+ * to 'value' if not null (so it may
+ * be freed).
+ *
+ * Returns fail if 'key' is absent.
+ *
+ * #to-review
+ */
+error bptrees_remove(
+	bptree *self, const void *key, void *value, const allocator *mem);
+
+/*
+ * Loads 'size' keys and values from
+ * arrays sorted by strictly ascending
+ * keys, filling leaves whole.
+ *
+ * 'self' must be empty.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error bptrees_load(
+	bptree *self,
+	const void *keys,
+	const void *values,
+	size_t size,
+	const allocator *mem);
+
+/*
+ * Positions 'iterator' at the first
+ * key not less than 'key'.
+ *
+ * 'iterator' must be bptree-iterator-like.
+ *
+ * #to-review
+ */
+void bptrees_lower_bound(const bptree *self, const void *key, void *iterator);
+
+/*
+ * Positions 'iterator' at the first
+ * key greater than 'key'.
+ *
+ * 'iterator' must be bptree-iterator-like.
+ *
+ * #to-review
+ */
+void bptrees_upper_bound(const bptree *self, const void *key, void *iterator);
+
+/*
+ * Positions 'iterator' to scan keys in
+ * ['low', 'high'), either may be null
+ * to leave that side open - 'high'
+ * must outlive the scan.
+ *
+ * 'iterator' must be bptree-iterator-like.
+ *
+ * #to-review
+ */
+void bptrees_range(
+	const bptree *self, const void *low, const void *high, void *iterator);
+
+/*
+ * Iterates through 'self' in key order,
+ * from the first key if 'iterator'
+ * is zeroed.
+ *
+ * 'iterator' must be bptree-iterator-like.
+ *
+ * If eligible to continue, it returns true.
+ *
+ * #to-review
+ */
+bool bptrees_next(const bptree *self, void *iterator);
+
+/*
+ * Frees bptree.
+ *
+ * A 'key_cleaner' and 'value_cleaner' may be
+ * provided to free the underlying data.
+ *
+ * #to-review
+ */
+void bptrees_free(
+	bptree *self,
+	freefunc key_cleaner,
+	freefunc value_cleaner,
+	const allocator *mem);
+
+
+
+/* shard-maps */
+
+/*
+ * A hash-map safe to share between threads,
+ * split in independently locked shards picked
+ * by bits of the hash - each an open addressed
+ * table of values sized 'value_size'.
+ *
+ * Writers lock their shard, readers don't,
+ * instead retrying while a seqlock tells a
+ * writer was meanwhile in that shard.
+ *
+ * Tables outgrown are kept until the map is
+ * freed, since readers may still be in them,
+ * while tombstones are purged in place.
+ */
+
+/* shards used when none is given */
+#ifndef shard_map_shards
+#define shard_map_shards 16
+#endif
+
+typedef struct shard_map_table shard_map_table;
+
+struct shard_map_table {
+	/* a power of two */
+	size_t capacity;
+	/* previous table, outgrown */
+	shard_map_table *next;
+	/* entries of a hash, a state then the value */
+	char data[];
+};
+
+typedef struct shard_map_shard {
+	pthread_mutex_t lock;
+	/* odd while a writer is in the shard */
+	size_t sequence;
+	shard_map_table *table;
+	size_t size;
+	size_t removed;
+	/* rounds the shard up to a cache-line */
+	char padding[
+		node_line_size - 
+		sizeof(pthread_mutex_t) - 
+		sizeof(shard_map_table *) - 
+		sizeof(size_t) * 3];
+} shard_map_shard;
+
+typedef struct shard_map {
+	size_t value_size;
+	size_t entry_size;
+	/* a power of two */
+	size_t shards_size;
+	size_t shift;
+	/* aligned to node_line_size within 'block' */
+	shard_map_shard *shards;
+	void *block;
+} shard_map;
+
+typedef struct shard_map_snapshot {
+	size_t size;
+	size_t capacity;
+	size_t entry_size;
+	char *data;
+} shard_map_snapshot;
+
+typedef struct shard_map_iterator_internal {
+	size_t index;
+} shard_map_iterator_internal;
+
+#define shard_map_iterators(type0) \
+	struct { \
+		size_t hash; \
+		type0 *value; \
+		shard_map_iterator_internal internal; \
+	}
+
+typedef shard_map_iterators(void) shard_map_iterator;
+
+/*
+ * Initializes a shard-map of values sized
+ * 'value_size' with 'shards' shards, rounded
+ * up to a power of two (0 is shard_map_shards).
+ *
+ * 'mem' must be thread-safe, as every
+ * writer allocates through it.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error shard_maps_init(
+	shard_map *self, size_t value_size, size_t shards, const allocator *mem);
+
+/*
+ * Copies the value of 'hash' to 'value',
+ * if not null, without locking.
+ *
+ * If 'hash' is absent, it returns false.
+ *
+ * #thread-safe #to-review
+ */
+bool shard_maps_get(const shard_map *self, size_t hash, void *value);
+
+/*
+ * Inserts a copy of 'value' under 'hash'.
+ *
+ * Returns fail if 'hash' is already
+ * there or allocation failed.
+ *
+ * #thread-safe #allocates #to-review
+ */
+cels_warn_unused
+error shard_maps_insert(
+	shard_map *self, size_t hash, const void *value, const allocator *mem);
+
+/*
+ * Inserts a copy of 'value' under 'hash',
+ * replacing the value if it is already
+ * there (its old value is copied to 'old'
+ * if not null, so it may be freed).
+ *
+ * #thread-safe #allocates #to-review
+ */
+cels_warn_unused
+error shard_maps_upsert(
+	shard_map *self,
+	size_t hash,
+	const void *value,
+	void *old,
+	const allocator *mem);
+
+/*
+ * Removes 'hash', copying its value
+ * to 'value' if not null (so it may
+ * be freed).
+ *
+ * Returns fail if 'hash' is absent.
+ *
+ * #thread-safe #to-review
+ */
+error shard_maps_remove(shard_map *self, size_t hash, void *value);
+
+/*
+ * Gets the ammount of entries, which may
+ * be stale while writers are running.
+ *
+ * #thread-safe #to-review
+ */
+size_t shard_maps_size(const shard_map *self);
+
+/*
+ * Copies every entry to 'snapshot', one
+ * shard locked at a time - so each shard
+ * is consistent but not the whole map.
+ *
+ * #thread-safe #allocates #to-review
+ */
+cels_warn_unused
+error shard_maps_snapshot(
+	shard_map *self, shard_map_snapshot *snapshot, const allocator *mem);
+
+/*
+ * Iterates through 'snapshot', from the
+ * first entry if 'iterator' is zeroed.
+ *
+ * 'iterator' must be shard-map-iterator-like.
+ *
+ * If eligible to continue, it returns true.
+ *
+ * #to-review
+ */
+bool shard_map_snapshots_next(const shard_map_snapshot *self, void *iterator);
+
+/*
+ * Frees snapshot.
+ *
+ * #to-review
+ */
+void shard_map_snapshots_free(shard_map_snapshot *self, const allocator *mem);
+
+/*
+ * Frees shard-map and every table
+ * it outgrew, no thread may be
+ * using it meanwhile.
+ *
+ * #to-review
+ */
+void shard_maps_free(shard_map *self, const allocator *mem);
+
+
+/* rings */
+
+/*
+ * A bounded queue of items sized 'item_size'
+ * that many threads may push to and pop from
+ * without locking (after dmitry vyukov's) - 
+ * each cell holds a sequence telling whether
+ * it is free for the lap of a producer or
+ * filled for the lap of a consumer.
+ *
+ * Head and tail are on their own cache-lines,
+ * so producers and consumers don't contend.
+ */
+
+typedef struct ring {
+	/* a power of two */
+	size_t capacity;
+	size_t item_size;
+	size_t cell_size;
+	char *data;
+	char padding0[node_line_size - sizeof(size_t) * 3 - sizeof(char *)];
+	/* next position to push */
+	size_t head;
+	char padding1[node_line_size - sizeof(size_t)];
+	/* next position to pop */
+	size_t tail;
+	char padding2[node_line_size - sizeof(size_t)];
+} ring;
+
+/*
+ * Initializes a ring holding 'capacity'
+ * items, rounded up to a power of two.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error rings_init(
+	ring *self, size_t item_size, size_t capacity, const allocator *mem);
+
+/*
+ * Pushes a copy of 'item'.
+ *
+ * Returns fail if ring is full.
+ *
+ * #thread-safe #to-review
+ */
+error rings_try_push(ring *self, const void *item);
+
+/*
+ * Pops the oldest item to 'item'.
+ *
+ * Returns fail if ring is empty.
+ *
+ * #thread-safe #to-review
+ */
+error rings_try_pop(ring *self, void *item);
+
+/*
+ * Pushes a copy of 'item', yielding
+ * while ring is full.
+ *
+ * #thread-safe #to-review
+ */
+void rings_push(ring *self, const void *item);
+
+/*
+ * Pops the oldest item to 'item', 
+ * yielding while ring is empty.
+ *
+ * #thread-safe #to-review
+ */
+void rings_pop(ring *self, void *item);
+
+/*
+ * Pushes up to 'size' items from
+ * array 'items', in order, until 
+ * ring is full.
+ *
+ * Returns the ammount pushed.
+ *
+ * #thread-safe #to-review
+ */
+size_t rings_push_batch(ring *self, const void *items, size_t size);
+
+/*
+ * Pops up to 'size' items to array 
+ * 'items' until ring is empty.
+ *
+ * Returns the ammount popped.
+ *
+ * #thread-safe #to-review
+ */
+size_t rings_pop_batch(ring *self, void *items, size_t size);
+
+/*
+ * Gets the ammount of items, which may
+ * be stale while others are running.
+ *
+ * #thread-safe #to-review
+ */
+size_t rings_size(const ring *self);
+
+/*
+ * Frees ring, no thread may be
+ * using it meanwhile.
+ *
+ * #to-review
+ */
+void rings_free(ring *self, const allocator *mem);
+
+
+/* spsc-rings */
+
+/*
+ * A ring for a single producer and a
+ * single consumer, without sequences -
+ * each side caches the position of the
+ * other, reading it only when it seems 
+ * full or empty.
+ */
+
+typedef struct spsc_ring {
+	/* a power of two */
+	size_t capacity;
+	size_t item_size;
+	char *data;
+	char padding0[node_line_size - sizeof(size_t) * 2 - sizeof(char *)];
+	/* owned by the producer */
+	size_t head;
+	size_t tail_cache;
+	char padding1[node_line_size - sizeof(size_t) * 2];
+	/* owned by the consumer */
+	size_t tail;
+	size_t head_cache;
+	char padding2[node_line_size - sizeof(size_t) * 2];
+} spsc_ring;
+
+/*
+ * Initializes a spsc-ring holding 
+ * 'capacity' items, rounded up to 
+ * a power of two.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error spsc_rings_init(
+	spsc_ring *self, size_t item_size, size_t capacity, const allocator *mem);
+
+/*
+ * Pushes a copy of 'item', only 
+ * from the producer thread.
+ *
+ * Returns fail if spsc-ring is full.
+ *
+ * #to-review
+ */
+error spsc_rings_try_push(spsc_ring *self, const void *item);
+
+/*
+ * Pops the oldest item to 'item', 
+ * only from the consumer thread.
+ *
+ * Returns fail if spsc-ring is empty.
+ *
+ * #to-review
+ */
+error spsc_rings_try_pop(spsc_ring *self, void *item);
+
+/*
+ * Pushes a copy of 'item', yielding
+ * while spsc-ring is full.
+ *
+ * #to-review
+ */
+void spsc_rings_push(spsc_ring *self, const void *item);
+
+/*
+ * Pops the oldest item to 'item', 
+ * yielding while spsc-ring is empty.
+ *
+ * #to-review
+ */
+void spsc_rings_pop(spsc_ring *self, void *item);
+
+/*
+ * Pushes up to 'size' items from 
+ * array 'items', publishing them 
+ * at once.
+ *
+ * Returns the ammount pushed.
+ *
+ * #to-review
+ */
+size_t spsc_rings_push_batch(spsc_ring *self, const void *items, size_t size);
+
+/*
+ * Pops up to 'size' items to array
+ * 'items', releasing them at once.
+ *
+ * Returns the ammount popped.
+ *
+ * #to-review
+ */
+size_t spsc_rings_pop_batch(spsc_ring *self, void *items, size_t size);
+
+/*
+ * Frees spsc-ring, no thread may 
+ * be using it meanwhile.
+ *
+ * #to-review
+ */
+void spsc_rings_free(spsc_ring *self, const allocator *mem);
+
 /* pools and linked-blocks */
 
 #define pool_block_items(name, type0) \
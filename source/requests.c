@@ -7,7 +7,6 @@ typedef struct request {
 	string packet;
 	string host;
 	string port;
-	struct addrinfo info;
 	struct timeval timeout;
 	size_t max_retry;
 	size_t initial_buffer_size;
@@ -20,6 +19,606 @@ static const string request_port = strings_premake("80");
 static const string request_port_secure = strings_premake("443");
 static const byte_vec section_sep = byte_vecs_premake("\r\n\r\n");
 
+/* request_resolvers */
+
+typedef struct request_resolution {
+	size_t hash;
+	string host;
+	string port;
+	struct sockaddr_storage address;
+	socklen_t address_size;
+	int family;
+	int socktype;
+	int protocol;
+	error error;
+	time_t expiration;
+} request_resolution;
+
+typedef errors(request_resolution) erequest_resolution;
+
+typedef struct request_resolver {
+	pthread_mutex_t lock;
+	request_resolution *data;
+	size_t size;
+	size_t capacity;
+	ulong ttl;
+	ulong negative_ttl;
+} request_resolver;
+
+#define request_resolver_ttl 60
+#define request_resolver_negative_ttl 5
+#define request_resolver_capacity 64
+
+static request_resolver request_resolver_cache = {
+	.lock=PTHREAD_MUTEX_INITIALIZER,
+	.capacity=request_resolver_capacity,
+	.ttl=request_resolver_ttl,
+	.negative_ttl=request_resolver_negative_ttl,
+};
+
+time_t request_resolvers_now_private(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec;
+}
+
+size_t request_resolvers_hash_private(const string *host, const string *port) {
+	return strings_hash(host) * 31 + strings_hash(port);
+}
+
+void request_resolutions_free_private(request_resolution *self) {
+	strings_free(&self->host, null);
+	strings_free(&self->port, null);
+	memset(self, 0, sizeof(request_resolution));
+}
+
+/*
+ * Looks 'host' and 'port' up in cache, 
+ * copying it to 'resolution' if it's 
+ * found and not expired. 
+ *
+ * The lock must be held.
+ */
+bool request_resolvers_find_private(
+	request_resolver *self, 
+	size_t hash, 
+	const string *host, 
+	const string *port, 
+	request_resolution *resolution) {
+
+	time_t now = request_resolvers_now_private();
+
+	for (size_t i = 0; i < self->size; i++) {
+		request_resolution *item = &self->data[i];
+		if (item->hash != hash) { continue; }
+		if (!strings_seems(&item->host, host)) { continue; }
+		if (!strings_equals(&item->port, port)) { continue; }
+
+		if (item->expiration <= now) { 
+			return false; 
+		}
+
+		*resolution = *item;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Stores 'resolution' in cache, replacing an 
+ * entry of the same host-port pair or, when 
+ * full, the one closest to expiring.
+ *
+ * The lock must be held.
+ */
+void request_resolvers_store_private(
+	request_resolver *self, const request_resolution *resolution) {
+
+	if (!self->data) {
+		self->data = mems_alloc(
+			null, sizeof(request_resolution) * self->capacity);
+
+		if (!self->data) { return; }
+		self->size = 0;
+	}
+
+	request_resolution *slot = null;
+	request_resolution *oldest = null;
+	for (size_t i = 0; i < self->size; i++) {
+		request_resolution *item = &self->data[i];
+
+		bool is_same = 
+			item->hash == resolution->hash && 
+			strings_seems(&item->host, &resolution->host) && 
+			strings_equals(&item->port, &resolution->port);
+
+		if (is_same) {
+			slot = item;
+			break;
+		}
+
+		if (!oldest || item->expiration < oldest->expiration) {
+			oldest = item;
+		}
+	}
+
+	if (!slot && self->size < self->capacity) {
+		slot = &self->data[self->size++];
+	} else {
+		if (!slot) { slot = oldest; }
+		request_resolutions_free_private(slot);
+	}
+
+	*slot = *resolution;
+	slot->host = strings_clone(&resolution->host, null);
+	slot->port = strings_clone(&resolution->port, null);
+}
+
+/*
+ * Resolves 'host' and 'port' through cache, 
+ * only calling getaddrinfo on a miss.
+ */
+erequest_resolution request_resolvers_resolve_private(
+	const string *host, const string *port) {
+
+	#if cels_debug
+		errors_abort("host", strings_check_extra(host));
+		errors_abort("port", strings_check_extra(port));
+	#endif
+
+	request_resolver *self = &request_resolver_cache;
+	size_t hash = request_resolvers_hash_private(host, port);
+
+	request_resolution resolution = {0};
+
+	pthread_mutex_lock(&self->lock);
+	bool is_cached = request_resolvers_find_private(
+		self, hash, host, port, &resolution);
+	pthread_mutex_unlock(&self->lock);
+
+	if (is_cached) {
+		if (resolution.error != request_successfull) {
+			return (erequest_resolution){.error=resolution.error};
+		}
+
+		return (erequest_resolution){.value=resolution};
+	}
+
+	struct addrinfo hints = {
+		.ai_family=AF_UNSPEC,
+		.ai_socktype=SOCK_STREAM,
+	};
+
+	struct addrinfo *server = null;
+	int get_status = getaddrinfo(host->data, port->data, &hints, &server);
+
+	resolution = (request_resolution){
+		.hash=hash,
+		.host=*host,
+		.port=*port,
+	};
+
+	if (get_status != 0 || !server) {
+		resolution.error = request_dns_not_resolved_error;
+	} else {
+		memcpy(&resolution.address, server->ai_addr, server->ai_addrlen);
+		resolution.address_size = server->ai_addrlen;
+		resolution.family = server->ai_family;
+		resolution.socktype = server->ai_socktype;
+		resolution.protocol = server->ai_protocol;
+	}
+
+	if (server) {
+		freeaddrinfo(server);
+	}
+
+	pthread_mutex_lock(&self->lock);
+	ulong ttl = 
+		resolution.error == request_successfull ? 
+		self->ttl : self->negative_ttl;
+
+	resolution.expiration = request_resolvers_now_private() + ttl;
+	if (ttl > 0) {
+		request_resolvers_store_private(self, &resolution);
+	}
+	pthread_mutex_unlock(&self->lock);
+
+	if (resolution.error != request_successfull) {
+		return (erequest_resolution){.error=resolution.error};
+	}
+
+	return (erequest_resolution){.value=resolution};
+}
+
+/*
+ * Drops every entry of cache. 
+ *
+ * The lock must be held.
+ */
+void request_resolvers_clear_private(request_resolver *self) {
+	for (size_t i = 0; i < self->size; i++) {
+		request_resolutions_free_private(&self->data[i]);
+	}
+
+	if (self->data) {
+		mems_dealloc(
+			null, 
+			self->data, 
+			sizeof(request_resolution) * self->capacity);
+	}
+
+	self->data = null;
+	self->size = 0;
+}
+
+
+/* request_streams */
+
+typedef enum request_stream_state {
+	request_stream_head_state,
+	request_stream_body_state,
+	request_stream_chunk_size_state,
+	request_stream_chunk_extension_state,
+	request_stream_chunk_data_state,
+	request_stream_chunk_end_state,
+	request_stream_trailer_state,
+	request_stream_done_state,
+} request_stream_state;
+
+typedef struct request_stream {
+	request_stream_state state;
+	request_stream_option option;
+	byte_vec head;
+	size_t matched;
+	size_t remaining;
+	size_t line_size;
+	bool is_chunked;
+	bool has_length;
+	bool has_digits;
+} request_stream;
+
+#define request_stream_head_size 8192
+
+error request_streams_init_private(
+	request_stream *self, request_stream_option option, const allocator *mem) {
+
+	*self = (request_stream){.option=option};
+	if (self->option.max_head_size == 0) {
+		self->option.max_head_size = request_stream_head_size;
+	}
+
+	error init_error = vectors_init(
+		&self->head, sizeof(byte), string_small_size, mem);
+
+	if (init_error) {
+		return request_upscaling_error;
+	}
+
+	return request_successfull;
+}
+
+/*
+ * Finds value of header-field 'name' (which 
+ * must be lowercase) in null-terminated head.
+ */
+const char *request_streams_field_private(
+	const byte_vec *head, const char *name) {
+
+	size_t name_size = strlen(name);
+	const char *line = (const char *)head->data;
+
+	while (true) {
+		const char *next = strstr(line, "\r\n");
+		if (!next) { return null; }
+
+		line = next + 2;
+
+		size_t i = 0;
+		for (; i < name_size; i++) {
+			if (tolower(line[i]) != name[i]) { break; }
+		}
+
+		if (i == name_size && line[name_size] == ':') {
+			const char *value = line + name_size + 1;
+			while (*value == ' ' || *value == '\t') { ++value; }
+
+			return value;
+		}
+	}
+}
+
+bool request_streams_is_chunked_private(const char *value) {
+	static const char chunked[] = "chunked";
+
+	for (; *value && *value != '\r'; value++) {
+		size_t i = 0;
+		for (; i < sizeof(chunked) - 1; i++) {
+			if (tolower(value[i]) != chunked[i]) { break; }
+		}
+
+		if (i == sizeof(chunked) - 1) { 
+			return true; 
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Parses the fields that define how 
+ * the body is framed.
+ */
+void request_streams_parse_private(request_stream *self) {
+	const char *encoding = 
+		request_streams_field_private(&self->head, "transfer-encoding");
+
+	if (encoding && request_streams_is_chunked_private(encoding)) {
+		self->is_chunked = true;
+		self->state = request_stream_chunk_size_state;
+		return;
+	}
+
+	self->state = request_stream_body_state;
+
+	const char *length = 
+		request_streams_field_private(&self->head, "content-length");
+
+	if (length) {
+		self->has_length = true;
+		self->remaining = strtoull(length, null, 10);
+
+		if (self->remaining == 0) {
+			self->state = request_stream_done_state;
+		}
+	}
+}
+
+error request_streams_deliver_private(
+	request_stream *self, const byte *data, size_t size) {
+
+	if (size == 0) { 
+		return request_successfull; 
+	}
+
+	if (self->option.callback) {
+		error callback_error = 
+			self->option.callback(data, size, self->option.params);
+
+		if (callback_error) {
+			return request_streaming_error;
+		}
+	}
+
+	if (self->option.file) {
+		size_t written = fwrite(data, 1, size, self->option.file);
+		if (written < size) {
+			return request_streaming_error;
+		}
+	}
+
+	return request_successfull;
+}
+
+/*
+ * Ends a chunk-size line, moving either 
+ * to chunk's data or to trailer.
+ */
+error request_streams_end_size_private(request_stream *self) {
+	if (!self->has_digits) {
+		return request_malformed_chunk_error;
+	}
+
+	self->has_digits = false;
+	self->state = self->remaining == 0 ? 
+		request_stream_trailer_state : 
+		request_stream_chunk_data_state;
+
+	return request_successfull;
+}
+
+/*
+ * Feeds received bytes into stream, 
+ * accumulating head, decoding chunks 
+ * and delivering body as it goes.
+ */
+error request_streams_feed_private(
+	request_stream *self, 
+	const byte *data, 
+	size_t size, 
+	const allocator *mem) {
+
+	size_t i = 0;
+	while (i < size) {
+		switch (self->state) {
+		case request_stream_head_state: {
+			byte letter = data[i++];
+
+			if (self->head.size + 1 >= self->option.max_head_size) {
+				return request_head_too_large_error;
+			}
+
+			error push_error = vectors_push(&self->head, &letter, mem);
+			if (push_error) {
+				return request_upscaling_error;
+			}
+
+			if (letter == section_sep.data[self->matched]) {
+				++self->matched;
+			} else {
+				self->matched = letter == '\r' ? 1 : 0;
+			}
+
+			if (self->matched == section_sep.size - 1) {
+				self->head.size -= self->matched;
+
+				push_error = vectors_push(&self->head, &(byte){'\0'}, mem);
+				if (push_error) {
+					return request_upscaling_error;
+				}
+
+				request_streams_parse_private(self);
+			}
+
+			break;
+		}
+
+		case request_stream_body_state: {
+			size_t piece = size - i;
+			if (self->has_length && piece > self->remaining) {
+				piece = self->remaining;
+			}
+
+			error deliver_error = 
+				request_streams_deliver_private(self, data + i, piece);
+
+			if (deliver_error) {
+				return deliver_error;
+			}
+
+			i += piece;
+
+			if (self->has_length) {
+				self->remaining -= piece;
+				if (self->remaining == 0) {
+					self->state = request_stream_done_state;
+				}
+			}
+
+			break;
+		}
+
+		case request_stream_chunk_size_state: {
+			byte letter = data[i++];
+			int digit = -1;
+
+			if (letter >= '0' && letter <= '9') {
+				digit = letter - '0';
+			} else if (letter >= 'a' && letter <= 'f') {
+				digit = letter - 'a' + 10;
+			} else if (letter >= 'A' && letter <= 'F') {
+				digit = letter - 'A' + 10;
+			}
+
+			if (digit >= 0) {
+				if (self->remaining > (SIZE_MAX >> 4)) {
+					return request_malformed_chunk_error;
+				}
+
+				self->remaining = (self->remaining << 4) | digit;
+				self->has_digits = true;
+			} else if (letter == ';' || letter == ' ' || letter == '\t') {
+				self->state = request_stream_chunk_extension_state;
+			} else if (letter == '\n') {
+				error end_error = request_streams_end_size_private(self);
+				if (end_error) { 
+					return end_error; 
+				}
+			} else if (letter != '\r') {
+				return request_malformed_chunk_error;
+			}
+
+			break;
+		}
+
+		case request_stream_chunk_extension_state: {
+			byte letter = data[i++];
+
+			if (letter == '\n') {
+				error end_error = request_streams_end_size_private(self);
+				if (end_error) { 
+					return end_error; 
+				}
+			}
+
+			break;
+		}
+
+		case request_stream_chunk_data_state: {
+			size_t piece = size - i;
+			if (piece > self->remaining) {
+				piece = self->remaining;
+			}
+
+			error deliver_error = 
+				request_streams_deliver_private(self, data + i, piece);
+
+			if (deliver_error) {
+				return deliver_error;
+			}
+
+			i += piece;
+			self->remaining -= piece;
+
+			if (self->remaining == 0) {
+				self->state = request_stream_chunk_end_state;
+			}
+
+			break;
+		}
+
+		case request_stream_chunk_end_state: {
+			byte letter = data[i++];
+
+			if (letter == '\n') {
+				self->state = request_stream_chunk_size_state;
+			} else if (letter != '\r') {
+				return request_malformed_chunk_error;
+			}
+
+			break;
+		}
+
+		case request_stream_trailer_state: {
+			byte letter = data[i++];
+
+			if (letter == '\n') {
+				if (self->line_size == 0) {
+					self->state = request_stream_done_state;
+				}
+
+				self->line_size = 0;
+			} else if (letter != '\r') {
+				++self->line_size;
+			}
+
+			break;
+		}
+
+		case request_stream_done_state:
+			return request_successfull;
+		}
+	}
+
+	return request_successfull;
+}
+
+/*
+ * Checks if stream ended in a valid 
+ * state once peer closed connection.
+ */
+error request_streams_finish_private(request_stream *self) {
+	switch (self->state) {
+	case request_stream_done_state: 
+		return request_successfull;
+	case request_stream_body_state: 
+		if (self->has_length) {
+			return request_receiving_error;
+		}
+
+		self->state = request_stream_done_state;
+		return request_successfull;
+	case request_stream_head_state: 
+		return request_receiving_error;
+	default: 
+		return request_malformed_chunk_error;
+	}
+}
+
+
+/* requests */
+
 void requests_free_private(request *self, const allocator *mem) {
 	#if cels_debug
 		errors_abort("self", !self);
@@ -139,11 +738,6 @@ erequest requests_contruct_private(
 		body.data);
 
 	request.port = option->port.data ? option->port : strings_do("80");
-	request.info = (struct addrinfo) {
-		.ai_family=AF_UNSPEC,
-		.ai_socktype=SOCK_STREAM,
-	};
-
 	if (strings_equals(&request.port, &request_port)) {
 		request.is_secure = false;
 	} else if (strings_equals(&request.port, &request_port_secure)) {
@@ -169,6 +763,31 @@ erequest requests_contruct_private(
 	return (erequest){.error=err};
 }
 
+/*
+ * Splits a raw response into 
+ * head and body.
+ */
+response requests_parse_private(const byte_vec *raw, const allocator *mem) {
+	#if cels_debug
+		errors_abort("raw", byte_vecs_check(raw));
+	#endif
+
+	response response = {0};
+	byte_mat packets = byte_vecs_split(raw, section_sep, 1, mem);
+	errors_abort("#packets", packets.size == 0);
+
+	if (packets.size == 1) {
+		response.head = packets.data[0];
+		response.body = (byte_vec)byte_vecs_premake("");
+	} else {
+		response.head = packets.data[0];
+		response.body = packets.data[1];
+	}
+
+	mems_dealloc(mem, packets.data, packets.type_size * packets.capacity);
+	return response;
+}
+
 cels_warn_unused
 erequest_internal requests_init_private(
 	const string *url, const request_option *option, const allocator *mem) {
@@ -181,32 +800,29 @@ erequest_internal requests_init_private(
 		goto cleanup0;
 	}
 
-	struct addrinfo *server;
-	int get_status = getaddrinfo(
-		request.value.host.data,
-		request.value.port.data,
-		&request.value.info,
-		&server);
+	erequest_resolution server = request_resolvers_resolve_private(
+		&request.value.host, &request.value.port);
 
-	if (get_status < 0 || !server) {
-		err = request_dns_not_resolved_error;
-		freeaddrinfo(server);
+	if (server.error != request_successfull) {
+		err = server.error;
 		goto cleanup1;
 	}
 
 
 	#if cels_debug
 		void *address = null;
-		if (server->ai_family == AF_INET) {
-			struct sockaddr_in *ipv4 = (struct sockaddr_in *)server->ai_addr;
+		if (server.value.family == AF_INET) {
+			struct sockaddr_in *ipv4 = 
+				(struct sockaddr_in *)&server.value.address;
 			address = &(ipv4->sin_addr);
 		} else {
-			struct sockaddr_in6 *ipv6 = (struct sockaddr_in6 *)server->ai_addr;  
+			struct sockaddr_in6 *ipv6 = 
+				(struct sockaddr_in6 *)&server.value.address;
 			address = &(ipv6->sin6_addr);
 		}
 
 		char ip[INET6_ADDRSTRLEN];
-		inet_ntop(server->ai_family, address, ip, sizeof(ip)); 
+		inet_ntop(server.value.family, address, ip, sizeof(ip)); 
 
 		string address_formated = strings_format(
 			"https_request.address = %s", mem, ip);
@@ -216,9 +832,9 @@ erequest_internal requests_init_private(
 
 
 	int socket_descriptor = socket(
-		server->ai_family, 
-		server->ai_socktype, 
-		server->ai_protocol);
+		server.value.family, 
+		server.value.socktype, 
+		server.value.protocol);
 
 	if (socket_descriptor < 0) {
 		err = request_socket_creation_error;
@@ -241,10 +857,8 @@ erequest_internal requests_init_private(
 
 	int conn_status = connect(
 		socket_descriptor, 
-		server->ai_addr, 
-		server->ai_addrlen);
-
-	freeaddrinfo(server);
+		(struct sockaddr *)&server.value.address, 
+		server.value.address_size);
 
 	if (conn_status < 0) { 
 		err = request_connection_error;
@@ -277,7 +891,11 @@ erequest_internal requests_init_private(
 
 #if cels_openssl
 ebyte_vec requests_connect_securely_private(
-	int socket, const string packet, const allocator *mem) {
+	int socket, 
+	const string packet, 
+	size_t buffer_size, 
+	request_stream *stream, 
+	const allocator *mem) {
 
 	#if cels_debug
 		errors_abort("packet", strings_check_extra(&packet));
@@ -346,7 +964,7 @@ ebyte_vec requests_connect_securely_private(
 	}
 
 	byte_vec response = {0}; 
-	vectors_init(&response, sizeof(char), string_small_size, mem);
+	vectors_init(&response, sizeof(char), buffer_size, mem);
 
     while(response.size < response.capacity) {
         long bytes = SSL_read(
@@ -359,6 +977,22 @@ ebyte_vec requests_connect_securely_private(
 			goto cleanup3;
 		} 
 
+		if (stream && bytes > 0) {
+			error feed_error = request_streams_feed_private(
+				stream, response.data, bytes, mem);
+
+			if (feed_error) {
+				err = feed_error;
+				goto cleanup3;
+			}
+
+			if (stream->state == request_stream_done_state) {
+				break;
+			}
+
+			continue;
+		}
+
         response.size += bytes;
 
 		if (bytes == 0) {
@@ -373,6 +1007,13 @@ ebyte_vec requests_connect_securely_private(
 		}
     }
 
+	if (stream) {
+		err = request_streams_finish_private(stream);
+		if (err) {
+			goto cleanup3;
+		}
+	}
+
 	bool push_error = vectors_push(&response, &(char){'\0'}, mem);
 	if (push_error) {
 		err = request_upscaling_error;
@@ -573,7 +1214,11 @@ bool requests_connect_securely_async_private(
 #endif
 
 ebyte_vec requests_connect_insecurely_private(
-	int socket, const string packet, const allocator *mem) {
+	int socket, 
+	const string packet, 
+	size_t buffer_size, 
+	request_stream *stream, 
+	const allocator *mem) {
 
 	#if cels_debug
 		errors_abort("packet", strings_check_extra(&packet));
@@ -586,7 +1231,7 @@ ebyte_vec requests_connect_insecurely_private(
 
 	error err = ok;
 	byte_vec response = {0};
-	vectors_init(&response, sizeof(char), string_small_size, mem);
+	vectors_init(&response, sizeof(char), buffer_size, mem);
 
     while(response.size < response.capacity) {
         long bytes = recv(
@@ -600,6 +1245,22 @@ ebyte_vec requests_connect_insecurely_private(
 			goto cleanup;
 		} 
 
+		if (stream && bytes > 0) {
+			error feed_error = request_streams_feed_private(
+				stream, response.data, bytes, mem);
+
+			if (feed_error) {
+				err = feed_error;
+				goto cleanup;
+			}
+
+			if (stream->state == request_stream_done_state) {
+				break;
+			}
+
+			continue;
+		}
+
         response.size += bytes;
 
         if (bytes == 0) {
@@ -613,6 +1274,13 @@ ebyte_vec requests_connect_insecurely_private(
 		}
     }
 
+	if (stream) {
+		err = request_streams_finish_private(stream);
+		if (err) {
+			goto cleanup;
+		}
+	}
+
 	bool push_error = vectors_push(&response, &(char){'\0'}, mem);
 	if (push_error) {
 		err = request_upscaling_error;
@@ -729,28 +1397,420 @@ bool requests_connect_insecurely_async_private(
 }
 
 
-/* public */
+/* request_slots */
 
-void request_errors_println(request_error self) {
-	#if cels_debug
-		errors_abort("self", !self);
-		errors_abort("#self", self < 0 || self >= request_private_error);
-	#endif
-	
-	if (self < 0 || self >= request_private_error) {
-		return;
-	}
+typedef enum request_slot_state {
+	request_slot_idle_state,
+	request_slot_connect_state,
+	request_slot_handshake_state,
+	request_slot_send_state,
+	request_slot_receive_state,
+} request_slot_state;
 
-	printf("%s\n", request_error_messages[self]);
-}
+typedef struct request_slot {
+	request_slot_state state;
+	size_t index;
+	int socket;
+	string packet;
+	size_t sent;
+	byte_vec response;
+	long deadline;
+	short events;
+	bool is_secure;
 
-eresponse requests_make(
+	#if cels_openssl
+	SSL *ssl;
+	SSL_CTX *context;
+	#endif
+} request_slot;
+
+long request_slots_now_private(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+void request_slots_free_private(request_slot *self, const allocator *mem) {
+	#if cels_openssl
+	if (self->ssl) {
+		SSL_free(self->ssl);
+	}
+
+	if (self->context) {
+		SSL_CTX_free(self->context);
+	}
+	#endif
+
+	if (self->socket > 0) {
+		close(self->socket);
+	}
+
+	if (self->packet.data) {
+		strings_free(&self->packet, mem);
+	}
+
+	if (self->response.data) {
+		vectors_free(&self->response, null, mem);
+	}
+
+	*self = (request_slot){0};
+}
+
+/*
+ * Finishes slot placing either 'err' or 
+ * the parsed response into 'results' and 
+ * notifying callback.
+ */
+void request_slots_finish_private(
+	request_slot *self, 
+	error err, 
+	eresponse *results, 
+	const request_many_option *option, 
+	const allocator *mem) {
+
+	size_t index = self->index;
+	eresponse *result = &results[index];
+
+	if (err == request_successfull) {
+		error push_error = vectors_push(&self->response, &(byte){'\0'}, mem);
+
+		if (push_error) {
+			err = request_upscaling_error;
+		} else {
+			result->value = requests_parse_private(&self->response, mem);
+		}
+	}
+
+	result->error = err;
+	request_slots_free_private(self, mem);
+
+	if (option->callback) {
+		option->callback(index, result, option->params);
+	}
+}
+
+/*
+ * Starts request by resolving host and 
+ * connecting to it without blocking.
+ */
+error request_slots_start_private(
+	request_slot *self, 
+	size_t index,
+	const string *url, 
+	const request_option *option, 
+	const allocator *mem) {
+
+	*self = (request_slot){.index=index, .socket=-1};
+
+	erequest request = requests_contruct_private(url, option, mem);
+	if (request.error != request_successfull) {
+		return request.error;
+	}
+
+	self->packet = request.value.packet;
+	self->is_secure = request.value.is_secure;
+	self->deadline = 
+		request_slots_now_private() + request.value.timeout.tv_sec * 1000;
+
+	erequest_resolution server = request_resolvers_resolve_private(
+		&request.value.host, &request.value.port);
+
+	strings_free(&request.value.host, mem);
+
+	if (server.error != request_successfull) {
+		return server.error;
+	}
+
+	#if !cels_openssl
+	if (self->is_secure) {
+		return request_secure_not_implemented_error;
+	}
+	#endif
+
+	self->socket = socket(
+		server.value.family, 
+		server.value.socktype | SOCK_NONBLOCK, 
+		server.value.protocol);
+
+	if (self->socket < 0) {
+		return request_socket_creation_error;
+	}
+
+	int conn_status = connect(
+		self->socket, 
+		(struct sockaddr *)&server.value.address, 
+		server.value.address_size);
+
+	if (conn_status < 0 && errno != EINPROGRESS) {
+		return request_connection_error;
+	}
+
+	error init_error = vectors_init(
+		&self->response, 
+		sizeof(byte), 
+		request.value.initial_buffer_size, 
+		mem);
+
+	if (init_error) {
+		return request_upscaling_error;
+	}
+
+	self->state = request_slot_connect_state;
+	self->events = POLLOUT;
+	return request_successfull;
+}
+
+/*
+ * Advances slot's state-machine as far as 
+ * it goes without blocking. 
+ *
+ * Returns true while the request isn't 
+ * finished, placing in 'err' any error 
+ * that happened.
+ */
+bool request_slots_advance_private(
+	request_slot *self, error *err, const allocator *mem) {
+
+	while (true) {
+		switch (self->state) {
+		case request_slot_idle_state: 
+			return false;
+
+		case request_slot_connect_state: {
+			int status = 0;
+			socklen_t status_size = sizeof(status);
+
+			int get_status = getsockopt(
+				self->socket, SOL_SOCKET, SO_ERROR, &status, &status_size);
+
+			if (get_status < 0 || status != 0) {
+				*err = request_connection_error;
+				return false;
+			}
+
+			if (!self->is_secure) {
+				self->state = request_slot_send_state;
+				continue;
+			}
+
+			#if cels_openssl
+			self->context = SSL_CTX_new(TLS_client_method());
+			if (!self->context) {
+				*err = request_creating_context_error;
+				return false;
+			}
+
+			self->ssl = SSL_new(self->context);
+			if (!self->ssl) {
+				*err = request_creating_context_error;
+				return false;
+			}
+
+			int set_status = SSL_set_fd(self->ssl, self->socket);
+			if (set_status != 1) {
+				*err = request_binding_secure_connection_error;
+				return false;
+			}
+
+			self->state = request_slot_handshake_state;
+			continue;
+			#else
+			*err = request_secure_not_implemented_error;
+			return false;
+			#endif
+		}
+
+		case request_slot_handshake_state: {
+			#if cels_openssl
+			int connection_status = SSL_connect(self->ssl);
+			if (connection_status == 1) {
+				self->state = request_slot_send_state;
+				continue;
+			}
+
+			int ssl_error = SSL_get_error(self->ssl, connection_status);
+			if (ssl_error == SSL_ERROR_WANT_READ) {
+				self->events = POLLIN;
+				return true;
+			} else if (ssl_error == SSL_ERROR_WANT_WRITE) {
+				self->events = POLLOUT;
+				return true;
+			}
+			#endif
+
+			*err = request_opening_secure_connection_error;
+			return false;
+		}
+
+		case request_slot_send_state: {
+			char *data = self->packet.data + self->sent;
+			size_t size = self->packet.size - self->sent;
+			long bytes = 0;
+
+			if (!self->is_secure) {
+				bytes = send(self->socket, data, size, MSG_NOSIGNAL);
+
+				if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+					self->events = POLLOUT;
+					return true;
+				}
+			} 
+			#if cels_openssl
+			else {
+				bytes = SSL_write(self->ssl, data, size);
+
+				if (bytes <= 0) {
+					int ssl_error = SSL_get_error(self->ssl, bytes);
+					if (ssl_error == SSL_ERROR_WANT_READ) {
+						self->events = POLLIN;
+						return true;
+					} else if (ssl_error == SSL_ERROR_WANT_WRITE) {
+						self->events = POLLOUT;
+						return true;
+					}
+
+					bytes = -1;
+				}
+			}
+			#endif
+
+			if (bytes < 0) {
+				*err = request_sending_error;
+				return false;
+			}
+
+			self->sent += bytes;
+			if (self->sent >= self->packet.size) {
+				self->state = request_slot_receive_state;
+			}
+
+			continue;
+		}
+
+		case request_slot_receive_state: {
+			byte_vec *response = &self->response;
+
+			if (response->size >= response->capacity - 1) {
+				error upscale_error = vectors_upscale(response, mem);
+				if (upscale_error) {
+					*err = request_upscaling_error;
+					return false;
+				}
+			}
+
+			byte *data = response->data + response->size;
+			size_t size = response->capacity - response->size - 1;
+			long bytes = 0;
+
+			if (!self->is_secure) {
+				bytes = recv(self->socket, data, size, 0);
+
+				if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+					self->events = POLLIN;
+					return true;
+				}
+			} 
+			#if cels_openssl
+			else {
+				bytes = SSL_read(self->ssl, data, size);
+
+				if (bytes <= 0) {
+					int ssl_error = SSL_get_error(self->ssl, bytes);
+					if (ssl_error == SSL_ERROR_WANT_READ) {
+						self->events = POLLIN;
+						return true;
+					} else if (ssl_error == SSL_ERROR_WANT_WRITE) {
+						self->events = POLLOUT;
+						return true;
+					} else if (ssl_error == SSL_ERROR_ZERO_RETURN) {
+						bytes = 0;
+					} else {
+						bytes = -1;
+					}
+				}
+			}
+			#endif
+
+			if (bytes < 0) {
+				*err = request_receiving_error;
+				return false;
+			} else if (bytes == 0) {
+				return false;
+			}
+
+			response->size += bytes;
+			continue;
+		}
+		}
+	}
+}
+
+
+/* public */
+
+void request_errors_println(request_error self) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("#self", self < 0 || self >= request_private_error);
+	#endif
+	
+	if (self < 0 || self >= request_private_error) {
+		return;
+	}
+
+	printf("%s\n", request_error_messages[self]);
+}
+
+void requests_configure_resolver(request_resolver_option option) {
+	request_resolver *self = &request_resolver_cache;
+
+	pthread_mutex_lock(&self->lock);
+	request_resolvers_clear_private(self);
+
+	self->ttl = 
+		option.ttl == request_resolver_default ? 
+		request_resolver_ttl : option.ttl;
+
+	self->negative_ttl = 
+		option.negative_ttl == request_resolver_default ? 
+		request_resolver_negative_ttl : option.negative_ttl;
+
+	self->capacity = 
+		option.capacity == 0 ? 
+		request_resolver_capacity : option.capacity;
+	pthread_mutex_unlock(&self->lock);
+}
+
+error requests_resolve(const string *host, const string *port) {
+	#if cels_debug
+		errors_abort("host", strings_check_extra(host));
+		errors_abort("port", strings_check_extra(port));
+	#endif
+
+	erequest_resolution resolution = request_resolvers_resolve_private(
+		host, port);
+
+	return resolution.error;
+}
+
+void requests_free_resolver(void) {
+	request_resolver *self = &request_resolver_cache;
+
+	pthread_mutex_lock(&self->lock);
+	request_resolvers_clear_private(self);
+	pthread_mutex_unlock(&self->lock);
+}
+
+eresponse requests_make(
 	const string *url, const request_option *option, const allocator *mem) {
 
 	#if cels_debug
 		errors_abort("url", strings_check_extra(url));
 	#endif
 
+	traces_scope("requests_make");
+
 	error err = ok;
 	erequest_internal internal = requests_init_private(url, option, mem);
 	if (internal.error != request_successfull) {
@@ -761,12 +1821,20 @@ eresponse requests_make(
 	ebyte_vec response_raw = {0};
 	if (!internal.value.is_secure) {
 		response_raw = requests_connect_insecurely_private(
-			internal.value.socket, internal.value.packet, mem);
+			internal.value.socket, 
+			internal.value.packet, 
+			internal.value.initial_buffer_size, 
+			null, 
+			mem);
 	} 
 	#if cels_openssl
 	else {
 		response_raw = requests_connect_securely_private(
-			internal.value.socket, internal.value.packet, mem);
+			internal.value.socket, 
+			internal.value.packet, 
+			internal.value.initial_buffer_size, 
+			null, 
+			mem);
 	}
 	#else
 	else {
@@ -781,30 +1849,93 @@ eresponse requests_make(
 	}
 
 	
-	response response = {0};
-	string *response_raw_str = (string *)&response_raw.value;
-	//TODO: create byte_vecs_split_with
+	traces_begin("requests_parse");
+	response response = requests_parse_private(&response_raw.value, mem);
+	traces_end("requests_parse");
 
-	string_vec packets = strings_split_with(
-		response_raw_str, "\r\n\r\n", 1, mem);
-	errors_abort("#packets", packets.size == 0);
+	vectors_free(&response_raw.value, null, mem);
+	request_internals_free_private(&internal.value, mem);
+	close(internal.value.socket);
 
-	if (packets.size == 1) {
-		response.head = packets.data[0];
-		response.body = strings_do("");
-	} else {
-		response.head = packets.data[0];
-		response.body = packets.data[1];
+	return (eresponse){.value=response};
+
+	cleanup1:
+	close(internal.value.socket);
+	request_internals_free_private(&internal.value, mem);
+
+	cleanup0:
+	return (eresponse){.error=err};
+}
+
+eresponse requests_stream(
+	const string *url, 
+	const request_option *option, 
+	request_stream_option stream, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("url", strings_check_extra(url));
+		errors_abort("stream", !stream.callback && !stream.file);
+	#endif
+
+	error err = ok;
+	erequest_internal internal = requests_init_private(url, option, mem);
+	if (internal.error != request_successfull) {
+		err = internal.error;
+		goto cleanup0;
+	}
+
+	request_stream decoder = {0};
+	err = request_streams_init_private(&decoder, stream, mem);
+	if (err) {
+		goto cleanup1;
+	}
+
+	ebyte_vec response_raw = {0};
+	if (!internal.value.is_secure) {
+		response_raw = requests_connect_insecurely_private(
+			internal.value.socket, 
+			internal.value.packet, 
+			internal.value.initial_buffer_size, 
+			&decoder, 
+			mem);
+	} 
+	#if cels_openssl
+	else {
+		response_raw = requests_connect_securely_private(
+			internal.value.socket, 
+			internal.value.packet, 
+			internal.value.initial_buffer_size, 
+			&decoder, 
+			mem);
+	}
+	#else
+	else {
+		err = request_secure_not_implemented_error;
+		goto cleanup2;
+	}
+	#endif
+
+	if (response_raw.error != request_successfull) {
+		err = response_raw.error;
+		goto cleanup2;
 	}
 
 
-	mems_dealloc(mem, packets.data, sizeof(string) * packets.capacity);
 	vectors_free(&response_raw.value, null, mem);
 	request_internals_free_private(&internal.value, mem);
 	close(internal.value.socket);
 
+	response response = {
+		.head=decoder.head, 
+		.body=(byte_vec)byte_vecs_premake("")
+	};
+
 	return (eresponse){.value=response};
 
+	cleanup2:
+	vectors_free(&decoder.head, null, mem);
+
 	cleanup1:
 	close(internal.value.socket);
 	request_internals_free_private(&internal.value, mem);
@@ -870,27 +2001,8 @@ bool requests_make_async(
 			(request->option.flags & request_async_raw_mode_flag) == 1;
 
 		if (!is_raw) {
-			response response = {0};
-			byte_vec *r = &request->internal.response;
-
-			byte_mat packets = byte_vecs_split(
-				r, section_sep, 1, mem);
-
-			errors_abort("#packets", packets.size == 0);
-
-			if (packets.size == 1) {
-				response.head = packets.data[0];
-				response.body = (byte_vec)byte_vecs_premake("");
-			} else {
-				response.head = packets.data[0];
-				response.body = packets.data[1];
-			}
-
-			request->response.value = response;
-			mems_dealloc(
-				mem, 
-				packets.data, 
-				packets.type_size * packets.capacity);
+			request->response.value = requests_parse_private(
+				&request->internal.response, mem);
 		}
 
 
@@ -905,3 +2017,158 @@ bool requests_make_async(
 		return false;
 	}
 }
+
+error requests_make_many(
+	const string_vec *urls, 
+	const request_option *options, 
+	eresponse *results, 
+	request_many_option option, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("urls", vectors_check((const vector *)urls));
+		errors_abort("results", !results);
+	#endif
+
+	if (urls->size == 0) { 
+		return ok; 
+	}
+
+	size_t concurrency = option.concurrency;
+	if (concurrency == 0 || concurrency > urls->size) {
+		concurrency = urls->size;
+	}
+
+	#if cels_openssl
+	int ssl_options = 
+		OPENSSL_INIT_LOAD_SSL_STRINGS | 
+		OPENSSL_INIT_LOAD_CRYPTO_STRINGS;
+
+	OPENSSL_init_ssl(ssl_options, null);
+	#endif
+
+	request_slot *slots = mems_alloc(mem, sizeof(request_slot) * concurrency);
+	if (!slots) { 
+		return fail; 
+	}
+
+	struct pollfd *polls = mems_alloc(mem, sizeof(struct pollfd) * concurrency);
+	if (!polls) { 
+		mems_dealloc(mem, slots, sizeof(request_slot) * concurrency);
+		return fail; 
+	}
+
+	memset(slots, 0, sizeof(request_slot) * concurrency);
+
+	error err = ok;
+	size_t started = 0;
+	size_t finished = 0;
+
+	while (finished < urls->size) {
+		/* filling idle slots */
+
+		for (size_t i = 0; i < concurrency && started < urls->size; i++) {
+			request_slot *slot = &slots[i];
+			if (slot->state != request_slot_idle_state) { continue; }
+
+			size_t index = started++;
+			const request_option *opts = options ? &options[index] : null;
+
+			error start_error = request_slots_start_private(
+				slot, index, &urls->data[index], opts, mem);
+
+			if (start_error != request_successfull) {
+				request_slots_finish_private(
+					slot, start_error, results, &option, mem);
+
+				++finished;
+				--i;
+			}
+		}
+
+
+		/* polling */
+
+		long now = request_slots_now_private();
+		long wait = -1;
+		size_t active = 0;
+
+		for (size_t i = 0; i < concurrency; i++) {
+			request_slot *slot = &slots[i];
+
+			polls[i] = (struct pollfd){.fd=-1};
+			if (slot->state == request_slot_idle_state) { continue; }
+
+			polls[i].fd = slot->socket;
+			polls[i].events = slot->events;
+			++active;
+
+			long remaining = slot->deadline - now;
+			if (remaining < 0) { remaining = 0; }
+
+			if (wait == -1 || remaining < wait) {
+				wait = remaining;
+			}
+		}
+
+		if (active == 0) { 
+			continue; 
+		}
+
+		int poll_status = poll(polls, concurrency, wait);
+		if (poll_status < 0 && errno != EINTR) {
+			err = request_polling_error;
+			break;
+		}
+
+
+		/* advancing */
+
+		now = request_slots_now_private();
+		for (size_t i = 0; i < concurrency; i++) {
+			request_slot *slot = &slots[i];
+			if (slot->state == request_slot_idle_state) { continue; }
+
+			if (poll_status > 0 && polls[i].revents) {
+				error slot_error = request_successfull;
+				bool shall_continue = request_slots_advance_private(
+					slot, &slot_error, mem);
+
+				if (!shall_continue) {
+					request_slots_finish_private(
+						slot, slot_error, results, &option, mem);
+
+					++finished;
+					continue;
+				}
+			}
+
+			if (slot->deadline <= now) {
+				request_slots_finish_private(
+					slot, request_timeout_error, results, &option, mem);
+
+				++finished;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < concurrency; i++) {
+		if (slots[i].state != request_slot_idle_state) {
+			request_slots_finish_private(&slots[i], err, results, &option, mem);
+		}
+	}
+
+	/* never started, as polling failed */
+	for (size_t i = started; i < urls->size; i++) {
+		results[i] = (eresponse){.error=err};
+
+		if (option.callback) {
+			option.callback(i, &results[i], option.params);
+		}
+	}
+
+	mems_dealloc(mem, polls, sizeof(struct pollfd) * concurrency);
+	mems_dealloc(mem, slots, sizeof(request_slot) * concurrency);
+
+	return err;
+}
@@ -15,12 +15,17 @@
 #endif
 
 #include <netdb.h>
+#include <poll.h>
+#include <errno.h>
+#include <pthread.h>
 #include <arpa/inet.h>
 
 #include "errors.h"
 #include "strings.h"
 #include "vectors.h"
 #include "mems.h"
+#include "files.h"
+#include "traces.h"
 
 
 /*
@@ -55,6 +60,11 @@ typedef enum request_error {
 	request_certification_error,
 	request_port_error,
 	request_secure_not_implemented_error,
+	request_timeout_error,
+	request_polling_error,
+	request_head_too_large_error,
+	request_malformed_chunk_error,
+	request_streaming_error,
 	request_private_error
 } request_error;
 
@@ -134,6 +144,40 @@ typedef struct request_async {
 	eresponse response;
 } request_async;
 
+typedef void (*responsefunc)(size_t index, eresponse *response, void *params);
+
+typedef struct request_many_option {
+	/* maximum ammount of requests in-flight, 0 is unbounded */
+	size_t concurrency;
+	/* called as each request finishes */
+	responsefunc callback;
+	void *params;
+} request_many_option;
+
+typedef error (*streamfunc)(const byte *data, size_t size, void *params);
+
+typedef struct request_stream_option {
+	/* called with every decoded piece of body */
+	streamfunc callback;
+	void *params;
+	/* written with every decoded piece of body */
+	file *file;
+	/* maximum size of response head, 0 is 8KiB */
+	size_t max_head_size;
+} request_stream_option;
+
+/* ttl of request_resolver_option that keeps the default */
+#define request_resolver_default ((ulong)-1)
+
+typedef struct request_resolver_option {
+	/* seconds a resolved address is reused, 0 doesn't cache */
+	ulong ttl;
+	/* seconds a failed resolution is remembered, 0 doesn't cache */
+	ulong negative_ttl;
+	/* maximum ammount of cached host-port pairs, 0 is 64 */
+	size_t capacity;
+} request_resolver_option;
+
 static const char *request_error_messages[] = {
     [request_successfull] = "request was successful.",
     [request_default_error] = "error: unknown.",
@@ -157,7 +201,12 @@ static const char *request_error_messages[] = {
     [request_binding_secure_connection_error] = "error: failed to bind secure connection.",
     [request_certification_error] = "error: certification failed.",
     [request_secure_not_implemented_error] = "error: secure not implemented.",
-    [request_port_error] = "error: invalid port."
+    [request_port_error] = "error: invalid port.",
+    [request_timeout_error] = "error: request timed out.",
+    [request_polling_error] = "error: failed to poll connections.",
+    [request_head_too_large_error] = "error: response head is too large.",
+    [request_malformed_chunk_error] = "error: malformed chunked body.",
+    [request_streaming_error] = "error: failed to deliver streamed body."
 };
 
 static const char *request_methods[] = {
@@ -180,6 +229,40 @@ static const char *request_versions[] = {
  */
 void request_errors_println(request_error self);
 
+/*
+ * Configures the process-wide dns cache 
+ * used by requests, dropping any entry 
+ * already cached.
+ *
+ * Ttls set to request_resolver_default 
+ * fallback to defaults (60s ttl and 5s 
+ * negative_ttl), while a zeroed ttl 
+ * disables that kind of caching.
+ *
+ * #thread-safe #to-review
+ */
+void requests_configure_resolver(request_resolver_option option);
+
+/*
+ * Resolves 'host' at 'port' ahead of time, 
+ * warming the dns cache so that later 
+ * requests to it don't block on resolution.
+ *
+ * Returns request_dns_not_resolved_error 
+ * if the host couldn't be resolved.
+ *
+ * #thread-safe #to-review
+ */
+error requests_resolve(const string *host, const string *port);
+
+/*
+ * Drops every entry of the dns cache 
+ * and releases its memory.
+ *
+ * #thread-safe #to-review
+ */
+void requests_free_resolver(void);
+
 /*
  * Requests a site and returns 
  * response.
@@ -202,4 +285,56 @@ cels_warn_unused
 bool requests_make_async(
 	const string *url, request_async *request, const allocator *mem);
 
+/*
+ * Requests a site and returns the response 
+ * with only its head, the body being handed 
+ * to 'stream.callback' and/or written to 
+ * 'stream.file' as it arrives.
+ *
+ * 'Transfer-Encoding: chunked' is decoded 
+ * incrementally and memory is bounded by 
+ * 'initial_buffer_size' and 'max_head_size' 
+ * regardless of body size.
+ *
+ * #implicitly-allocates #allocates
+ * #to-review
+ */
+cels_warn_unused
+eresponse requests_stream(
+	const string *url, 
+	const request_option *option, 
+	request_stream_option stream, 
+	const allocator *mem);
+
+/*
+ * Requests every url in 'urls' concurrently, 
+ * driving all connections from a single poll 
+ * loop, and places each response in the 
+ * respective index of 'results' - which must 
+ * have 'urls.size' items.
+ *
+ * 'options' may be null or have 'urls.size' 
+ * items, each request's 'timeout' bounds 
+ * it from connection to completion.
+ *
+ * At most 'option.concurrency' requests are 
+ * in-flight at once and 'option.callback' is 
+ * called as each of them finishes.
+ *
+ * Returns fail only if the loop itself 
+ * couldn't run, request errors are placed 
+ * in 'results' - if polling fails, every 
+ * unfinished request gets its error.
+ *
+ * #implicitly-allocates #allocates
+ * #to-review
+ */
+cels_warn_unused
+error requests_make_many(
+	const string_vec *urls, 
+	const request_option *options, 
+	eresponse *results, 
+	request_many_option option, 
+	const allocator *mem);
+
 #endif
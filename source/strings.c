@@ -525,13 +525,7 @@ bool strings_seems(const string *self, const string *other) {
 		return false;
 	}
 
-	for (size_t i = 0; i < self->size - 1; i++) {
-		long diff = tolower(self->data[i]) - tolower(other->data[i]);
-
-		if (diff != 0) { return false; }
-	}
-
-	return true;
+	return texts_equals_case(self->data, other->data, self->size - 1);
 }
 
 ssize_t strings_find(const string *self, const string substring, size_t pos) {
@@ -912,30 +906,33 @@ string_vec strings_split_with(
 	return strings_split(self, sep_capsule, n, mem);
 }
 
+error string_builders_format_private(
+	string_builder *self, 
+	const char *format, 
+	va_list args, 
+	const allocator *mem);
+
 string strings_format(const char *const format, const allocator *mem, ...) {
 	#if cels_debug
 		errors_abort("format", !format);
 		errors_abort("format == '\\0'", format[0] == '\0');
 	#endif
 
-    va_list args, args2;
-    va_start(args, mem);
-    *args2 = *args;
+	/* most fit, formatting once */
+	string_builder builder = {0};
+	error init_error = string_builders_init(&builder, string_min_size - 1, mem);
+	errors_abort("text", init_error);
 
-    size_t buff_size = vsnprintf(null, 0, format, args) + 1;
-	size_t new_capacity = buff_size;
+	va_list args;
+	va_start(args, mem);
 
-    char *text = mems_alloc(mem, sizeof(char) * new_capacity);
-    errors_abort("text", !text);
+	error format_error = string_builders_format_private(
+		&builder, format, args, mem);
 
-    vsnprintf(text, buff_size, format, args2);
-    va_end(args);
+	va_end(args);
+	errors_abort("text", format_error);
 
-	string self = {
-		.data=text, 
-		.size=buff_size, 
-		.capacity=new_capacity
-	};
+	string self = string_builders_take(&builder, mem);
 
 	#if cels_debug
 		errors_abort("self", strings_check_extra(&self));
@@ -969,9 +966,7 @@ void strings_lower(string *self) {
 		errors_abort("self", strings_check_extra(self));
 	#endif
 
-	for (size_t i = 0; i < self->size - 1; i++) {
-		self->data[i] = tolower(self->data[i]);
-	}
+	texts_lower(self->data, self->size - 1);
 }
 
 void strings_upper(string *self) {
@@ -979,9 +974,7 @@ void strings_upper(string *self) {
 		errors_abort("self", strings_check_extra(self));
 	#endif
 
-	for (size_t i = 0; i < self->size - 1; i++) {
-		self->data[i] = toupper(self->data[i]);
-	}
+	texts_upper(self->data, self->size - 1);
 }
 
 //TODO?: maybe convert string_view to string and allocate it
@@ -1091,22 +1084,8 @@ void strings_trim(string *self) {
 		errors_abort("self", strings_check_extra(self));
 	#endif
 
-	size_t start = 0;
-	size_t end = 0;
-
-	for (size_t i = 0; i < self->size; i++) {
-		if (!chars_is_whitespace(self->data[i])) {
-			start = i;
-			break;
-		} 
-	}
-
-	for (ssize_t i = self->size - 2; i >= 0; i--) {
-		if (!chars_is_whitespace(self->data[i])) {
-			end = i + 1;
-			break;
-		} 
-	}
+	size_t start = texts_trim_start(self->data, self->size - 1);
+	size_t end = texts_trim_end(self->data, self->size - 1);
 
 	strings_slice(self, start, end);
 
@@ -1210,13 +1189,17 @@ string string_vecs_join(string_vec *self, string sep, const allocator *mem) {
 		capacity += sep.size - 1;
 	}
 
-	capacity -= sep.size - 1;
-	capacity++;
+	if (capacity > 0) {
+		capacity -= sep.size - 1;
+	}
+
+	string_builder builder = {0};
+	error init_error = string_builders_init(&builder, capacity, mem);
+	errors_abort("string_builders_init failed", init_error);
 
-	string joined = strings_init(capacity, mem);
 	for (size_t i = 0; i < self->size; i++) {
-		error push_error = strings_push(&joined, self->data[i], mem);
-		errors_abort("string_push failed", push_error);
+		error push_error = string_builders_push(&builder, &self->data[i], mem);
+		errors_abort("string_builders_push failed", push_error);
 
 		/*
 		 * TODO?: oblige the usage of allocators and 
@@ -1224,12 +1207,15 @@ string string_vecs_join(string_vec *self, string sep, const allocator *mem) {
 		 *
 		 */
 
-		if (i < self->size - 1) {
-			error push_error = strings_push(&joined, sep, mem);
-			errors_abort("string_push failed", push_error);
+		if (i < self->size - 1 && sep.size > 1) {
+			error push_error = string_builders_push(&builder, &sep, mem);
+			errors_abort("string_builders_push failed", push_error);
 		}
 	}
 
+	string joined = string_builders_take(&builder, mem);
+	errors_abort("string_builders_take failed", !joined.data);
+
 	#if cels_debug
 		errors_abort("joined", strings_check(&joined));
 	#endif
@@ -1267,6 +1253,649 @@ string_vec string_vecs_make_helper(
 }
 
 
+/* string_builders */
+
+/*
+ * Appends printf-like 'format' with 
+ * 'args', which it consumes.
+ */
+error string_builders_format_private(
+	string_builder *self, 
+	const char *format, 
+	va_list args, 
+	const allocator *mem) {
+
+	va_list retry;
+	va_copy(retry, args);
+
+	size_t spare = self->data ? self->capacity - self->size : 0;
+	char *position = self->data ? self->data + self->size : null;
+
+	int length = vsnprintf(position, spare, format, args);
+	if (length < 0) {
+		va_end(retry);
+		return fail;
+	}
+
+	if ((size_t)length >= spare) {
+		error reserve_error = string_builders_reserve(self, length, mem);
+		if (reserve_error) {
+			va_end(retry);
+			return fail;
+		}
+
+		vsnprintf(self->data + self->size, length + 1, format, retry);
+	}
+
+	va_end(retry);
+
+	self->size += length;
+	return ok;
+}
+
+error string_builders_init(
+	string_builder *self, size_t capacity, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	*self = (string_builder){0};
+	return string_builders_reserve(self, capacity, mem);
+}
+
+error string_builders_reserve(
+	string_builder *self, size_t size, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	/* one more for the '\0' take writes */
+	size_t needed = self->size + size + 1;
+	if (self->data && needed <= self->capacity) {
+		return ok;
+	}
+
+	size_t capacity = self->capacity > 0 ? self->capacity : string_min_size;
+	while (capacity < needed) {
+		size_t new_capacity = capacity << 1;
+		if (new_capacity < capacity) {
+			return fail;
+		}
+
+		capacity = new_capacity;
+	}
+
+	char *data = self->data ? 
+		mems_realloc(mem, self->data, self->capacity, capacity) :
+		mems_alloc(mem, capacity);
+
+	if (!data) {
+		return fail;
+	}
+
+	self->data = data;
+	self->capacity = capacity;
+
+	return ok;
+}
+
+error string_builders_push(
+	string_builder *self, const string_view *item, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("item", string_views_check(item));
+	#endif
+
+	size_t size = item->size > 0 ? item->size - 1 : 0;
+
+	error reserve_error = string_builders_reserve(self, size, mem);
+	if (reserve_error) {
+		return fail;
+	}
+
+	memcpy(self->data + self->size, item->data, size);
+	self->size += size;
+
+	return ok;
+}
+
+error string_builders_push_with(
+	string_builder *self, const char *item, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("item", !item);
+	#endif
+
+	size_t size = strlen(item);
+	string_view item_capsule = {
+		.data=(char *)item, 
+		.size=size + 1, 
+		.capacity=size + 1
+	};
+
+	return string_builders_push(self, &item_capsule, mem);
+}
+
+error string_builders_push_char(
+	string_builder *self, char letter, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	error reserve_error = string_builders_reserve(self, 1, mem);
+	if (reserve_error) {
+		return fail;
+	}
+
+	self->data[self->size++] = letter;
+	return ok;
+}
+
+error string_builders_push_integer(
+	string_builder *self, long long value, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	char digits[24];
+	size_t position = sizeof(digits);
+
+	/* negated as unsigned so the minimum doesn't overflow */
+	unsigned long long magnitude = value < 0 ? 
+		0ull - (unsigned long long)value : 
+		(unsigned long long)value;
+
+	do {
+		digits[--position] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude > 0);
+
+	if (value < 0) {
+		digits[--position] = '-';
+	}
+
+	size_t size = sizeof(digits) - position;
+
+	error reserve_error = string_builders_reserve(self, size, mem);
+	if (reserve_error) {
+		return fail;
+	}
+
+	memcpy(self->data + self->size, digits + position, size);
+	self->size += size;
+
+	return ok;
+}
+
+error string_builders_push_float(
+	string_builder *self, double value, int precision, const allocator *mem) {
+
+	return string_builders_format(self, "%.*f", mem, precision, value);
+}
+
+error string_builders_format(
+	string_builder *self, const char *format, const allocator *mem, ...) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("format", !format);
+	#endif
+
+	va_list args;
+	va_start(args, mem);
+
+	error format_error = string_builders_format_private(
+		self, format, args, mem);
+
+	va_end(args);
+	return format_error;
+}
+
+void string_builders_clear(string_builder *self) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	self->size = 0;
+}
+
+string string_builders_take(string_builder *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	error reserve_error = string_builders_reserve(self, 0, mem);
+	if (reserve_error) {
+		return (string){0};
+	}
+
+	self->data[self->size] = '\0';
+
+	string taken = {
+		.size=self->size + 1, 
+		.capacity=self->capacity, 
+		.data=self->data
+	};
+
+	*self = (string_builder){0};
+	return taken;
+}
+
+void string_builders_free(string_builder *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->data) {
+		mems_dealloc(mem, self->data, self->capacity);
+	}
+
+	*self = (string_builder){0};
+}
+
+
+/* string_splitters */
+
+/*
+ * Finds 'sep' within the first 'size' 
+ * bytes of 'data' from 'position', 
+ * else returns -1.
+ */
+ssize_t string_splitters_find_private(
+	const char *data, size_t size, size_t position, const string_view *sep) {
+
+	size_t sep_size = sep->size - 1;
+
+	while (position + sep_size <= size) {
+		const char *candidate = memchr(
+			data + position, sep->data[0], size - position - sep_size + 1);
+
+		if (!candidate) {
+			return -1;
+		}
+
+		size_t index = candidate - data;
+		if (memcmp(candidate + 1, sep->data + 1, sep_size - 1) == 0) {
+			return index;
+		}
+
+		position = index + 1;
+	}
+
+	return -1;
+}
+
+string_splitter string_splitters_init(
+	const string *text, string_view sep, string_split_option option) {
+
+	#if cels_debug
+		errors_abort("text", string_views_check(text));
+	#endif
+
+	return (string_splitter) {
+		.text=text,
+		.sep=sep,
+		.option=option,
+		.is_done=text->size == 0,
+	};
+}
+
+bool string_splitters_next(string_splitter *self, string_view *piece) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("piece", !piece);
+	#endif
+
+	size_t size = self->text->size - 1;
+	size_t sep_size = self->sep.size > 0 ? self->sep.size - 1 : 0;
+
+	while (!self->is_done) {
+		size_t start = self->position;
+		size_t end = size;
+
+		bool is_limited = 
+			self->option.limit > 0 && 
+			self->splits >= self->option.limit;
+
+		ssize_t found = -1;
+		if (!is_limited && sep_size > 0) {
+			found = string_splitters_find_private(
+				self->text->data, size, start, &self->sep);
+		}
+
+		if (found < 0) {
+			self->is_done = true;
+		} else {
+			end = found;
+			self->position = found + sep_size;
+			self->splits++;
+		}
+
+		if (self->option.skip_empty && end == start) {
+			continue;
+		}
+
+		*piece = (string_view) {
+			.data=self->text->data + start,
+			.size=end - start + 1,
+			.capacity=end - start + 1,
+		};
+
+		return true;
+	}
+
+	return false;
+}
+
+error strings_split_views(
+	const string *self, 
+	string_view sep, 
+	string_split_option option, 
+	string_view_vec *views,
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("views", vectors_check((const vector *)views));
+	#endif
+
+	string_splitter splitter = string_splitters_init(self, sep, option);
+
+	string_view piece = {0};
+	while (string_splitters_next(&splitter, &piece)) {
+		error push_error = vectors_push(views, &piece, mem);
+		if (push_error) {
+			return fail;
+		}
+	}
+
+	return ok;
+}
+
+
+/* string_matchers */
+
+error string_matchers_init(
+	string_matcher *self, 
+	const string *patterns, 
+	const string *replaces, 
+	size_t size, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("patterns", !patterns);
+		errors_abort("size", size == 0);
+	#endif
+
+	*self = (string_matcher){.replaces=replaces, .patterns_size=size};
+
+
+	/* classifying bytes */
+
+	size_t states_capacity = 1;
+	for (size_t i = 0; i < size; i++) {
+		if (patterns[i].size < 2 || patterns[i].size - 1 > UINT32_MAX) {
+			return fail;
+		}
+
+		for (size_t j = 0; j < patterns[i].size - 1; j++) {
+			self->classes[(unsigned char)patterns[i].data[j]] = 1;
+		}
+
+		states_capacity += patterns[i].size - 1;
+	}
+
+	if (states_capacity > UINT32_MAX) {
+		return fail;
+	}
+
+	self->classes_size = 1;
+	for (size_t i = 0; i < 256; i++) {
+		if (self->classes[i]) {
+			self->classes[i] = self->classes_size++;
+		}
+	}
+
+
+	/* allocating */
+
+	size_t columns = self->classes_size;
+	size_t transitions_size = sizeof(uint32_t) * states_capacity * columns;
+
+	self->transitions = mems_alloc(mem, transitions_size);
+	if (!self->transitions) { goto cleanup0; }
+
+	self->outputs = mems_alloc(mem, sizeof(uint32_t) * states_capacity);
+	if (!self->outputs) { goto cleanup1; }
+
+	self->sizes = mems_alloc(mem, sizeof(size_t) * size);
+	if (!self->sizes) { goto cleanup2; }
+
+	/* used for fail links and then as the queue */
+	uint32_t *fails = mems_alloc(mem, sizeof(uint32_t) * states_capacity);
+	if (!fails) { goto cleanup3; }
+
+	uint32_t *queue = mems_alloc(mem, sizeof(uint32_t) * states_capacity);
+	if (!queue) { goto cleanup4; }
+
+	memset(self->transitions, 0, transitions_size);
+	memset(self->outputs, 0, sizeof(uint32_t) * states_capacity);
+
+
+	/* building trie, 0 as next state means none */
+
+	self->states_size = 1;
+	for (size_t i = 0; i < size; i++) {
+		uint32_t state = 0;
+
+		for (size_t j = 0; j < patterns[i].size - 1; j++) {
+			size_t column = self->classes[(unsigned char)patterns[i].data[j]];
+			uint32_t *next = &self->transitions[state * columns + column];
+
+			if (*next == 0) {
+				*next = self->states_size++;
+			}
+
+			state = *next;
+		}
+
+		if (self->outputs[state] == 0) {
+			self->outputs[state] = i + 1;
+		}
+
+		self->sizes[i] = patterns[i].size - 1;
+	}
+
+
+	/* linking failures breadth-first, turning the trie into a dfa */
+
+	size_t head = 0;
+	size_t tail = 0;
+
+	for (size_t c = 0; c < columns; c++) {
+		uint32_t child = self->transitions[c];
+		if (child != 0) {
+			fails[child] = 0;
+			queue[tail++] = child;
+		}
+	}
+
+	while (head < tail) {
+		uint32_t state = queue[head++];
+
+		/* the longest pattern ending here, its own or a suffix's */
+		if (self->outputs[state] == 0) {
+			self->outputs[state] = self->outputs[fails[state]];
+		}
+
+		for (size_t c = 0; c < columns; c++) {
+			uint32_t *next = &self->transitions[state * columns + c];
+			uint32_t fallback = self->transitions[fails[state] * columns + c];
+
+			if (*next != 0) {
+				fails[*next] = fallback;
+				queue[tail++] = *next;
+			} else {
+				*next = fallback;
+			}
+		}
+	}
+
+	mems_dealloc(mem, queue, sizeof(uint32_t) * states_capacity);
+	mems_dealloc(mem, fails, sizeof(uint32_t) * states_capacity);
+
+	return ok;
+
+	cleanup4:
+	mems_dealloc(mem, fails, sizeof(uint32_t) * states_capacity);
+
+	cleanup3:
+	mems_dealloc(mem, self->sizes, sizeof(size_t) * size);
+
+	cleanup2:
+	mems_dealloc(mem, self->outputs, sizeof(uint32_t) * states_capacity);
+
+	cleanup1:
+	mems_dealloc(mem, self->transitions, transitions_size);
+
+	cleanup0:
+	*self = (string_matcher){0};
+	return fail;
+}
+
+error string_matchers_find(
+	const string_matcher *self, 
+	const string *text, 
+	string_match_vec *matches, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self || !self->transitions);
+		errors_abort("text", string_views_check(text));
+		errors_abort("matches", vectors_check((const vector *)matches));
+	#endif
+
+	size_t columns = self->classes_size;
+	uint32_t state = 0;
+
+	for (size_t i = 0; i + 1 < text->size; i++) {
+		size_t column = self->classes[(unsigned char)text->data[i]];
+		state = self->transitions[state * columns + column];
+
+		if (self->outputs[state] == 0) {
+			continue;
+		}
+
+		size_t pattern = self->outputs[state] - 1;
+		string_match match = {
+			.position=i + 1 - self->sizes[pattern],
+			.size=self->sizes[pattern],
+			.pattern=pattern,
+		};
+
+		error push_error = vectors_push(matches, &match, mem);
+		if (push_error) {
+			return fail;
+		}
+
+		state = 0;
+	}
+
+	return ok;
+}
+
+error string_matchers_replace(
+	const string_matcher *self, 
+	const string *text, 
+	string_builder *output, 
+	const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self || !self->transitions);
+		errors_abort("text", string_views_check(text));
+		errors_abort("output", !output);
+	#endif
+
+	error reserve_error = string_builders_reserve(output, text->size, mem);
+	if (reserve_error) {
+		return fail;
+	}
+
+	size_t columns = self->classes_size;
+	size_t emitted = 0;
+	uint32_t state = 0;
+
+	for (size_t i = 0; i + 1 < text->size; i++) {
+		size_t column = self->classes[(unsigned char)text->data[i]];
+		state = self->transitions[state * columns + column];
+
+		if (self->outputs[state] == 0) {
+			continue;
+		}
+
+		size_t pattern = self->outputs[state] - 1;
+		size_t position = i + 1 - self->sizes[pattern];
+
+		string_view before = {
+			.data=text->data + emitted,
+			.size=position - emitted + 1,
+			.capacity=position - emitted + 1,
+		};
+
+		error push_error = string_builders_push(output, &before, mem);
+		if (push_error) {
+			return fail;
+		}
+
+		if (self->replaces && self->replaces[pattern].size > 1) {
+			push_error = string_builders_push(
+				output, &self->replaces[pattern], mem);
+
+			if (push_error) {
+				return fail;
+			}
+		}
+
+		emitted = i + 1;
+		state = 0;
+	}
+
+	string_view rest = {
+		.data=text->data + emitted,
+		.size=text->size - emitted,
+		.capacity=text->size - emitted,
+	};
+
+	return string_builders_push(output, &rest, mem);
+}
+
+void string_matchers_free(string_matcher *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	size_t states_capacity = 1;
+	for (size_t i = 0; i < self->patterns_size; i++) {
+		states_capacity += self->sizes[i];
+	}
+
+	mems_dealloc(
+		mem, 
+		self->transitions, 
+		sizeof(uint32_t) * states_capacity * self->classes_size);
+
+	mems_dealloc(mem, self->outputs, sizeof(uint32_t) * states_capacity);
+	mems_dealloc(mem, self->sizes, sizeof(size_t) * self->patterns_size);
+
+	*self = (string_matcher){0};
+}
+
+
 /* sets */
 
 string_set string_sets_init(void) {
@@ -1303,6 +1932,16 @@ error string_sets_push(string_set *self, string item, const allocator *mem) {
 	return sets_push(self, &item, hash, mem);
 }
 
+error string_sets_remove(string_set *self, string item, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("item", strings_check_extra(&item));
+	#endif
+
+	size_t hash = strings_hash(&item);
+	return sets_remove(self, hash, (freefunc)strings_free, mem);
+}
+
 
 /* maps */
 
@@ -1350,6 +1989,17 @@ error string_maps_push(
 	return maps_push(self, &pair, hash, mem);
 }
 
+error string_maps_remove(string_map *self, string key, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("key", strings_check_extra(&key));
+	#endif
+
+	size_t hash = strings_hash(&key);
+	return maps_remove(
+		self, hash, (freefunc)strings_free, (freefunc)strings_free, mem);
+}
+
 error string_maps_push_with(
 	string_map *self, 
 	const char *key, 
@@ -1365,3 +2015,279 @@ error string_maps_push_with(
 	string v = strings_make(value, mem);
 	return string_maps_push(self, k, v, mem);
 }
+
+
+/* interns */
+
+#define string_intern_capacity 64
+
+/*
+ * Hashes the bytes of 'item' (fnv-1a), 
+ * unlike strings_hash it is case-sensitive.
+ */
+size_t string_interns_hash_private(const string_view *item) {
+	size_t hash = 14695981039346656037u;
+	for (size_t i = 0; i < item->size - 1; i++) {
+		hash ^= (unsigned char)item->data[i];
+		hash *= 1099511628211u;
+	}
+
+	return hash;
+}
+
+/*
+ * Gets the slot holding 'item' or, 
+ * if absent, the empty slot it goes to.
+ */
+size_t string_interns_slot_private(
+	const string_intern *self, const string_view *item, size_t hash) {
+
+	size_t mask = self->slots_capacity - 1;
+	size_t slot = hash & mask;
+
+	while (self->slots[slot] != 0) {
+		const string_intern_entry *entry = &self->entries[self->slots[slot] - 1];
+		bool is_equal = 
+			entry->hash == hash && 
+			entry->value->size == item->size &&
+			memcmp(entry->value->data, item->data, item->size - 1) == 0;
+
+		if (is_equal) {
+			return slot;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+/*
+ * Doubles entries and, keeping load 
+ * under half, rebuilds the index.
+ */
+error string_interns_grow_private(string_intern *self, const allocator *mem) {
+	size_t capacity = self->capacity * 2;
+	string_intern_entry *entries = mems_realloc(
+		mem,
+		self->entries,
+		sizeof(string_intern_entry) * self->capacity,
+		sizeof(string_intern_entry) * capacity);
+
+	if (!entries) {
+		return fail;
+	}
+
+	self->entries = entries;
+	self->capacity = capacity;
+
+	size_t slots_capacity = self->slots_capacity * 2;
+	string_id *slots = mems_alloc(mem, sizeof(string_id) * slots_capacity);
+	if (!slots) {
+		return fail;
+	}
+
+	memset(slots, 0, sizeof(string_id) * slots_capacity);
+	mems_dealloc(mem, self->slots, sizeof(string_id) * self->slots_capacity);
+
+	self->slots = slots;
+	self->slots_capacity = slots_capacity;
+
+	size_t mask = slots_capacity - 1;
+	for (size_t i = 0; i < self->size; i++) {
+		size_t slot = self->entries[i].hash & mask;
+		while (slots[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+
+		slots[slot] = (string_id)(i + 1);
+	}
+
+	return ok;
+}
+
+error string_interns_init(
+	string_intern *self, string_intern_option option, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	*self = (string_intern){.option=option};
+
+	if (self->option.capacity == 0) {
+		self->option.capacity = string_intern_capacity;
+	}
+
+	if (self->option.block_size == 0) {
+		self->option.block_size = string_big_size;
+	}
+
+	self->capacity = self->option.capacity;
+	self->slots_capacity = maths_nearest_two_power(self->capacity * 2);
+
+	self->entries = mems_alloc(
+		mem, sizeof(string_intern_entry) * self->capacity);
+
+	if (!self->entries) {
+		goto cleanup0;
+	}
+
+	self->slots = mems_alloc(mem, sizeof(string_id) * self->slots_capacity);
+	if (!self->slots) {
+		goto cleanup1;
+	}
+
+	memset(self->slots, 0, sizeof(string_id) * self->slots_capacity);
+
+	if (self->option.is_thread_safe) {
+		if (pthread_rwlock_init(&self->lock, null) != 0) {
+			goto cleanup2;
+		}
+	}
+
+	self->arena = arenas_init(self->option.block_size);
+	return ok;
+
+	cleanup2:
+	mems_dealloc(mem, self->slots, sizeof(string_id) * self->slots_capacity);
+
+	cleanup1:
+	mems_dealloc(
+		mem, self->entries, sizeof(string_intern_entry) * self->capacity);
+
+	cleanup0:
+	return fail;
+}
+
+string_id string_interns_push(
+	string_intern *self, const string_view *item, const allocator *mem) {
+
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("item", string_views_check(item));
+	#endif
+
+	size_t hash = string_interns_hash_private(item);
+
+	string_id id = string_interns_find(self, item);
+	if (id != 0) {
+		return id;
+	}
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_wrlock(&self->lock);
+	}
+
+	/* another thread may have pushed it meanwhile */
+	size_t slot = string_interns_slot_private(self, item, hash);
+	id = self->slots[slot];
+	if (id != 0) {
+		goto cleanup0;
+	}
+
+	if (self->size >= UINT32_MAX - 1) {
+		goto cleanup0;
+	}
+
+	if (self->size == self->capacity) {
+		error grow_error = string_interns_grow_private(self, mem);
+		if (grow_error) {
+			goto cleanup0;
+		}
+
+		slot = string_interns_slot_private(self, item, hash);
+	}
+
+	/* header and characters together, keeping headers aligned */
+	size_t block_size = sizeof(string) + item->size;
+	block_size = (block_size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+
+	string *value = mems_alloc(&self->arena, block_size);
+	if (!value) {
+		goto cleanup0;
+	}
+
+	*value = (string) {
+		.size=item->size,
+		.capacity=item->size,
+		.data=(char *)(value + 1),
+	};
+
+	memcpy(value->data, item->data, item->size - 1);
+	value->data[item->size - 1] = '\0';
+
+	self->entries[self->size] = (string_intern_entry){.value=value, .hash=hash};
+	self->size++;
+
+	id = (string_id)self->size;
+	self->slots[slot] = id;
+
+	cleanup0:
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_unlock(&self->lock);
+	}
+
+	return id;
+}
+
+string_id string_interns_find(string_intern *self, const string_view *item) {
+	#if cels_debug
+		errors_abort("self", !self);
+		errors_abort("item", string_views_check(item));
+	#endif
+
+	size_t hash = string_interns_hash_private(item);
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_rdlock(&self->lock);
+	}
+
+	size_t slot = string_interns_slot_private(self, item, hash);
+	string_id id = self->slots[slot];
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_unlock(&self->lock);
+	}
+
+	return id;
+}
+
+const string *string_interns_get(string_intern *self, string_id id) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_rdlock(&self->lock);
+	}
+
+	const string *value = id != 0 && id <= self->size ? 
+		self->entries[id - 1].value : 
+		null;
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_unlock(&self->lock);
+	}
+
+	return value;
+}
+
+void string_interns_free(string_intern *self, const allocator *mem) {
+	#if cels_debug
+		errors_abort("self", !self);
+	#endif
+
+	mems_free(&self->arena, null);
+	mems_dealloc(
+		mem, self->entries, sizeof(string_intern_entry) * self->capacity);
+	mems_dealloc(mem, self->slots, sizeof(string_id) * self->slots_capacity);
+
+	if (self->option.is_thread_safe) {
+		pthread_rwlock_destroy(&self->lock);
+	}
+
+	*self = (string_intern){0};
+}
+
+#undef string_intern_capacity
@@ -8,10 +8,12 @@
 #include <stdarg.h>
 #include <math.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #include "errors.h"
 #include "vectors.h"
 #include "maths.h"
+#include "texts.h"
 
 
 /*
@@ -671,6 +673,258 @@ string_vec string_vecs_make_helper(
 	char *args[], size_t argn, const allocator *mem);
 
 
+/* string_builders */
+
+/*
+ * Accumulates appends in a buffer growing 
+ * geometrically, so building a string of 
+ * n bytes reallocates O(log n) times.
+ *
+ * A zeroed string_builder is valid.
+ */
+typedef struct string_builder {
+	/* characters written, without '\0' */
+	size_t size;
+	size_t capacity;
+	char *data;
+} string_builder;
+
+/*
+ * Initializes builder with room 
+ * for 'capacity' characters.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error string_builders_init(
+	string_builder *self, size_t capacity, const allocator *mem);
+
+/*
+ * Ensures room for 'size' characters 
+ * more, doubling capacity as needed.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error string_builders_reserve(
+	string_builder *self, size_t size, const allocator *mem);
+
+/*
+ * Appends 'item' (a string or view).
+ *
+ * #allocates #to-review
+ */
+error string_builders_push(
+	string_builder *self, const string_view *item, const allocator *mem);
+
+/*
+ * Appends null-terminated 'item'.
+ *
+ * #allocates #to-review
+ */
+error string_builders_push_with(
+	string_builder *self, const char *item, const allocator *mem);
+
+/*
+ * Appends 'letter'.
+ *
+ * #allocates #to-review
+ */
+error string_builders_push_char(
+	string_builder *self, char letter, const allocator *mem);
+
+/*
+ * Appends 'value' in decimal.
+ *
+ * #allocates #to-review
+ */
+error string_builders_push_integer(
+	string_builder *self, long long value, const allocator *mem);
+
+/*
+ * Appends 'value' with 'precision' 
+ * digits after the point.
+ *
+ * #allocates #to-review
+ */
+error string_builders_push_float(
+	string_builder *self, double value, int precision, const allocator *mem);
+
+/*
+ * Appends printf-like 'format' straight 
+ * into spare capacity, formatting twice 
+ * only when it does not fit.
+ *
+ * #allocates #to-review
+ */
+__attribute__ ((__format__ (printf, 2, 4)))
+error string_builders_format(
+	string_builder *self, const char *format, const allocator *mem, ...);
+
+/*
+ * Empties builder keeping its capacity.
+ *
+ * #to-review
+ */
+void string_builders_clear(string_builder *self);
+
+/*
+ * Hands the built string over without 
+ * copying, leaving builder zeroed.
+ *
+ * If an error happens, data is null.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+string string_builders_take(string_builder *self, const allocator *mem);
+
+/*
+ * Frees builder.
+ *
+ * #to-review
+ */
+void string_builders_free(string_builder *self, const allocator *mem);
+
+
+/* string_splitters */
+
+typedef struct string_split_option {
+	/* splits at most 'limit' times, the last piece keeps the rest, 0 is unrestricted */
+	size_t limit;
+	/* skips pieces between adjacent separators */
+	bool skip_empty;
+} string_split_option;
+
+/*
+ * Walks 'text' piece by piece without 
+ * allocating, yielding views into it - 
+ * 'text' must outlive them.
+ */
+typedef struct string_splitter {
+	const string *text;
+	string_view sep;
+	string_split_option option;
+	/* start of the next piece */
+	size_t position;
+	size_t splits;
+	bool is_done;
+} string_splitter;
+
+/*
+ * Initializes a lazy split of 'text' 
+ * (a string or view) by 'sep'.
+ *
+ * #case-sensitive #to-review
+ */
+cels_warn_unused
+string_splitter string_splitters_init(
+	const string *text, string_view sep, string_split_option option);
+
+/*
+ * Sets 'piece' to the next view and 
+ * returns true, or false when over.
+ *
+ * #to-review
+ */
+bool string_splitters_next(string_splitter *self, string_view *piece);
+
+/*
+ * Pushes the views of splitting 'self' by 
+ * 'sep' into 'views', copying no characters.
+ *
+ * #allocates #case-sensitive #to-review
+ */
+error strings_split_views(
+	const string *self, 
+	string_view sep, 
+	string_split_option option, 
+	string_view_vec *views,
+	const allocator *mem);
+
+
+/* string_matchers */
+
+typedef struct string_match {
+	size_t position;
+	size_t size;
+	/* index of the pattern matched */
+	size_t pattern;
+} string_match;
+
+typedef vectors(string_match) string_match_vec;
+
+/*
+ * An aho-corasick automaton finding many 
+ * patterns in a single pass - its states 
+ * are rows of a table indexed by byte class, 
+ * only bytes in patterns get their own.
+ */
+typedef struct string_matcher {
+	/* byte to column, 0 is any byte absent from patterns */
+	uint16_t classes[256];
+	size_t classes_size;
+	/* next state of each state and class */
+	uint32_t *transitions;
+	/* pattern + 1 of the longest one ending at each state, 0 is none */
+	uint32_t *outputs;
+	size_t states_size;
+	/* sizes, without '\0', of each pattern */
+	size_t *sizes;
+	/* not owned, may be null */
+	const string *replaces;
+	size_t patterns_size;
+} string_matcher;
+
+/*
+ * Builds the automaton of 'patterns' (which 
+ * can't be empty), 'replaces' pairs with 
+ * them, may be null and must outlive it.
+ *
+ * #allocates #case-sensitive #to-review
+ */
+cels_warn_unused
+error string_matchers_init(
+	string_matcher *self, 
+	const string *patterns, 
+	const string *replaces, 
+	size_t size, 
+	const allocator *mem);
+
+/*
+ * Pushes the matches in 'text' to 'matches', 
+ * which don't overlap - the one ending first 
+ * wins and, among those, the longest.
+ *
+ * #allocates #to-review
+ */
+error string_matchers_find(
+	const string_matcher *self, 
+	const string *text, 
+	string_match_vec *matches, 
+	const allocator *mem);
+
+/*
+ * Appends 'text' to 'output' with each 
+ * match swapped for its replace, in a 
+ * single pass whatever the patterns.
+ *
+ * #allocates #to-review
+ */
+error string_matchers_replace(
+	const string_matcher *self, 
+	const string *text, 
+	string_builder *output, 
+	const allocator *mem);
+
+/*
+ * Frees matcher.
+ *
+ * #to-review
+ */
+void string_matchers_free(string_matcher *self, const allocator *mem);
+
+
 /* extras */
 
 #include "nodes.h"
@@ -708,6 +962,13 @@ string *string_sets_get(const string_set *self, string item);
  */
 error string_sets_push(string_set *self, string item, const allocator *mem);
 
+/*
+ * Removes item from set, freeing it.
+ *
+ * #to-review
+ */
+error string_sets_remove(string_set *self, string item, const allocator *mem);
+
 
 /* maps */
 
@@ -743,6 +1004,14 @@ string *string_maps_get(const string_map *self, string key);
 error string_maps_push(
 	string_map *self, string key, string value, const allocator *mem);
 
+/*
+ * Removes pair of key from map, 
+ * freeing its key and value.
+ *
+ * #to-review
+ */
+error string_maps_remove(string_map *self, string key, const allocator *mem);
+
 /*
  * Push key and value over string_map allocating 
  * string's with mem. This function is a 
@@ -758,4 +1027,92 @@ error string_maps_push_with(
 
 pools(string_pool, string)
 
+
+/* interns */
+
+/* 
+ * Identifies an interned string, equal 
+ * strings share an id - 0 is none.
+ */
+typedef uint32_t string_id;
+
+typedef struct string_intern_entry {
+	string *value;
+	size_t hash;
+} string_intern_entry;
+
+typedef struct string_intern_option {
+	/* expected ammount of strings, 0 is 64 */
+	size_t capacity;
+	/* bytes of each arena block, 0 is string_big_size */
+	size_t block_size;
+	/* guards it with a lock, so threads may share it */
+	bool is_thread_safe;
+} string_intern_option;
+
+typedef struct string_intern {
+	string_intern_option option;
+	/* holds every interned string */
+	allocator arena;
+	/* entry of id is at 'id - 1' */
+	string_intern_entry *entries;
+	size_t size;
+	size_t capacity;
+	/* open addressed index of ids, 0 is empty */
+	string_id *slots;
+	size_t slots_capacity;
+	pthread_rwlock_t lock;
+} string_intern;
+
+/*
+ * Initializes an interning table whose 
+ * strings live in a single arena, zeroed 
+ * fields in 'option' fallback to defaults.
+ *
+ * #allocates #to-review
+ */
+cels_warn_unused
+error string_interns_init(
+	string_intern *self, string_intern_option option, const allocator *mem);
+
+/*
+ * Interns a copy of 'item' (once) and 
+ * returns its id, so comparing interned 
+ * strings is comparing ids.
+ *
+ * If an error happens, it returns 0.
+ *
+ * #allocates #case-sensitive #to-review
+ */
+cels_warn_unused
+string_id string_interns_push(
+	string_intern *self, const string_view *item, const allocator *mem);
+
+/*
+ * Gets the id of 'item' if it was 
+ * interned, else 0.
+ *
+ * #case-sensitive #to-review
+ */
+cels_warn_unused
+string_id string_interns_find(string_intern *self, const string_view *item);
+
+/*
+ * Gets the canonical string of 'id', 
+ * which lives until the table is freed, 
+ * else null.
+ *
+ * #to-review
+ */
+cels_warn_unused
+const string *string_interns_get(string_intern *self, string_id id);
+
+/*
+ * Frees the table and every 
+ * string interned in it.
+ *
+ * #to-review
+ */
+void string_interns_free(string_intern *self, const allocator *mem);
+
 #endif
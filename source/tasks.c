@@ -25,8 +25,10 @@ void *routines_make_thread_private(void *args) {
 				continue;
 			}
 
+			traces_begin("routines_task");
 			int status = it.data->callback.func(
 				it.data->callback.params);
+			traces_end("routines_task");
 
 			it.data->status = status;
 			if (status != task_finished_state) {
@@ -117,8 +119,10 @@ error routines_make_private(routine *self, routine_option option) {
 				continue;
 			}
 
+			traces_begin("routines_task");
 			int status = it.data->callback.func(
 				it.data->callback.params);
+			traces_end("routines_task");
 
 			it.data->status = status;
 			if (status != task_finished_state) {
@@ -160,6 +164,8 @@ routine routines_init(size_t capacity, const allocator *mem) {
 }
 
 error routines_make(routine *self, routine_option option) {
+	traces_scope("routines_make");
+
 	if (option.is_threads_enabled) {
 		return routines_make_with_threads_private(self, option);
 	} 
@@ -3,6 +3,7 @@
 
 #include "nodes.h"
 #include "pthread.h"
+#include "traces.h"
 
 
 /*
@@ -200,7 +200,7 @@ error templets_parse(
 					goto cleanup0;
 				}
 
-				node->data = tag;
+				*node = (templet_tree_node){.data=tag};
 				error push_error = mutrees_push(&sections, leaf, node);
 				if (push_error) {
 					strings_free(&tag.text, mem);
@@ -229,7 +229,7 @@ error templets_parse(
 					goto cleanup0;
 				}
 
-				node->data = tag;
+				*node = (templet_tree_node){.data=tag};
 				error push_error = mutrees_push(&sections, leaf, node);
 				if (push_error) {
 					mems_dealloc(mem, node, sizeof(templet_tree_node));
@@ -248,7 +248,7 @@ error templets_parse(
 					goto cleanup0;
 				}
 
-				node->data = tag;
+				*node = (templet_tree_node){.data=tag};
 
 				error push_error = false;
 				bool is_for = 
@@ -296,7 +296,7 @@ error templets_parse(
 				goto cleanup0;
 			}
 
-			node->data = sec;
+			*node = (templet_tree_node){.data=sec};
 
 			error push_error = ok;
 
@@ -421,11 +421,7 @@ typedef struct templet_stack {
 	size_t cursor;
 } templet_stack;
 
-typedef struct {
-  size_t size;
-  size_t capacity;
-  templet_stack *data;
-} templet_stack_vec;
+typedef vectors(templet_stack) templet_stack_vec;
 
 estring templets_get_value_private(
 	string_map *map, string text, const allocator *mem) {
@@ -598,6 +594,8 @@ estring templets_unmake(
 		errors_abort("options", binodes_check((binode *)options->data));
 	#endif
 
+	traces_scope("templets_unmake");
+
 	error err = ok;
 	const string templet_name_capsule = strings_encapsulate(templet_name);
 	templet_tree *templet = maps_get(
@@ -609,15 +607,21 @@ estring templets_unmake(
 	}
 
 	templet_stack_vec stack = {0};
+	string_builder document = {0};
+
 	error init_error = vectors_init(&stack, sizeof(templet_stack), 4, mem);
 	if (init_error) { goto cleanup1; }
 
-	string document = strings_init(string_small_size, mem);
+	init_error = string_builders_init(&document, string_small_size, mem);
+	if (init_error) { goto cleanup1; }
+
 	templet_tree_iterator it = {0};
 
 	while (mutrees_next(templet, &it)) {
 		if (it.data->data.op == templet_none_operator) {
-			error push_error = strings_push(&document, it.data->data.text, mem);
+			error push_error = string_builders_push(
+				&document, &it.data->data.text, mem);
+
 			if (push_error) {
 				err = templet_allocation_error;
 				goto cleanup1;
@@ -648,7 +652,7 @@ estring templets_unmake(
 				goto cleanup1;
 			}
 
-			error push_error = strings_push(&document, value.value, mem);
+			error push_error = string_builders_push(&document, &value.value, mem);
 			if (push_error) {
 				goto cleanup1;
 			}
@@ -775,10 +779,16 @@ estring templets_unmake(
 	}
 	vectors_free(&stack, null, mem);
 
-	return (estring){.value=document};
+	string taken = string_builders_take(&document, mem);
+	if (!taken.data) {
+		string_builders_free(&document, mem);
+		return (estring){.error=templet_allocation_error};
+	}
+
+	return (estring){.value=taken};
 
 	cleanup1:
-	strings_free(&document, mem);
+	string_builders_free(&document, mem);
 
 	for (size_t i = 0; i < stack.size; i++) {
 		string_map *l = &stack.data[stack.size - 1].list;
@@ -8,6 +8,7 @@
 #include "utils.h"
 #include "nodes.h"
 #include "jsons.h"
+#include "traces.h"
 
 
 /*
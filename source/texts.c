@@ -0,0 +1,551 @@
+#include "texts.h"
+
+#if cels_simd && (defined(__x86_64__) || defined(__i386__))
+#define texts_x86 1
+#include <immintrin.h>
+#else
+#define texts_x86 0
+#endif
+
+
+/* private */
+
+typedef struct text_kernels {
+	text_level level;
+	size_t (*ascii)(const char *data, size_t size);
+	size_t (*printable)(const char *data, size_t size);
+	size_t (*whitespace)(const char *data, size_t size);
+	size_t (*whitespace_back)(const char *data, size_t size);
+	void (*swap)(char *destination, const char *source, size_t size, char first);
+	bool (*equals)(const char *self, const char *other, size_t size);
+} text_kernels;
+
+static const text_kernels *texts_kernels = null;
+
+/*
+ * Checks if 'letter' is in ['first', 'first' + count)
+ * with a single (unsigned) comparison.
+ */
+static inline bool texts_in_range_private(char letter, char first, size_t count) {
+	return (unsigned char)(letter - first) < count;
+}
+
+static inline bool texts_is_whitespace_private(char letter) {
+	return letter == ' ' || letter == '\r' || letter == '\n' || letter == '\t';
+}
+
+static inline bool texts_is_printable_private(char letter) {
+	return
+		texts_in_range_private(letter, ' ', 95) ||
+		letter == '\t' || letter == '\n' || letter == '\f';
+}
+
+
+/* scalar kernels */
+
+size_t texts_ascii_scalar_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i < size; i++) {
+		if ((unsigned char)data[i] >= 0x80) { break; }
+	}
+
+	return i;
+}
+
+size_t texts_printable_scalar_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i < size; i++) {
+		if (!texts_is_printable_private(data[i])) { break; }
+	}
+
+	return i;
+}
+
+size_t texts_whitespace_scalar_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i < size; i++) {
+		if (!texts_is_whitespace_private(data[i])) { break; }
+	}
+
+	return i;
+}
+
+size_t texts_whitespace_back_scalar_private(const char *data, size_t size) {
+	size_t i = size;
+	for (; i > 0; i--) {
+		if (!texts_is_whitespace_private(data[i - 1])) { break; }
+	}
+
+	return i;
+}
+
+/*
+ * Copies 'source' flipping the case of letters
+ * in ['first', 'first' + 26), so 'A' lowers and
+ * 'a' uppers.
+ */
+void texts_swap_scalar_private(
+	char *destination, const char *source, size_t size, char first) {
+
+	for (size_t i = 0; i < size; i++) {
+		char letter = source[i];
+		destination[i] = texts_in_range_private(letter, first, 26) ?
+			letter ^ 0x20 : letter;
+	}
+}
+
+bool texts_equals_scalar_private(const char *self, const char *other, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		char a = self[i];
+		char b = other[i];
+
+		if (a == b) { continue; }
+		if ((a ^ b) != 0x20) { return false; }
+		if (!texts_in_range_private(a | 0x20, 'a', 26)) { return false; }
+	}
+
+	return true;
+}
+
+static const text_kernels texts_scalar_kernels = {
+	.level=text_scalar_level,
+	.ascii=texts_ascii_scalar_private,
+	.printable=texts_printable_scalar_private,
+	.whitespace=texts_whitespace_scalar_private,
+	.whitespace_back=texts_whitespace_back_scalar_private,
+	.swap=texts_swap_scalar_private,
+	.equals=texts_equals_scalar_private,
+};
+
+
+#if texts_x86
+
+/* sse2 kernels */
+
+/*
+ * Marks bytes in ['first', 'first' + count) by
+ * shifting the range down to -128 and doing
+ * a single signed comparison.
+ */
+__attribute__((target("sse2")))
+static inline __m128i texts_in_range_sse2_private(
+	__m128i block, char first, char count) {
+
+	__m128i shifted = _mm_add_epi8(block, _mm_set1_epi8((char)(0x80 - first)));
+	return _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + count)));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i texts_whitespace_sse2_block_private(__m128i block) {
+	__m128i spaces = _mm_or_si128(
+		_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+		_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+
+	__m128i breaks = _mm_or_si128(
+		_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')),
+		_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+
+	return _mm_or_si128(spaces, breaks);
+}
+
+__attribute__((target("sse2")))
+size_t texts_ascii_sse2_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+
+		unsigned mask = (unsigned)_mm_movemask_epi8(block);
+		if (mask) { return i + __builtin_ctz(mask); }
+	}
+
+	return i + texts_ascii_scalar_private(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+size_t texts_printable_sse2_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+
+		__m128i controls = _mm_or_si128(
+			_mm_or_si128(
+				_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')),
+				_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+			_mm_cmpeq_epi8(block, _mm_set1_epi8('\f')));
+
+		__m128i valid = _mm_or_si128(
+			texts_in_range_sse2_private(block, ' ', 95), controls);
+
+		unsigned mask = ~(unsigned)_mm_movemask_epi8(valid) & 0xffff;
+		if (mask) { return i + __builtin_ctz(mask); }
+	}
+
+	return i + texts_printable_scalar_private(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+size_t texts_whitespace_sse2_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+		__m128i spaces = texts_whitespace_sse2_block_private(block);
+
+		unsigned mask = ~(unsigned)_mm_movemask_epi8(spaces) & 0xffff;
+		if (mask) { return i + __builtin_ctz(mask); }
+	}
+
+	return i + texts_whitespace_scalar_private(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+size_t texts_whitespace_back_sse2_private(const char *data, size_t size) {
+	size_t i = size;
+	for (; i >= 16; i -= 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i - 16));
+		__m128i spaces = texts_whitespace_sse2_block_private(block);
+
+		unsigned mask = ~(unsigned)_mm_movemask_epi8(spaces) & 0xffff;
+		if (mask) { return i - 16 + (32 - __builtin_clz(mask)); }
+	}
+
+	return texts_whitespace_back_scalar_private(data, i);
+}
+
+__attribute__((target("sse2")))
+void texts_swap_sse2_private(
+	char *destination, const char *source, size_t size, char first) {
+
+	const __m128i flip = _mm_set1_epi8(0x20);
+
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(source + i));
+		__m128i letters = texts_in_range_sse2_private(block, first, 26);
+
+		block = _mm_xor_si128(block, _mm_and_si128(letters, flip));
+		_mm_storeu_si128((__m128i *)(destination + i), block);
+	}
+
+	texts_swap_scalar_private(destination + i, source + i, size - i, first);
+}
+
+__attribute__((target("sse2")))
+bool texts_equals_sse2_private(const char *self, const char *other, size_t size) {
+	const __m128i flip = _mm_set1_epi8(0x20);
+
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(self + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(other + i));
+
+		a = _mm_or_si128(a, _mm_and_si128(texts_in_range_sse2_private(a, 'A', 26), flip));
+		b = _mm_or_si128(b, _mm_and_si128(texts_in_range_sse2_private(b, 'A', 26), flip));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xffff) { return false; }
+	}
+
+	return texts_equals_scalar_private(self + i, other + i, size - i);
+}
+
+static const text_kernels texts_sse2_kernels = {
+	.level=text_sse2_level,
+	.ascii=texts_ascii_sse2_private,
+	.printable=texts_printable_sse2_private,
+	.whitespace=texts_whitespace_sse2_private,
+	.whitespace_back=texts_whitespace_back_sse2_private,
+	.swap=texts_swap_sse2_private,
+	.equals=texts_equals_sse2_private,
+};
+
+
+/* avx2 kernels */
+
+__attribute__((target("avx2")))
+static inline __m256i texts_in_range_avx2_private(
+	__m256i block, char first, char count) {
+
+	__m256i shifted = _mm256_add_epi8(block, _mm256_set1_epi8((char)(0x80 - first)));
+	return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + count)), shifted);
+}
+
+/*
+ * Tails are left to the sse2 kernels, the upper
+ * halves are cleared before, else mixing both
+ * encodings stalls (and gcc misses it on tail calls).
+ */
+__attribute__((target("avx2")))
+size_t texts_ascii_avx2_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+
+		unsigned mask = (unsigned)_mm256_movemask_epi8(block);
+		if (mask) { return i + __builtin_ctz(mask); }
+	}
+
+	_mm256_zeroupper();
+	return i + texts_ascii_sse2_private(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+size_t texts_printable_avx2_private(const char *data, size_t size) {
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+
+		__m256i controls = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')),
+				_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))),
+			_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\f')));
+
+		__m256i valid = _mm256_or_si256(
+			texts_in_range_avx2_private(block, ' ', 95), controls);
+
+		unsigned mask = ~(unsigned)_mm256_movemask_epi8(valid);
+		if (mask) { return i + __builtin_ctz(mask); }
+	}
+
+	_mm256_zeroupper();
+	return i + texts_printable_sse2_private(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+void texts_swap_avx2_private(
+	char *destination, const char *source, size_t size, char first) {
+
+	const __m256i flip = _mm256_set1_epi8(0x20);
+
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(source + i));
+		__m256i letters = texts_in_range_avx2_private(block, first, 26);
+
+		block = _mm256_xor_si256(block, _mm256_and_si256(letters, flip));
+		_mm256_storeu_si256((__m256i *)(destination + i), block);
+	}
+
+	_mm256_zeroupper();
+	texts_swap_sse2_private(destination + i, source + i, size - i, first);
+}
+
+__attribute__((target("avx2")))
+bool texts_equals_avx2_private(const char *self, const char *other, size_t size) {
+	const __m256i flip = _mm256_set1_epi8(0x20);
+
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(self + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(other + i));
+
+		a = _mm256_or_si256(a, _mm256_and_si256(texts_in_range_avx2_private(a, 'A', 26), flip));
+		b = _mm256_or_si256(b, _mm256_and_si256(texts_in_range_avx2_private(b, 'A', 26), flip));
+
+		if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != 0xffffffff) {
+			return false;
+		}
+	}
+
+	_mm256_zeroupper();
+	return texts_equals_sse2_private(self + i, other + i, size - i);
+}
+
+/*
+ * Whitespace is trimmed from short ends,
+ * where wider blocks don't pay off.
+ */
+static const text_kernels texts_avx2_kernels = {
+	.level=text_avx2_level,
+	.ascii=texts_ascii_avx2_private,
+	.printable=texts_printable_avx2_private,
+	.whitespace=texts_whitespace_sse2_private,
+	.whitespace_back=texts_whitespace_back_sse2_private,
+	.swap=texts_swap_avx2_private,
+	.equals=texts_equals_avx2_private,
+};
+
+#endif
+
+text_level texts_detect_private(void) {
+	#if texts_x86
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2")) { return text_avx2_level; }
+		if (__builtin_cpu_supports("sse2")) { return text_sse2_level; }
+	#endif
+
+	return text_scalar_level;
+}
+
+const text_kernels *texts_select_private(text_level level) {
+	#if texts_x86
+		switch (level) {
+			case text_avx2_level: return &texts_avx2_kernels;
+			case text_sse2_level: return &texts_sse2_kernels;
+			default: break;
+		}
+	#else
+		(void)level;
+	#endif
+
+	return &texts_scalar_kernels;
+}
+
+/*
+ * Gets the kernels in use, detecting
+ * them on first use - racing threads
+ * store the same table.
+ */
+static inline const text_kernels *texts_kernels_private(void) {
+	const text_kernels *kernels = __atomic_load_n(&texts_kernels, __ATOMIC_ACQUIRE);
+	if (kernels) { return kernels; }
+
+	kernels = texts_select_private(texts_detect_private());
+	__atomic_store_n(&texts_kernels, kernels, __ATOMIC_RELEASE);
+
+	return kernels;
+}
+
+/*
+ * Gets the size of the utf-8 sequence
+ * at the start of 'data', or 0 if it
+ * is malformed.
+ */
+size_t texts_sequence_private(const unsigned char *data, size_t size) {
+	unsigned char lead = data[0];
+
+	size_t length = 0;
+	unsigned char low = 0x80;
+	unsigned char high = 0xbf;
+
+	if (lead >= 0xc2 && lead <= 0xdf) {
+		length = 2;
+	} else if (lead >= 0xe0 && lead <= 0xef) {
+		length = 3;
+		if (lead == 0xe0) { low = 0xa0; }
+		if (lead == 0xed) { high = 0x9f; }
+	} else if (lead >= 0xf0 && lead <= 0xf4) {
+		length = 4;
+		if (lead == 0xf0) { low = 0x90; }
+		if (lead == 0xf4) { high = 0x8f; }
+	} else {
+		return 0;
+	}
+
+	if (length > size) { return 0; }
+	if (data[1] < low || data[1] > high) { return 0; }
+
+	for (size_t i = 2; i < length; i++) {
+		if ((data[i] & 0xc0) != 0x80) { return 0; }
+	}
+
+	return length;
+}
+
+
+/* texts */
+
+text_level texts_level(void) {
+	return texts_kernels_private()->level;
+}
+
+text_level texts_use(text_level level) {
+	text_level best = texts_detect_private();
+	if (level > best) { level = best; }
+
+	const text_kernels *kernels = texts_select_private(level);
+	__atomic_store_n(&texts_kernels, kernels, __ATOMIC_RELEASE);
+
+	return kernels->level;
+}
+
+bool texts_is_ascii(const char *data, size_t size) {
+	#if cels_debug
+		errors_abort("data", !data && size > 0);
+	#endif
+
+	return texts_kernels_private()->ascii(data, size) == size;
+}
+
+bool texts_is_utf8(const char *data, size_t size) {
+	#if cels_debug
+		errors_abort("data", !data && size > 0);
+	#endif
+
+	const text_kernels *kernels = texts_kernels_private();
+	const unsigned char *bytes = (const unsigned char *)data;
+
+	size_t i = 0;
+	while (i < size) {
+		if (bytes[i] < 0x80) {
+			i += kernels->ascii(data + i, size - i);
+			continue;
+		}
+
+		size_t length = texts_sequence_private(bytes + i, size - i);
+		if (length == 0) { return false; }
+
+		i += length;
+	}
+
+	return true;
+}
+
+bool texts_is_printable(const char *data, size_t size) {
+	#if cels_debug
+		errors_abort("data", !data && size > 0);
+	#endif
+
+	return texts_kernels_private()->printable(data, size) == size;
+}
+
+void texts_lower(char *data, size_t size) {
+	texts_lower_to(data, data, size);
+}
+
+void texts_upper(char *data, size_t size) {
+	texts_upper_to(data, data, size);
+}
+
+void texts_lower_to(char *destination, const char *source, size_t size) {
+	#if cels_debug
+		errors_abort("destination", !destination && size > 0);
+		errors_abort("source", !source && size > 0);
+	#endif
+
+	texts_kernels_private()->swap(destination, source, size, 'A');
+}
+
+void texts_upper_to(char *destination, const char *source, size_t size) {
+	#if cels_debug
+		errors_abort("destination", !destination && size > 0);
+		errors_abort("source", !source && size > 0);
+	#endif
+
+	texts_kernels_private()->swap(destination, source, size, 'a');
+}
+
+size_t texts_trim_start(const char *data, size_t size) {
+	#if cels_debug
+		errors_abort("data", !data && size > 0);
+	#endif
+
+	return texts_kernels_private()->whitespace(data, size);
+}
+
+size_t texts_trim_end(const char *data, size_t size) {
+	#if cels_debug
+		errors_abort("data", !data && size > 0);
+	#endif
+
+	return texts_kernels_private()->whitespace_back(data, size);
+}
+
+bool texts_equals_case(const char *self, const char *other, size_t size) {
+	#if cels_debug
+		errors_abort("self", !self && size > 0);
+		errors_abort("other", !other && size > 0);
+	#endif
+
+	return texts_kernels_private()->equals(self, other, size);
+}
@@ -0,0 +1,131 @@
+#ifndef cels_texts_h
+#define cels_texts_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "errors.h"
+
+
+/*
+ * The module 'texts' holds kernels over
+ * raw text - validation, case folding,
+ * trimming and comparison - vectorized
+ * with sse2 or avx2, picked at runtime
+ * by the cpu, else scalar.
+ *
+ * Case folding and comparison only
+ * regard ascii letters.
+ */
+
+
+/* texts */
+
+#ifndef cels_simd
+#define cels_simd 1
+#endif
+
+typedef enum text_level {
+	text_scalar_level,
+	text_sse2_level,
+	text_avx2_level,
+} text_level;
+
+/*
+ * Gets the level of the kernels in use,
+ * the best the cpu supports by default.
+ *
+ * #thread-safe
+ */
+text_level texts_level(void);
+
+/*
+ * Uses kernels of 'level', or the best
+ * supported below it, returning the level
+ * in use - meant for tests and benchmarks.
+ *
+ * #thread-safe
+ */
+text_level texts_use(text_level level);
+
+/*
+ * Checks if every byte is ascii.
+ *
+ * #thread-safe
+ */
+bool texts_is_ascii(const char *data, size_t size);
+
+/*
+ * Checks if 'data' is well-formed utf-8,
+ * without overlongs, surrogates or code
+ * points above U+10FFFF.
+ *
+ * #thread-safe
+ */
+bool texts_is_utf8(const char *data, size_t size);
+
+/*
+ * Checks if every byte is printable
+ * ascii, a tab, a line feed or a
+ * form feed.
+ *
+ * #thread-safe
+ */
+bool texts_is_printable(const char *data, size_t size);
+
+/*
+ * Converts ascii letters to lowercase.
+ *
+ * #thread-safe
+ */
+void texts_lower(char *data, size_t size);
+
+/*
+ * Converts ascii letters to uppercase.
+ *
+ * #thread-safe
+ */
+void texts_upper(char *data, size_t size);
+
+/*
+ * Copies 'source' to 'destination'
+ * converting letters to lowercase,
+ * they may be the same.
+ *
+ * #thread-safe
+ */
+void texts_lower_to(char *destination, const char *source, size_t size);
+
+/*
+ * Copies 'source' to 'destination'
+ * converting letters to uppercase,
+ * they may be the same.
+ *
+ * #thread-safe
+ */
+void texts_upper_to(char *destination, const char *source, size_t size);
+
+/*
+ * Gets the amount of leading whitespace
+ * (as in chars_is_whitespace).
+ *
+ * #thread-safe
+ */
+size_t texts_trim_start(const char *data, size_t size);
+
+/*
+ * Gets the size of 'data' without
+ * trailing whitespace.
+ *
+ * #thread-safe
+ */
+size_t texts_trim_end(const char *data, size_t size);
+
+/*
+ * Compares 'size' bytes ignoring
+ * the case of ascii letters.
+ *
+ * #thread-safe
+ */
+bool texts_equals_case(const char *self, const char *other, size_t size);
+
+#endif
@@ -0,0 +1,180 @@
+#include "traces.h"
+
+
+/* private */
+
+static trace_buffer *traces_registry = null;
+static bool traces_lock = false;
+static size_t traces_ids = 0;
+
+static pthread_key_t traces_key;
+static pthread_once_t traces_once = PTHREAD_ONCE_INIT;
+
+static __thread trace_buffer *traces_buffer = null;
+
+void traces_lock_private(void) {
+	while (__atomic_test_and_set(&traces_lock, __ATOMIC_ACQUIRE)) {}
+}
+
+void traces_unlock_private(void) {
+	__atomic_clear(&traces_lock, __ATOMIC_RELEASE);
+}
+
+size_t traces_now_private(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (size_t)now.tv_sec * 1000000000 + (size_t)now.tv_nsec;
+}
+
+/*
+ * Called when a traced thread exits,
+ * its buffer is kept for the dump but
+ * may be reused by another thread.
+ */
+void traces_release_private(void *buffer) {
+	trace_buffer *self = buffer;
+	__atomic_store_n(&self->is_used, false, __ATOMIC_RELEASE);
+}
+
+void traces_key_private(void) {
+	pthread_key_create(&traces_key, traces_release_private);
+}
+
+/*
+ * Gets a buffer for the calling thread,
+ * reusing one of an exited thread if
+ * there is any.
+ */
+trace_buffer *traces_acquire_private(void) {
+	pthread_once(&traces_once, traces_key_private);
+
+	traces_lock_private();
+
+	trace_buffer *self = traces_registry;
+	while (self && __atomic_load_n(&self->is_used, __ATOMIC_ACQUIRE)) {
+		self = self->next;
+	}
+
+	if (!self) {
+		self = mems_alloc(null, sizeof(trace_buffer));
+		if (!self) {
+			traces_unlock_private();
+			return null;
+		}
+
+		self->id = ++traces_ids;
+		self->head = 0;
+		self->next = traces_registry;
+		__atomic_store_n(&traces_registry, self, __ATOMIC_RELEASE);
+	}
+
+	self->is_used = true;
+	traces_unlock_private();
+
+	pthread_setspecific(traces_key, self);
+	return self;
+}
+
+
+/* traces */
+
+void traces_push_private(const char *name, char phase) {
+	trace_buffer *self = traces_buffer;
+	if (!self) {
+		self = traces_buffer = traces_acquire_private();
+		if (!self) { return; }
+	}
+
+	size_t head = self->head;
+	self->events[head % trace_capacity] = (trace_event) {
+		.name=name,
+		.time=traces_now_private(),
+		.phase=phase
+	};
+
+	__atomic_store_n(&self->head, head + 1, __ATOMIC_RELEASE);
+}
+
+const char *traces_open_private(const char *name) {
+	traces_push_private(name, 'B');
+	return name;
+}
+
+void traces_close_private(const char **name) {
+	traces_push_private(*name, 'E');
+}
+
+error traces_dump(const char *path) {
+	#if cels_debug
+		errors_abort("path", !path);
+	#endif
+
+	file *output = fopen(path, "w");
+	if (!output) {
+		return trace_file_error;
+	}
+
+	fprintf(output, "{\"traceEvents\": [");
+
+	int pid = getpid();
+	bool is_first = true;
+
+	trace_buffer *self = __atomic_load_n(&traces_registry, __ATOMIC_ACQUIRE);
+	for (; self; self = self->next) {
+		size_t head = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+		size_t start = head > trace_capacity ? head - trace_capacity : 0;
+
+		/* ends whose begin got overwritten are skipped */
+		size_t depth = 0;
+
+		for (size_t i = start; i < head; i++) {
+			trace_event event = self->events[i % trace_capacity];
+
+			if (event.phase == 'E') {
+				if (depth == 0) { continue; }
+				--depth;
+			} else {
+				++depth;
+			}
+
+			fprintf(
+				output,
+				"%s\n\t{\"name\": \"%s\", \"ph\": \"%c\", "
+				"\"ts\": %zu.%03zu, \"pid\": %d, \"tid\": %zu}",
+				is_first ? "" : ",",
+				event.name,
+				event.phase,
+				event.time / 1000,
+				event.time % 1000,
+				pid,
+				self->id);
+
+			is_first = false;
+		}
+	}
+
+	fprintf(output, "\n], \"displayTimeUnit\": \"ns\"}\n");
+
+	int close_status = fclose(output);
+	return close_status == 0 ? trace_successfull : trace_file_error;
+}
+
+void traces_free(void) {
+	traces_lock_private();
+
+	trace_buffer *self = traces_registry;
+	while (self) {
+		trace_buffer *next = self->next;
+		mems_dealloc(null, self, sizeof(trace_buffer));
+		self = next;
+	}
+
+	__atomic_store_n(&traces_registry, null, __ATOMIC_RELEASE);
+	traces_unlock_private();
+
+	if (traces_buffer) {
+		pthread_setspecific(traces_key, null);
+		traces_buffer = null;
+	}
+}
@@ -0,0 +1,145 @@
+#ifndef cels_traces_h
+#define cels_traces_h
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "errors.h"
+#include "mems.h"
+#include "files.h"
+
+
+/*
+ * The module 'traces' records named spans
+ * into per-thread ring buffers and dumps
+ * them as chrome's trace_event json, to be
+ * opened with chrome://tracing or perfetto.
+ *
+ * Unless cels_traces is true, spans are
+ * compiled out entirely.
+ */
+
+
+/* traces */
+
+#ifndef cels_traces
+#define cels_traces 0
+#endif
+
+/* events kept per thread, the oldest are overwritten */
+#ifndef trace_capacity
+#define trace_capacity 16384
+#endif
+
+typedef enum trace_error {
+	trace_successfull,
+	trace_file_error,
+} trace_error;
+
+typedef struct trace_event {
+	/* must outlive the dump, usually a literal */
+	const char *name;
+	/* nanoseconds of a monotonic clock */
+	size_t time;
+	/* 'B' for begin and 'E' for end */
+	char phase;
+} trace_event;
+
+typedef struct trace_buffer trace_buffer;
+
+struct trace_buffer {
+	size_t id;
+	/* events written, wraps around capacity */
+	size_t head;
+	/* false when its thread exited, so it may be reused */
+	bool is_used;
+	trace_buffer *next;
+	trace_event events[trace_capacity];
+};
+
+#if cels_traces
+
+/*
+ * Begins span named 'name' on the
+ * calling thread - 'name' must be a
+ * literal or outlive traces_dump.
+ *
+ * #thread-safe
+ */
+#define traces_begin(name) traces_push_private(name, 'B')
+
+/*
+ * Ends span named 'name' on the
+ * calling thread.
+ *
+ * #thread-safe
+ */
+#define traces_end(name) traces_push_private(name, 'E')
+
+/*
+ * Begins span named 'name' that ends
+ * when the enclosing scope is left,
+ * be it by a return or a goto.
+ *
+ * #thread-safe
+ */
+#define traces_scope(name) \
+	__attribute__((cleanup(traces_close_private))) \
+	const char *traces_scope_helper(__LINE__) = traces_open_private(name)
+
+#define traces_scope_helper(line) traces_scope_concat(traces_span_, line)
+#define traces_scope_concat(a, b) a##b
+
+#else
+
+#define traces_begin(name) ((void)0)
+#define traces_end(name) ((void)0)
+#define traces_scope(name) ((void)0)
+
+#endif
+
+/*
+ * Use traces_begin or traces_end instead.
+ *
+ * #private #shouldnt-be-used
+ */
+void traces_push_private(const char *name, char phase);
+
+/*
+ * Use traces_scope instead.
+ *
+ * #private #shouldnt-be-used
+ */
+const char *traces_open_private(const char *name);
+
+/*
+ * Use traces_scope instead.
+ *
+ * #private #shouldnt-be-used
+ */
+void traces_close_private(const char **name);
+
+/*
+ * Writes the spans of every thread to
+ * 'path' as chrome's trace_event json.
+ *
+ * Spans being recorded meanwhile may
+ * be torn, so it is best done after
+ * the traced threads are quiet.
+ *
+ * #thread-safe #to-review
+ */
+cels_warn_unused
+error traces_dump(const char *path);
+
+/*
+ * Frees every buffer, no thread
+ * may be tracing meanwhile.
+ *
+ * #to-review
+ */
+void traces_free(void);
+
+#endif
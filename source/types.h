@@ -36,6 +36,7 @@
 typedef void *(*callfunc) (void *);
 typedef void *(*selffunc)(void *, void *);
 typedef bool (*compfunc)(void *, void *);
+typedef int (*orderfunc)(const void *, const void *);
 typedef void (*shoutfunc) (void *, void *);
 typedef size_t (*hashfunc)(void *);
 typedef void (*cleanfunc)(void *);
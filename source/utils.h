@@ -34,7 +34,9 @@ typedef clock_t (*measurefunc) (size_t);
  * the terminal.
  *
  * Don't use it, prefer 
- * utils_measure intead.
+ * utils_measure intead - or, for 
+ * reliable numbers, the 'benchmarks' 
+ * module in 'benchmark/'.
  *
  * #to-review
  */
@@ -69,46 +69,108 @@ error vectors_init(
 	return ok; 
 } 
 
-error vectors_upscale(void *self, const allocator *mem) { 
-	vector *s = self;
+/*
+ * Gets the capacity vector grows to, 
+ * as its 'growth' says, to hold 'size'.
+ */
+size_t vectors_grown_private(const vector *self, size_t size) {
+	size_t capacity = self->capacity > vector_min ? self->capacity : vector_min;
+
+	switch (self->growth) {
+	case vector_exact_growth:
+		return size > self->capacity ? size : self->capacity + 1;
+	case vector_half_growth:
+		while (capacity < size || capacity <= self->capacity) {
+			capacity += (capacity >> 1);
+		}
+		return capacity;
+	case vector_double_growth:
+	default:
+		while (capacity < size || capacity <= self->capacity) {
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+}
 
-	#if cels_debug
-		errors_abort("self", vectors_check(s)); 
-	#endif
-	
-	size_t new_capacity = s->capacity << 1; 
-	
-	#if cels_debug
-		errors_abort( 
-			"new_capacity (overflow)", 
-			new_capacity < s->capacity); 
+/*
+ * Moves data to a block of 'capacity',
+ * spilling it from within vector if inline.
+ */
+error vectors_resize_private(
+	vector *self, size_t capacity, const allocator *mem) {
 
+	#if cels_debug
 		errors_abort( 
-			"new_capacity (overflow)", 
-			s->capacity * s->type_size > new_capacity * s->type_size); 
+			"capacity (overflow)", 
+			capacity < self->capacity ||
+			capacity * self->type_size < self->capacity * self->type_size); 
 	#endif 
-	
-	void *new_data = mems_realloc( 
-		mem, 
-		s->data, 
-		s->capacity * s->type_size, 
-		new_capacity * s->type_size); 
-	
+
+	void *new_data = null;
+	if (self->is_inline) {
+		new_data = mems_alloc(mem, capacity * self->type_size);
+		if (new_data) {
+			memcpy(new_data, self->data, self->size * self->type_size);
+		}
+	} else {
+		new_data = mems_realloc( 
+			mem, 
+			self->data, 
+			self->capacity * self->type_size, 
+			capacity * self->type_size); 
+	}
+
 	#if cels_debug
 		errors_inform("new_data", !new_data); 
 	#endif
 	
-	if (!new_data) { 
+	if (!new_data) { return fail; }
+
+	self->capacity = capacity;
+	self->data = new_data;
+	self->is_inline = false;
+
+	return ok;
+}
+
+/*
+ * Deallocates data, unless inline.
+ */
+error vectors_dealloc_private(vector *self, const allocator *mem) {
+	if (self->is_inline || !self->data) { return ok; }
+	return mems_dealloc(mem, self->data, self->capacity * self->type_size);
+}
+
+error vectors_upscale(void *self, const allocator *mem) { 
+	vector *s = self;
+
+	#if cels_debug
+		errors_abort("self", vectors_check(s)); 
+	#endif
+	
+	size_t new_capacity = vectors_grown_private(s, s->size + 1); 
+	
+	error resize_error = vectors_resize_private(s, new_capacity, mem);
+	if (resize_error) { 
 		s->size--; 
 		return fail; 
 	} 
 	
-	s->capacity = new_capacity; 
-	s->data = new_data; 
-	
 	return ok; 
 } 
 
+error vectors_reserve(void *self, size_t capacity, const allocator *mem) {
+	vector *s = self;
+
+	#if cels_debug
+		errors_abort("self", vectors_check(s)); 
+	#endif
+
+	if (capacity <= s->capacity) { return ok; }
+	return vectors_resize_private(s, capacity, mem);
+}
+
 error vectors_downscale(void *self, const allocator *mem) { 
 	vector *s = self;
 
@@ -116,6 +178,8 @@ error vectors_downscale(void *self, const allocator *mem) {
 		errors_abort("self", vectors_check(s)); 
 	#endif
 	
+	if (s->is_inline) { return ok; }
+
 	if (s->size < s->capacity >> 1) { 
 		size_t new_capacity = s->capacity >> 1; 
 		void *new_data = mems_realloc( 
@@ -192,6 +256,34 @@ error vectors_push(void *self, void *item, const allocator *mem) {
 	return upscale_error; 
 } 
 
+error vectors_extend(
+	void *self, const void *items, size_t size, const allocator *mem) {
+
+	vector *s = self;
+
+	#if cels_debug
+		errors_abort("self", vectors_check(s)); 
+		errors_abort("items", !items && size); 
+	#endif
+
+	if (size == 0) { return ok; }
+
+	/* as push, a slot is kept spare */
+	size_t needed = s->size + size + 1;
+	if (needed > s->capacity) {
+		size_t new_capacity = vectors_grown_private(s, needed);
+
+		error resize_error = vectors_resize_private(s, new_capacity, mem);
+		if (resize_error) { return fail; }
+	}
+
+	void *location = (char *)s->data + (s->size * s->type_size);
+	memcpy(location, items, size * s->type_size);
+	s->size += size;
+
+	return ok;
+}
+
 void vectors_free(void *self, freefunc cleaner, const allocator *mem) { 
 	vector *s = self;
 
@@ -199,15 +291,15 @@ void vectors_free(void *self, freefunc cleaner, const allocator *mem) {
 		errors_abort("self", vectors_check(s)); 
 	#endif
 	
-	if (!s->data) { 
+	if (s->data) { 
 		if (cleaner) {
 			for (size_t i = 0; i < s->size; i++) { 
-				void *item = (char *)s->data + ((s->size + i) * s->type_size);
+				void *item = (char *)s->data + (i * s->type_size);
 				cleaner(item, mem); 
 			} 
 		}
 
-		mems_dealloc(mem, s->data, s->capacity * s->type_size); 
+		vectors_dealloc_private(s, mem); 
 	} 
 } 
 
@@ -320,7 +412,7 @@ error vectors_filter(
 					cleaner(item, mem);
 				}
 
-				error dealloc_error = mems_dealloc(mem, s->data, s->capacity); 
+				error dealloc_error = vectors_dealloc_private(s, mem); 
 				if (dealloc_error) { return fail; } 
 
 				return fail; 
@@ -332,9 +424,10 @@ error vectors_filter(
 		} 
 	} 
 
-	error dealloc_error = mems_dealloc(mem, s->data, s->capacity); 
+	error dealloc_error = vectors_dealloc_private(s, mem); 
 	if (dealloc_error) { return fail; } 
 	
+	other.growth = s->growth;
 	*s = other; 
 	return ok; 
 } 
@@ -369,9 +462,10 @@ error vectors_filter_unique(void *self, compfunc comparer, freefunc cleaner, con
 		}
 	}
 	
-	error dealloc_error = mems_dealloc(mem, s->data, s->capacity * s->type_size);
+	error dealloc_error = vectors_dealloc_private(s, mem);
 	if (dealloc_error) { return fail; }
 	
+	other.growth = s->growth;
 	*s = other;
 	
 	#if cels_debug
@@ -445,13 +539,10 @@ error vectors_unite(
 		errors_abort("other", vectors_check(o));
 	#endif
 	
-	for (size_t i = 0; i < o->size; i++) {
-		void *item = (char *)o->data + (i * o->type_size);
-		error push_error = vectors_push(self, item, mem);
-		if (push_error) { return fail; }
-	}
+	error extend_error = vectors_extend(s, o->data, o->size, mem);
+	if (extend_error) { return fail; }
 	
-	error dealloc_error = mems_dealloc(mem, o->data, o->capacity);
+	error dealloc_error = vectors_dealloc_private(o, mem);
 	if (dealloc_error) { return fail; }
 	
 	o->size = 0;
@@ -19,17 +19,62 @@
 
 #define vector_min 4
 
+typedef enum vector_growth {
+	/* doubles capacity, the default */
+	vector_double_growth,
+	/* grows capacity by half, wasting less */
+	vector_half_growth,
+	/* grows to the capacity needed */
+	vector_exact_growth,
+} vector_growth;
+
 #define vectors(type0) \
 	struct { \
 		size_t size; \
 		size_t capacity; \
 		type0 *data; \
 		size_t type_size; \
+		vector_growth growth; \
+		/* data lives within self, see small_vectors */ \
+		bool is_inline; \
 	}
 
 typedef vectors(void) vector;
 typedef vectors(size_t) size_vec;
 
+/*
+ * A vector holding up to 'n' items within 
+ * itself, allocating only once it outgrows 
+ * them - so it mustn't be copied while inline.
+ *
+ * Every vectors function takes it.
+ */
+#define small_vectors(type0, n) \
+	struct { \
+		size_t size; \
+		size_t capacity; \
+		type0 *data; \
+		size_t type_size; \
+		vector_growth growth; \
+		bool is_inline; \
+		type0 inline_data[(n) + 1]; \
+	}
+
+/*
+ * Initializes a small-vector, 
+ * with its inline capacity.
+ *
+ * #to-review
+ */
+#define small_vectors_init(self) { \
+	self.size = 0; \
+	self.capacity = sizeof(self.inline_data) / sizeof(self.inline_data[0]); \
+	self.data = self.inline_data; \
+	self.type_size = sizeof(self.inline_data[0]); \
+	self.growth = vector_double_growth; \
+	self.is_inline = true; \
+}
+
 /*
  * Creates an automatic vector (aka a normal list with size) 
  * with items supplied.
@@ -81,7 +126,7 @@ error vectors_init(
 	void *self, size_t type_size, size_t capacity, const allocator *mem);
 
 /*
- * Upscales a vector.
+ * Upscales a vector as its 'growth' says.
  *
  * A vector-like 'self' must be provided, 
  * as well as it's underlying type as 'type-size'.
@@ -90,6 +135,16 @@ error vectors_init(
  */
 error vectors_upscale(void *self, const allocator *mem);
 
+/*
+ * Grows vector once, so it holds at
+ * least 'capacity' items.
+ *
+ * A vector-like 'self' must be provided.
+ *
+ * #to-review
+ */
+error vectors_reserve(void *self, size_t capacity, const allocator *mem);
+
 /*
  * Downscale a vector.
  *
@@ -126,6 +181,17 @@ error vectors_pop(void *self, freefunc cleaner, const allocator *mem);
  */
 error vectors_push(void *self, void *item, const allocator *mem);
 
+/*
+ * Pushes 'size' items from array 'items',
+ * growing vector at most once.
+ *
+ * A vector-like 'self' must be provided.
+ *
+ * #to-review
+ */
+error vectors_extend(
+	void *self, const void *items, size_t size, const allocator *mem);
+
 /*
  * Frees a vector.
  *
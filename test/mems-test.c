@@ -16,6 +16,202 @@ void arenas_test_init(error_report *report) {
 	mem.free(mem.storage);
 }
 
+void arenas_test_mark_and_rewind(error_report *report) {
+	allocator mem = arenas_init(256);
+
+	char *before = mems_alloc(&mem, 100);
+	memset(before, 'a', 100);
+
+	arena_mark mark = arenas_mark(&mem);
+	char *first = mems_alloc(&mem, 100);
+
+	for (size_t i = 0; i < 20; i++) {
+		char *item = mems_alloc(&mem, 200);
+		memset(item, 'b', 200);
+	}
+
+	arenas_rewind(&mem, mark, false);
+	char *again = mems_alloc(&mem, 100);
+	errors_expect("rewind() reuses the position marked", again == first, report);
+
+	for (size_t i = 0; i < 20; i++) {
+		char *item = mems_alloc(&mem, 200);
+		memset(item, 'c', 200);
+	}
+
+	arenas_rewind(&mem, mark, true);
+	again = mems_alloc(&mem, 100);
+	errors_expect("rewind(releasing) reuses the position", again == first, report);
+
+	bool is_kept = true;
+	for (size_t i = 0; i < 100; i++) {
+		is_kept = is_kept && before[i] == 'a';
+	}
+
+	errors_expect("data before the mark is kept", is_kept, report);
+
+	mems_free(&mem, null);
+}
+
+void arenas_test_deallocate(error_report *report) {
+	allocator mem = arenas_init(256);
+
+	char *first = mems_alloc(&mem, 200);
+	char *second = mems_alloc(&mem, 200);
+	memset(first, 'a', 200);
+
+	error dealloc_error = mems_dealloc(&mem, second, 200);
+	errors_expect("dealloc() finds blocks past the first", !dealloc_error, report);
+
+	char *again = mems_alloc(&mem, 200);
+	errors_expect("dealloc() of the last frees its room", again == second, report);
+
+	mems_free(&mem, null);
+}
+
+void arena_scratches_test_scope(error_report *report) {
+	char *outer = null;
+	char *inner = null;
+
+	{
+		arena_scratches_scope(scratch, null);
+		outer = mems_alloc(scratch.mem, 64);
+
+		{
+			arena_scratches_scope(nested, null);
+			inner = mems_alloc(nested.mem, 64);
+		}
+
+		char *reused = mems_alloc(scratch.mem, 64);
+		errors_expect("nested scratch is dropped", reused == inner, report);
+	}
+
+	arena_scratch scratch = arena_scratches_init(null);
+	char *again = mems_alloc(scratch.mem, 64);
+	errors_expect("scratch is dropped at scope exit", again == outer, report);
+
+	arena_scratches_free(&scratch);
+	arena_scratches_release();
+}
+
+void virtual_arenas_test_grow_in_place(error_report *report) {
+	allocator mem = virtual_arenas_init(16 * 1024 * 1024, (virtual_arena_option){0});
+	errors_expect("virtual_arenas_init() reserves", mem.storage != null, report);
+
+	char *first = mems_alloc(&mem, 100);
+	char *second = mems_alloc(&mem, 100);
+	errors_expect("allocations are contiguous", second - first == 112, report);
+
+	char *grown = mems_realloc(&mem, second, 100, 1024 * 1024);
+	memset(grown, 'a', 1024 * 1024);
+	errors_expect("realloc() of the last grows in place", grown == second, report);
+
+	arena_mark mark = arenas_mark(&mem);
+	char *marked = mems_alloc(&mem, 4096);
+	memset(marked, 'b', 4096);
+
+	arenas_rewind(&mem, mark, true);
+	char *again = mems_alloc(&mem, 4096);
+	errors_expect("rewind() reuses the position marked", again == marked, report);
+	errors_expect("rewind() releases pages", again[4095] == 0, report);
+
+	virtual_arenas_reset(&mem);
+	char *reset = mems_alloc(&mem, 100);
+	errors_expect("reset() starts over", reset == first, report);
+
+	mem.free(mem.storage);
+}
+
+void stack_arenas_test_spill(error_report *report) {
+	char *marker = null;
+
+	{
+		stack_arenas_scope(mem, 256);
+
+		char *start = mem.storage;
+		char *end = start + stack_arena_header_size + 256;
+
+		char *small = mems_alloc(&mem, 200);
+		memset(small, 'a', 200);
+
+		bool is_small_within = small > start && small < end;
+		errors_expect("small allocations stay on the stack", is_small_within, report);
+
+		char *large = mems_alloc(&mem, 4096);
+		memset(large, 'b', 4096);
+
+		bool is_large_within = large > start && large < end;
+		errors_expect("large allocations spill to the heap", !is_large_within, report);
+
+		char *grown = mems_realloc(&mem, small, 200, 1024);
+		errors_expect("realloc() out of the stack keeps data", grown[199] == 'a', report);
+
+		marker = mems_alloc(&mem, 16);
+		errors_expect("freed room is reused", marker == small, report);
+	}
+
+	errors_expect("the scope was left", marker != null, report);
+}
+
+void tlsfs_test_coalesce(error_report *report) {
+	allocator mem = tlsfs_init(4096);
+
+	char *blocks[8] = {0};
+	for (size_t i = 0; i < 8; i++) {
+		blocks[i] = mems_alloc(&mem, 100);
+		memset(blocks[i], 'a' + i, 100);
+	}
+
+	bool is_aligned = ((size_t)blocks[1] & 15) == 0;
+	errors_expect("blocks are aligned", is_aligned, report);
+
+	for (size_t i = 0; i < 8; i += 2) {
+		mems_dealloc(&mem, blocks[i], 100);
+	}
+
+	errors_expect("frees out of order keep data", blocks[5][99] == 'f', report);
+
+	for (size_t i = 1; i < 8; i += 2) {
+		mems_dealloc(&mem, blocks[i], 100);
+	}
+
+	char *merged = mems_alloc(&mem, 800);
+	errors_expect("freed neighbours are merged", merged == blocks[0], report);
+
+	char *grown = mems_realloc(&mem, merged, 800, 2000);
+	errors_expect("realloc() grows over free neighbours", grown == merged, report);
+
+	mems_free(&mem, null);
+}
+
+void trackers_test_counters(error_report *report) {
+	allocator arena = arenas_init(2048);
+
+	tracker track = {0};
+	allocator mem = trackers_init(&track, "test", (tracker_option){0}, &arena);
+
+	char *a = mems_alloc(&mem, 100);
+	char *b = mems_alloc(&mem, 20);
+	b = mems_realloc(&mem, b, 20, 40);
+	mems_dealloc(&mem, a, 100);
+
+	errors_expect("track.allocs == 2", track.allocs == 2, report);
+	errors_expect("track.reallocs == 1", track.reallocs == 1, report);
+	errors_expect("track.deallocs == 1", track.deallocs == 1, report);
+	errors_expect("track.in_use == 40", track.in_use == 40, report);
+	errors_expect("track.peak == 140", track.peak == 140, report);
+	errors_expect("track.histogram[6] == 1", track.histogram[6] == 1, report);
+
+	trackers_enable(false);
+	mems_dealloc(&mem, b, 40);
+	trackers_enable(true);
+
+	errors_expect("disabled track.deallocs == 1", track.deallocs == 1, report);
+
+	trackers_free(&track);
+	mems_free(&mem, null);
+}
+
 void mems_test(void) {
 	printf("=======\n");
 	printf("mems\n");
@@ -23,6 +219,13 @@ void mems_test(void) {
 
 	reportfunc functions[] = {
 		arenas_test_init,
+		arenas_test_mark_and_rewind,
+		arenas_test_deallocate,
+		arena_scratches_test_scope,
+		virtual_arenas_test_grow_in_place,
+		stack_arenas_test_spill,
+		tlsfs_test_coalesce,
+		trackers_test_counters,
 		null,
 	};
 
@@ -0,0 +1,499 @@
+#include "../source/nodes.h"
+#include "../source/errors.h"
+
+int _size_order(const size_t *i0, const size_t *i1) { 
+	return (*i0 > *i1) - (*i0 < *i1); 
+}
+
+maps(_size_map, size_t, size_t)
+
+void nodes_test_maps_remove(error_report *report) {
+	_size_map map = {0};
+	maps_init(map);
+
+	for (size_t i = 1; i <= 100; i++) {
+		_size_map_pair pair = {.key=i, .value=i * 2};
+		maps_push(&map, &pair, i, null);
+	}
+
+	bool is_valid = true;
+	for (size_t i = 1; i <= 100; i += 2) {
+		is_valid = is_valid && !maps_remove(&map, i, null, null, null);
+	}
+
+	errors_expect("remove(odds) == ok", is_valid && map.size == 50, report);
+	errors_expect("get(3) == null", !maps_get(&map, 3), report);
+	errors_expect("remove(3) == fail", maps_remove(&map, 3, null, null, null), report);
+
+	size_t previous = 0;
+	size_t count = 0;
+	_size_map_iterator it = {0};
+	while (maps_next(&map, &it)) {
+		is_valid = is_valid && it.data->hash > previous && it.data->hash % 2 == 0;
+		previous = it.data->hash;
+		count++;
+	}
+
+	errors_expect("next() yields the 50 evens in order", is_valid && count == 50, report);
+
+	_size_map_node *freed = map.freed;
+	_size_map_pair pair = {.key=3, .value=6};
+	maps_push(&map, &pair, 3, null);
+
+	size_t *value = maps_get(&map, 3);
+	errors_expect("push(3) reuses a removed node", map.freed != freed, report);
+	errors_expect("get(3) == 6", value && *value == 6, report);
+
+	maps_free(&map, null, null, null);
+}
+
+typedef struct _size_munode _size_munode;
+typedef munodes(_size_munode, size_t) _size_munode;
+typedef mutrees(_size_munode) _size_mutree;
+
+typedef struct _size_mucell _size_mucell;
+typedef mucells(_size_mucell, size_t) _size_mucell;
+typedef mutree_compacts(_size_mucell) _size_mutree_compact;
+typedef mutree_compact_iterators(_size_mucell) _size_mutree_compact_iterator;
+
+void nodes_test_mutrees_compact(error_report *report) {
+	_size_munode nodes[8] = {0};
+	for (size_t i = 0; i < 8; i++) {
+		nodes[i].data = i;
+	}
+
+	_size_mutree tree = {0};
+	mutrees_init(tree);
+
+	/* 0 (1 (3 4) 2 (5)) 6 (7) */
+	error push_error = mutrees_push(&tree, null, &nodes[0]);
+	push_error |= mutrees_attach(&tree, &nodes[0], &nodes[1]);
+	push_error |= mutrees_push(&tree, &nodes[1], &nodes[2]);
+	push_error |= mutrees_attach(&tree, &nodes[1], &nodes[3]);
+	push_error |= mutrees_push(&tree, &nodes[3], &nodes[4]);
+	push_error |= mutrees_attach(&tree, &nodes[2], &nodes[5]);
+	push_error |= mutrees_push(&tree, &nodes[0], &nodes[6]);
+	push_error |= mutrees_attach(&tree, &nodes[6], &nodes[7]);
+
+	_size_mutree_compact compact = {0};
+	mutree_compacts_init(compact);
+
+	error compact_error = push_error || mutrees_compact(&tree, &compact, null);
+	errors_expect("compact() == ok", !compact_error && compact.size == 8, report);
+	if (compact_error) { return; }
+
+	size_t depth_wise[] = {0, 1, 3, 4, 2, 5, 6, 7};
+	size_t breadth_wise[] = {0, 6, 1, 2, 7, 3, 4, 5};
+
+	bool is_valid = true;
+	size_t count = 0;
+	_size_mutree_compact_iterator it = {0};
+	while (mutree_compacts_next(&compact, &it)) {
+		is_valid = is_valid && count < 8 && it.data->data == depth_wise[count];
+		count++;
+	}
+
+	errors_expect("next() is pre-order", is_valid && count == 8, report);
+
+	count = 0;
+	it = (_size_mutree_compact_iterator){0};
+	while (mutree_compacts_next_breadth_wise(&compact, &it)) {
+		is_valid = is_valid && count < 8 && it.data->data == breadth_wise[count];
+		count++;
+	}
+
+	errors_expect("next_breadth_wise() is level-order", is_valid && count == 8, report);
+
+	_size_mucell *cell = &compact.data[5];
+	is_valid = 
+		cell->data == 5 && 
+		compact.data[cell->parent].data == 2 &&
+		compact.data[compact.data[cell->parent].parent].data == 0 &&
+		compact.data[0].left == 6 &&
+		compact.data[6].parent == mutree_compact_none;
+
+	errors_expect("links point to parents and siblings", is_valid, report);
+
+	mutree_compacts_free(&compact, null);
+}
+
+typedef struct _char_munode _char_munode;
+typedef munodes(_char_munode, char) _char_munode;
+typedef mutrees(_char_munode) _char_mutree;
+
+typedef struct _char_mucell _char_mucell;
+typedef mucells(_char_mucell, char) _char_mucell;
+typedef mutree_compacts(_char_mucell) _char_mutree_compact;
+typedef mutree_compact_iterators(_char_mucell) _char_mutree_compact_iterator;
+
+void nodes_test_mutrees_compact_small(error_report *report) {
+	_char_munode nodes[4] = {{.data='a'}, {.data='b'}, {.data='c'}, {.data='d'}};
+
+	_char_mutree tree = {0};
+	mutrees_init(tree);
+
+	/* a (b c) d */
+	error push_error = mutrees_push(&tree, null, &nodes[0]);
+	push_error |= mutrees_attach(&tree, &nodes[0], &nodes[1]);
+	push_error |= mutrees_push(&tree, &nodes[1], &nodes[2]);
+	push_error |= mutrees_push(&tree, &nodes[0], &nodes[3]);
+
+	_char_mutree_compact compact = {0};
+	mutree_compacts_init(compact);
+
+	error compact_error = push_error || mutrees_compact(&tree, &compact, null);
+	errors_expect("compact(char) == ok", !compact_error && compact.size == 4, report);
+	if (compact_error) { return; }
+
+	bool is_valid = 
+		compact.data[0].data == 'a' && 
+		compact.data[1].data == 'b' && 
+		compact.data[2].data == 'c' && 
+		compact.data[3].data == 'd';
+
+	errors_expect("compact(char) keeps values", is_valid, report);
+
+	is_valid = 
+		compact.data[0].down == 1 && 
+		compact.data[0].left == 3 && 
+		compact.data[1].left == 2 && 
+		compact.data[2].parent == 0 && 
+		compact.data[3].parent == mutree_compact_none;
+
+	errors_expect("compact(char) keeps links", is_valid, report);
+
+	char order[4] = {0};
+	size_t order_size = 0;
+
+	_char_mutree_compact_iterator it = {0};
+	while (mutree_compacts_next_breadth_wise(&compact, &it) && order_size < 4) {
+		order[order_size++] = it.data->data;
+	}
+
+	is_valid = order_size == 4 && memcmp(order, "adbc", 4) == 0;
+	errors_expect("compact(char) walks breadth-wise", is_valid, report);
+
+	mutree_compacts_free(&compact, null);
+}
+
+void nodes_test_bptrees_push_and_remove(error_report *report) {
+	bptree tree = bptrees_init(sizeof(size_t), sizeof(size_t), (orderfunc)_size_order);
+
+	bool is_valid = true;
+	for (size_t i = 0; i < 1000; i++) {
+		size_t key = (i * 7919) % 1000;
+		size_t value = key * 2;
+
+		is_valid = is_valid && !bptrees_push(&tree, &key, &value, null);
+	}
+
+	is_valid = is_valid && !bptrees_check(&tree) && tree.size == 1000;
+	errors_expect("push(0..1000 shuffled) is valid", is_valid, report);
+
+	size_t *value = bptrees_get(&tree, &(size_t){500});
+	errors_expect("get(500) == 1000", value && *value == 1000, report);
+
+	is_valid = true;
+	for (size_t i = 0; i < 1000; i += 2) {
+		size_t removed = 0;
+		is_valid = is_valid && !bptrees_remove(&tree, &i, &removed, null);
+		is_valid = is_valid && removed == i * 2;
+	}
+
+	is_valid = is_valid && !bptrees_check(&tree) && tree.size == 500;
+	errors_expect("remove(evens) is valid", is_valid, report);
+
+	error remove_error = bptrees_remove(&tree, &(size_t){500}, null, null);
+	errors_expect("remove(500) == fail", remove_error, report);
+	errors_expect("get(500) == null", !bptrees_get(&tree, &(size_t){500}), report);
+
+	bptrees_free(&tree, null, null, null);
+}
+
+void nodes_test_bptrees_load_and_range(error_report *report) {
+	size_t keys[300] = {0};
+	for (size_t i = 0; i < 300; i++) {
+		keys[i] = i * 10;
+	}
+
+	bptree tree = bptrees_init(sizeof(size_t), sizeof(size_t), (orderfunc)_size_order);
+	error load_error = bptrees_load(&tree, keys, keys, 300, null);
+
+	bool is_valid = !load_error && !bptrees_check(&tree) && tree.size == 300;
+	errors_expect("load(0..3000 by 10) is valid", is_valid, report);
+
+	size_t low = 95;
+	size_t high = 150;
+	bptree_iterator it = {0};
+	bptrees_range(&tree, &low, &high, &it);
+
+	size_t expected = 100;
+	is_valid = true;
+	while (bptrees_next(&tree, &it)) {
+		is_valid = is_valid && *(size_t *)it.key == expected;
+		expected += 10;
+	}
+
+	is_valid = is_valid && expected == 150;
+	errors_expect("range(95, 150) == [100, 140]", is_valid, report);
+
+	bptrees_upper_bound(&tree, &(size_t){2990}, &it);
+	errors_expect("upper_bound(2990) is the end", !bptrees_next(&tree, &it), report);
+
+	bptrees_free(&tree, null, null, null);
+}
+
+typedef struct _shard_map_worker {
+	shard_map *map;
+	size_t start;
+	bool is_valid;
+} _shard_map_worker;
+
+void *_shard_maps_work(void *param) {
+	_shard_map_worker *worker = param;
+
+	for (size_t i = worker->start; i < worker->start + 2000; i++) {
+		size_t value = i * 3;
+		if (shard_maps_insert(worker->map, i, &value, null)) {
+			worker->is_valid = false;
+		}
+
+		size_t other = i / 2;
+		size_t found = 0;
+		if (shard_maps_get(worker->map, other, &found) && found != other * 3) {
+			worker->is_valid = false;
+		}
+
+		if (i % 4 == 0 && shard_maps_remove(worker->map, i, null)) {
+			worker->is_valid = false;
+		}
+	}
+
+	return null;
+}
+
+void nodes_test_shard_maps_threads(error_report *report) {
+	shard_map map = {0};
+	error init_error = shard_maps_init(&map, sizeof(size_t), 4, null);
+	errors_expect("init() == ok", !init_error, report);
+	if (init_error) { return; }
+
+	pthread_t threads[4] = {0};
+	_shard_map_worker workers[4] = {0};
+	for (size_t i = 0; i < 4; i++) {
+		workers[i] = (_shard_map_worker){.map=&map, .start=i * 2000, .is_valid=true};
+		pthread_create(&threads[i], null, _shard_maps_work, &workers[i]);
+	}
+
+	bool is_valid = true;
+	for (size_t i = 0; i < 4; i++) {
+		pthread_join(threads[i], null);
+		is_valid = is_valid && workers[i].is_valid;
+	}
+
+	errors_expect("insert/get/remove from 4 threads", is_valid, report);
+	errors_expect("size() == 6000", shard_maps_size(&map) == 6000, report);
+
+	size_t value = 0;
+	errors_expect("get(4) == false", !shard_maps_get(&map, 4, &value), report);
+	errors_expect("insert(5) == fail", shard_maps_insert(&map, 5, &value, null), report);
+
+	size_t old = 0;
+	value = 7;
+	error upsert_error = shard_maps_upsert(&map, 5, &value, &old, null);
+	errors_expect("upsert(5) replaces 15", !upsert_error && old == 15, report);
+
+	shard_map_snapshot snapshot = {0};
+	error snapshot_error = shard_maps_snapshot(&map, &snapshot, null);
+
+	size_t count = 0;
+	shard_map_iterator it = {0};
+	while (!snapshot_error && shard_map_snapshots_next(&snapshot, &it)) {
+		size_t expected = it.hash == 5 ? 7 : it.hash * 3;
+		is_valid = is_valid && it.hash % 4 != 0 && *(size_t *)it.value == expected;
+		count++;
+	}
+
+	errors_expect("snapshot() holds the 6000 entries", is_valid && count == 6000, report);
+
+	shard_map_snapshots_free(&snapshot, null);
+	shard_maps_free(&map, null);
+}
+
+void nodes_test_shard_maps_churn(error_report *report) {
+	shard_map map = {0};
+	error init_error = shard_maps_init(&map, sizeof(size_t), 1, null);
+	errors_expect("init() == ok", !init_error, report);
+	if (init_error) { return; }
+
+	bool is_aligned = (size_t)map.shards % node_line_size == 0;
+	errors_expect("shards are aligned to a line", is_aligned, report);
+
+	bool is_valid = true;
+	for (size_t i = 0; i < 10; i++) {
+		is_valid = is_valid && !shard_maps_insert(&map, i, &i, null);
+	}
+
+	/* the first tombstones may still grow it to half full */
+	for (size_t i = 10; i < 100; i++) {
+		is_valid = is_valid && !shard_maps_insert(&map, i, &i, null);
+		is_valid = is_valid && !shard_maps_remove(&map, i, null);
+	}
+
+	size_t tables = 0;
+	for (shard_map_table *t = map.shards[0].table; t; t = t->next) {
+		tables++;
+	}
+
+	for (size_t i = 100; i < 100000; i++) {
+		is_valid = is_valid && !shard_maps_insert(&map, i, &i, null);
+		is_valid = is_valid && !shard_maps_remove(&map, i, null);
+	}
+
+	for (shard_map_table *t = map.shards[0].table; t; t = t->next) {
+		tables--;
+	}
+
+	size_t value = 0;
+	is_valid = is_valid && shard_maps_get(&map, 9, &value) && value == 9;
+
+	errors_expect("insert/remove churn keeps entries", is_valid, report);
+	errors_expect("churn doesn't make tables", tables == 0, report);
+
+	shard_maps_free(&map, null);
+}
+
+void *_rings_produce(void *param) {
+	ring *queue = param;
+
+	for (size_t i = 1; i <= 10000; i++) {
+		rings_push(queue, &i);
+	}
+
+	return null;
+}
+
+void *_rings_consume(void *param) {
+	ring *queue = param;
+
+	size_t sum = 0;
+	for (size_t i = 0; i < 10000; i++) {
+		size_t item = 0;
+		rings_pop(queue, &item);
+		sum += item;
+	}
+
+	return (void *)sum;
+}
+
+void nodes_test_rings_threads(error_report *report) {
+	ring queue = {0};
+	error init_error = rings_init(&queue, sizeof(size_t), 64, null);
+	errors_expect("init() == ok", !init_error, report);
+	if (init_error) { return; }
+
+	size_t items[100] = {0};
+	size_t pushed = rings_push_batch(&queue, items, 100);
+	errors_expect("push_batch(100) into 64 == 64", pushed == 64, report);
+	errors_expect("try_push() == fail", rings_try_push(&queue, items), report);
+
+	size_t popped = rings_pop_batch(&queue, items, 100);
+	errors_expect("pop_batch(100) == 64", popped == 64, report);
+	errors_expect("try_pop() == fail", rings_try_pop(&queue, items), report);
+
+	pthread_t producers[4] = {0};
+	pthread_t consumers[4] = {0};
+	for (size_t i = 0; i < 4; i++) {
+		pthread_create(&producers[i], null, _rings_produce, &queue);
+		pthread_create(&consumers[i], null, _rings_consume, &queue);
+	}
+
+	size_t sum = 0;
+	for (size_t i = 0; i < 4; i++) {
+		void *result = null;
+		pthread_join(producers[i], null);
+		pthread_join(consumers[i], &result);
+		sum += (size_t)result;
+	}
+
+	errors_expect("4 producers and 4 consumers", sum == 4 * 10000 * 10001 / 2, report);
+	errors_expect("size() == 0", rings_size(&queue) == 0, report);
+
+	rings_free(&queue, null);
+}
+
+void *_spsc_rings_produce(void *param) {
+	spsc_ring *queue = param;
+
+	size_t batch[7] = {0};
+	for (size_t i = 0; i < 10003; i += 7) {
+		for (size_t j = 0; j < 7; j++) {
+			batch[j] = i + j;
+		}
+
+		size_t pushed = 0;
+		while (pushed < 7) {
+			pushed += spsc_rings_push_batch(queue, batch + pushed, 7 - pushed);
+		}
+	}
+
+	return null;
+}
+
+void nodes_test_spsc_rings_order(error_report *report) {
+	spsc_ring queue = {0};
+	error init_error = spsc_rings_init(&queue, sizeof(size_t), 32, null);
+	errors_expect("init() == ok", !init_error, report);
+	if (init_error) { return; }
+
+	pthread_t producer = {0};
+	pthread_create(&producer, null, _spsc_rings_produce, &queue);
+
+	bool is_valid = true;
+	size_t expected = 0;
+	while (expected < 10003) {
+		size_t batch[5] = {0};
+		size_t popped = spsc_rings_pop_batch(&queue, batch, 5);
+
+		for (size_t i = 0; i < popped; i++) {
+			is_valid = is_valid && batch[i] == expected;
+			expected++;
+		}
+	}
+
+	pthread_join(producer, null);
+
+	errors_expect("pop_batch() yields items in order", is_valid, report);
+	errors_expect("try_pop() == fail", spsc_rings_try_pop(&queue, &expected), report);
+
+	spsc_rings_free(&queue, null);
+}
+
+void nodes_test(void) {
+	printf("=====\n");
+	printf("nodes\n");
+	printf("=====\n\n");
+
+	reportfunc functions[] = {
+		nodes_test_maps_remove,
+		nodes_test_mutrees_compact,
+		nodes_test_mutrees_compact_small,
+		nodes_test_bptrees_push_and_remove,
+		nodes_test_bptrees_load_and_range,
+		nodes_test_shard_maps_threads,
+		nodes_test_shard_maps_churn,
+		nodes_test_rings_threads,
+		nodes_test_spsc_rings_order,
+		null,
+	};
+
+	size_t i = 0;
+	error_report report = {0};
+	while (functions[i]) {
+		functions[i](&report);
+		i++;
+		printf("\n");
+	}
+
+	error_reports_print(&report);
+}
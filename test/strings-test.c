@@ -441,6 +441,248 @@ void string_maps_get_and_push_test(error_report *report) {
 	string_maps_free(&json, null);
 }
 
+void string_splitters_next_test(error_report *report) {
+	const string text = strings_premake("a,,b,c");
+	const string sep = strings_premake(",");
+	string_view piece = {0};
+
+	string_splitter splitter = string_splitters_init(
+		&text, sep, (string_split_option){0});
+
+	size_t count = 0;
+	while (string_splitters_next(&splitter, &piece)) { count++; }
+	errors_expect("split('a,,b,c', ',').count == 4", count == 4, report);
+
+	splitter = string_splitters_init(
+		&text, sep, (string_split_option){.skip_empty=true});
+
+	string_splitters_next(&splitter, &piece);
+	string_splitters_next(&splitter, &piece);
+	bool is_valid = piece.size == 2 && piece.data == text.data + 3;
+	errors_expect("split('a,,b,c', ',', skip_empty)[1] == 'b'", is_valid, report);
+
+	splitter = string_splitters_init(
+		&text, sep, (string_split_option){.limit=1});
+
+	string_splitters_next(&splitter, &piece);
+	string_splitters_next(&splitter, &piece);
+	is_valid = 
+		piece.size == 5 && 
+		strncmp(piece.data, ",b,c", 4) == 0 && 
+		!string_splitters_next(&splitter, &piece);
+
+	errors_expect("split('a,,b,c', ',', 1)[1] == ',b,c'", is_valid, report);
+
+	string_view_vec views = {0};
+	error init_error = vectors_init(&views, sizeof(string_view), vector_min, null);
+	errors_expect("vectors_init(views) == ok", !init_error, report);
+
+	error split_error = strings_split_views(
+		&text, strings_do(",,"), (string_split_option){0}, &views, null);
+
+	is_valid = 
+		!split_error && 
+		views.size == 2 && 
+		views.data[1].data == text.data + 3 &&
+		views.data[1].size == 4;
+
+	errors_expect("split_views('a,,b,c', ',,') == ['a', 'b,c']", is_valid, report);
+	vectors_free(&views, null, null);
+}
+
+void string_matchers_replace_test(error_report *report) {
+	const string patterns[] = {
+		strings_premake("&"), 
+		strings_premake("<"), 
+		strings_premake(">"), 
+		strings_premake("{{name}}"),
+		strings_premake("he"),
+		strings_premake("hers"),
+	};
+
+	const string replaces[] = {
+		strings_premake("&amp;"), 
+		strings_premake("&lt;"), 
+		strings_premake("&gt;"), 
+		strings_premake("angelus"),
+		strings_premake("HE"),
+		strings_premake("HERS"),
+	};
+
+	string_matcher matcher = {0};
+	error init_error = string_matchers_init(&matcher, patterns, replaces, 6, null);
+	errors_expect("init(...) == ok", !init_error, report);
+
+	const string text = strings_premake("<b>{{name}} & {{nam}}</b> ushers");
+	string_builder builder = {0};
+	error replace_error = string_matchers_replace(&matcher, &text, &builder, null);
+
+	string replaced = string_builders_take(&builder, null);
+	const string predict = strings_premake(
+		"&lt;b&gt;angelus &amp; {{nam}}&lt;/b&gt; usHErs");
+
+	bool is_valid = !replace_error && strings_equals(&replaced, &predict);
+	errors_expect("replace('<b>{{name}} & ...') == '&lt;b&gt;angelus &amp; ...'", is_valid, report);
+	strings_free(&replaced, null);
+
+	string_match_vec matches = {0};
+	error vec_error = vectors_init(&matches, sizeof(string_match), vector_min, null);
+	error find_error = string_matchers_find(&matcher, &text, &matches, null);
+
+	is_valid = 
+		!vec_error && !find_error && 
+		matches.size == 7 && 
+		matches.data[2].position == 3 && 
+		matches.data[2].pattern == 3 && 
+		matches.data[2].size == 8;
+
+	errors_expect("find('<b>{{name}} & ...').size == 7", is_valid, report);
+
+	vectors_free(&matches, null, null);
+	string_matchers_free(&matcher, null);
+}
+
+void string_builders_push_and_take_test(error_report *report) {
+	string_builder builder = {0};
+
+	string_builders_push_with(&builder, "id=", null);
+	string_builders_push_integer(&builder, -42, null);
+	string_builders_push_char(&builder, ';', null);
+	string_builders_push_float(&builder, 1.5, 2, null);
+	string_builders_format(&builder, ";%s=%zu", null, "n", (size_t)7);
+
+	string text = string_builders_take(&builder, null);
+	bool is_valid = text.data && strings_equals(&text, &strings_do("id=-42;1.50;n=7"));
+	errors_expect("take(...) == 'id=-42;1.50;n=7'", is_valid, report);
+	errors_expect("take(...) zeroes builder", builder.data == null, report);
+	strings_free(&text, null);
+
+	const string word = strings_premake("abcdefghij");
+	for (size_t i = 0; i < 1000; i++) {
+		string_builders_push(&builder, &word, null);
+	}
+
+	is_valid = builder.size == 10000 && builder.capacity >= 10001;
+	errors_expect("push('abcdefghij') x 1000 .size == 10000", is_valid, report);
+
+	string_builders_clear(&builder);
+	string_builders_push_integer(&builder, 0, null);
+	text = string_builders_take(&builder, null);
+	is_valid = text.data && strings_equals(&text, &strings_do("0"));
+	errors_expect("clear() then push_integer(0) == '0'", is_valid, report);
+	strings_free(&text, null);
+}
+
+void string_interns_push_and_get_test(error_report *report) {
+	string_intern interns = {0};
+	error init_error = string_interns_init(&interns, (string_intern_option){0}, null);
+	errors_expect("init() == ok", !init_error, report);
+
+	string text = strings_premake("host: a, Host: a, host: b");
+	string_view host0 = strings_view(&text, 0, 4);
+	string_view host1 = strings_view(&text, 18, 22);
+	string_view upper = strings_view(&text, 9, 13);
+
+	string_id id0 = string_interns_push(&interns, &host0, null);
+	string_id id1 = string_interns_push(&interns, &host1, null);
+	string_id id2 = string_interns_push(&interns, &upper, null);
+
+	errors_expect("push('host') != 0", id0 != 0, report);
+	errors_expect("push('host') == push('host')", id0 == id1, report);
+	errors_expect("push('Host') != push('host')", id0 != id2, report);
+
+	const string *canon = string_interns_get(&interns, id0);
+	bool is_valid = canon && strings_equals(canon, &strings_do("host"));
+	errors_expect("get(push('host')) == 'host'", is_valid, report);
+
+	string_view absent = strings_view(&text, 20, 24);
+	string_id none = string_interns_find(&interns, &absent);
+	errors_expect("find('st: ') == 0", none == 0, report);
+
+	for (size_t i = 0; i < 1000; i++) {
+		string number = strings_format("%zu", null, i);
+		string_id id = string_interns_push(&interns, &number, null);
+		string_id found = string_interns_find(&interns, &number);
+
+		is_valid = id != 0 && id == found;
+		strings_free(&number, null);
+
+		if (!is_valid) { break; }
+	}
+
+	errors_expect("push(0..1000) == find(0..1000)", is_valid, report);
+	errors_expect("get(push('host')) survives growth", 
+		string_interns_get(&interns, id0) == canon, report);
+
+	string_interns_free(&interns, null);
+}
+
+void texts_kernels_test(error_report *report) {
+	char text[80] = {0};
+	char lower[80] = {0};
+	char upper[80] = {0};
+
+	const char pattern[] = "aZ @[`{\t\n~9";
+	for (size_t i = 0; i < sizeof(text); i++) {
+		text[i] = pattern[i % (sizeof(pattern) - 1)];
+	}
+
+	bool is_valid = true;
+	text_level best = texts_level();
+
+	for (text_level level = text_scalar_level; level <= best; level++) {
+		texts_use(level);
+
+		for (size_t size = 0; size <= sizeof(text); size++) {
+			texts_lower_to(lower, text, size);
+			texts_upper_to(upper, text, size);
+
+			for (size_t i = 0; i < size; i++) {
+				is_valid = is_valid && 
+					lower[i] == tolower(text[i]) && 
+					upper[i] == toupper(text[i]);
+			}
+
+			is_valid = is_valid && 
+				texts_equals_case(lower, upper, size) &&
+				texts_is_ascii(text, size) && 
+				texts_is_printable(text, size) &&
+				texts_is_utf8(text, size);
+
+			if (size > 0) {
+				upper[size - 1] ^= 0x40;
+				is_valid = is_valid && !texts_equals_case(lower, upper, size);
+			}
+		}
+	}
+
+	errors_expect("kernels(level) == scalar(level)", is_valid, report);
+
+	const string spaced = strings_premake("\t\r\n  a b   c  \n\t  \r\n");
+	errors_expect("trim_start(' a b c ') == 5", 
+		texts_trim_start(spaced.data, spaced.size - 1) == 5, report);
+	errors_expect("trim_end(' a b c ') == 12", 
+		texts_trim_end(spaced.data, spaced.size - 1) == 12, report);
+
+	const char *utf8s[] = {"ação", "\xe2\x82\xac", "\xf0\x9f\x98\x80"};
+	const char *not_utf8s[] = {
+		"\xc0\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe2\x82", "a\x80"};
+
+	is_valid = true;
+	for (size_t i = 0; i < sizeof(utf8s) / sizeof(*utf8s); i++) {
+		is_valid = is_valid && texts_is_utf8(utf8s[i], strlen(utf8s[i]));
+	}
+
+	for (size_t i = 0; i < sizeof(not_utf8s) / sizeof(*not_utf8s); i++) {
+		is_valid = is_valid && !texts_is_utf8(not_utf8s[i], strlen(not_utf8s[i]));
+	}
+
+	errors_expect("is_utf8 rejects overlongs, surrogates and truncations", is_valid, report);
+	errors_expect("is_ascii('ação') == false", !texts_is_ascii("ação", 5), report);
+
+	texts_use(best);
+}
+
 void reportfuncs_do(reportfunc *functions, error_report *report) {
 	size_t i = 0;
 	while (functions[i]) {
@@ -481,6 +723,11 @@ void strings_test(void) {
 		strings_cut_test,
 		string_vecs_join_test,
 		string_maps_get_and_push_test,
+		string_splitters_next_test,
+		string_builders_push_and_take_test,
+		string_matchers_replace_test,
+		string_interns_push_and_get_test,
+		texts_kernels_test,
 		null,
 	};
 
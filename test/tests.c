@@ -1,6 +1,7 @@
 #include "strings-test.c"
 #include "vectors-test.c"
 #include "mems-test.c"
+#include "nodes-test.c"
 
 #include "../source/nodes.c"
 #include "../source/utils.c"
@@ -8,12 +9,14 @@
 #include "../source/errors.c"
 #include "../source/vectors.c"
 #include "../source/strings.c"
+#include "../source/texts.c"
 #include "../source/maths.c"
 
 int main() {
 	strings_test();
 	vectors_test();
 	mems_test();
+	nodes_test();
 
 	return 0;
 }
@@ -52,6 +52,49 @@ void vectors_test_find(error_report *report) {
 	errors_expect("find([4, 3, 1, 9], 1, 8) == 2", pos == 2, report);
 }
 
+void vectors_test_small_and_extend(error_report *report) {
+	small_vectors(size_t, 4) v0 = {0};
+	small_vectors_init(v0);
+
+	for (size_t i = 0; i < 4; i++) {
+		vectors_push(&v0, &i, null);
+	}
+
+	bool is_inline = v0.is_inline && v0.data == v0.inline_data;
+	errors_expect("push(4 items) stays inline", is_inline, report);
+
+	size_t items[] = {4, 5, 6, 7, 8, 9};
+	error extend_error = vectors_extend(&v0, items, 6, null);
+
+	bool is_valid = !extend_error && !v0.is_inline && v0.size == 10;
+	for (size_t i = 0; i < v0.size; i++) {
+		is_valid = is_valid && v0.data[i] == i;
+	}
+
+	errors_expect("extend(6 items) spills once, in order", is_valid, report);
+
+	vectors_free(&v0, null, null);
+}
+
+void vectors_test_growth(error_report *report) {
+	size_vec v0 = {0};
+	error init_error = vectors_init(&v0, sizeof(size_t), vector_min, null);
+	v0.growth = vector_exact_growth;
+
+	size_t items[20] = {0};
+	error extend_error = init_error || vectors_extend(&v0, items, 20, null);
+	errors_expect("extend(20) exactly == 21", !extend_error && v0.capacity == 21, report);
+
+	v0.growth = vector_half_growth;
+	vectors_push(&v0, items, null);
+	errors_expect("push() by half == 31", v0.capacity == 31, report);
+
+	error reserve_error = vectors_reserve(&v0, 100, null);
+	errors_expect("reserve(100) == 100", !reserve_error && v0.capacity == 100, report);
+
+	vectors_free(&v0, null, null);
+}
+
 void vectors_test(void) {
 	printf("=======\n");
 	printf("vectors\n");
@@ -63,6 +106,8 @@ void vectors_test(void) {
 		vectors_test_premake_and_sort,
 		vectors_test_equals,
 		vectors_test_find,
+		vectors_test_small_and_extend,
+		vectors_test_growth,
 		null,
 	};
 